@@ -0,0 +1,579 @@
+/**
+ * Copyright (c) 2016 - 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_BLOCK_DEV_CACHE)
+#include "nrf_block_dev_cache.h"
+#include <inttypes.h>
+
+/**@file
+ *
+ * @ingroup nrf_block_dev
+ * @{
+ *
+ * @brief This module implements block device API on top of another block device.
+ */
+
+#if NRF_BLOCK_DEV_CACHE_CONFIG_LOG_ENABLED
+#define NRF_LOG_LEVEL       NRF_BLOCK_DEV_CACHE_CONFIG_LOG_LEVEL
+#define NRF_LOG_INFO_COLOR  NRF_BLOCK_DEV_CACHE_CONFIG_INFO_COLOR
+#define NRF_LOG_INST_DEBUG_COLOR NRF_BLOCK_DEV_CACHE_CONFIG_DEBUG_COLOR
+#else
+#define NRF_LOG_LEVEL       0
+#endif
+#include "nrf_log.h"
+
+/**
+ * @brief Mask of the first blocks of a line.
+ *
+ * @param blk_count Number of blocks, up to @ref NRF_BLOCK_DEV_CACHE_LINE_BLOCKS_MAX
+ * */
+static uint32_t cache_blk_mask(uint32_t blk_count)
+{
+    return (blk_count >= 32) ? UINT32_MAX : ((1u << blk_count) - 1);
+}
+
+static uint8_t * cache_line_data(nrf_block_dev_cache_t const * p_cache_dev,
+                                 nrf_block_dev_cache_line_t const * p_line)
+{
+    nrf_block_dev_cache_config_t const * p_config = &p_cache_dev->cache_config;
+
+    return p_config->p_buffer + (size_t)(p_line - p_config->p_lines) * p_config->line_size;
+}
+
+/**
+ * @brief Mask of the line blocks that are inside the device, the last line may be cut.
+ * */
+static uint32_t cache_line_blk_mask(nrf_block_dev_cache_t const * p_cache_dev,
+                                    nrf_block_dev_cache_line_t const * p_line)
+{
+    nrf_block_dev_cache_work_t const * p_work = p_cache_dev->p_work;
+
+    return cache_blk_mask(MIN(p_work->line_blocks, p_work->geometry.blk_count - p_line->blk_id));
+}
+
+static nrf_block_dev_cache_line_t * cache_line_find(nrf_block_dev_cache_t const * p_cache_dev,
+                                                    uint32_t blk_id)
+{
+    nrf_block_dev_cache_config_t const * p_config = &p_cache_dev->cache_config;
+
+    for (uint32_t i = 0; i < p_config->line_count; i++)
+    {
+        nrf_block_dev_cache_line_t * p_line = &p_config->p_lines[i];
+        if ((p_line->valid != 0) && (p_line->blk_id == blk_id))
+        {
+            return p_line;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Reads the line blocks of the mask that are not cached yet, one request per run of
+ *        consecutive blocks.
+ * */
+static ret_code_t cache_line_fill(nrf_block_dev_cache_t const * p_cache_dev,
+                                  nrf_block_dev_cache_line_t * p_line,
+                                  uint32_t mask)
+{
+    nrf_block_dev_cache_work_t const * p_work = p_cache_dev->p_work;
+    uint32_t missing = mask & ~p_line->valid & cache_line_blk_mask(p_cache_dev, p_line);
+    uint8_t * p_data = cache_line_data(p_cache_dev, p_line);
+
+    while (missing != 0)
+    {
+        uint32_t first = 0;
+        uint32_t count = 0;
+
+        while ((missing & (1u << first)) == 0)
+        {
+            first++;
+        }
+        while (((first + count) < 32) && (missing & (1u << (first + count))))
+        {
+            count++;
+        }
+
+        NRF_BLOCK_DEV_REQUEST(req,
+                              p_line->blk_id + first,
+                              count,
+                              p_data + first * p_work->geometry.blk_size);
+
+        ret_code_t ret = nrf_blk_dev_read_req(p_cache_dev->cache_config.p_backend, &req);
+        if (ret != NRF_SUCCESS)
+        {
+            NRF_LOG_INST_ERROR(p_cache_dev->p_log,
+                               "Read of block %"PRIu32" count %"PRIu32" failed: %"PRIu32,
+                               req.blk_id, req.blk_count, ret);
+            return ret;
+        }
+
+        uint32_t run = cache_blk_mask(count) << first;
+        p_line->valid |= run;
+        missing &= ~run;
+    }
+
+    return NRF_SUCCESS;
+}
+
+/**
+ * @brief Writes the dirty blocks of a line back with a single request.
+ *
+ * Clean blocks between the dirty ones are loaded first, so that they can be written too.
+ * */
+static ret_code_t cache_line_flush(nrf_block_dev_cache_t const * p_cache_dev,
+                                   nrf_block_dev_cache_line_t * p_line)
+{
+    nrf_block_dev_cache_work_t const * p_work = p_cache_dev->p_work;
+    uint32_t first = 0;
+    uint32_t last = 31;
+
+    if (p_line->dirty == 0)
+    {
+        return NRF_SUCCESS;
+    }
+
+    while ((p_line->dirty & (1u << first)) == 0)
+    {
+        first++;
+    }
+    while ((p_line->dirty & (1u << last)) == 0)
+    {
+        last--;
+    }
+
+    uint32_t count = last - first + 1;
+    ret_code_t ret = cache_line_fill(p_cache_dev, p_line, cache_blk_mask(count) << first);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    NRF_LOG_INST_DEBUG(p_cache_dev->p_log,
+                       "Write back block %"PRIu32" count %"PRIu32,
+                       p_line->blk_id + first, count);
+
+    NRF_BLOCK_DEV_REQUEST(req,
+                          p_line->blk_id + first,
+                          count,
+                          cache_line_data(p_cache_dev, p_line) + first * p_work->geometry.blk_size);
+
+    ret = nrf_blk_dev_write_req(p_cache_dev->cache_config.p_backend, &req);
+    if (ret != NRF_SUCCESS)
+    {
+        NRF_LOG_INST_ERROR(p_cache_dev->p_log,
+                           "Write of block %"PRIu32" count %"PRIu32" failed: %"PRIu32,
+                           req.blk_id, req.blk_count, ret);
+        return ret;
+    }
+
+    p_line->dirty = 0;
+    return NRF_SUCCESS;
+}
+
+static ret_code_t cache_flush(nrf_block_dev_cache_t const * p_cache_dev)
+{
+    nrf_block_dev_cache_config_t const * p_config = &p_cache_dev->cache_config;
+
+    for (uint32_t i = 0; i < p_config->line_count; i++)
+    {
+        ret_code_t ret = cache_line_flush(p_cache_dev, &p_config->p_lines[i]);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    return NRF_SUCCESS;
+}
+
+/**
+ * @brief Returns the cache line of a block, replacing the least recently used line on a miss.
+ *
+ * @param[in]  p_cache_dev Caching block device
+ * @param[in]  blk_id      First block of the line
+ * @param[out] pp_line     Cache line
+ * */
+static ret_code_t cache_line_get(nrf_block_dev_cache_t const * p_cache_dev,
+                                 uint32_t blk_id,
+                                 nrf_block_dev_cache_line_t * * pp_line)
+{
+    nrf_block_dev_cache_config_t const * p_config = &p_cache_dev->cache_config;
+    nrf_block_dev_cache_work_t * p_work = p_cache_dev->p_work;
+    nrf_block_dev_cache_line_t * p_line = cache_line_find(p_cache_dev, blk_id);
+
+    if (p_line == NULL)
+    {
+        p_line = &p_config->p_lines[0];
+        for (uint32_t i = 0; i < p_config->line_count; i++)
+        {
+            nrf_block_dev_cache_line_t * p_cand = &p_config->p_lines[i];
+            if (p_cand->valid == 0)
+            {
+                p_line = p_cand;
+                break;
+            }
+
+            /* Ages are compared, the access stamp may wrap around */
+            if ((p_work->use_stamp - p_cand->last_use) > (p_work->use_stamp - p_line->last_use))
+            {
+                p_line = p_cand;
+            }
+        }
+
+        ret_code_t ret = cache_line_flush(p_cache_dev, p_line);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+
+        p_line->blk_id = blk_id;
+        p_line->valid = 0;
+    }
+
+    p_line->last_use = ++p_work->use_stamp;
+    *pp_line = p_line;
+    return NRF_SUCCESS;
+}
+
+/**
+ * @brief Loads the lines following a sequential read.
+ *
+ * @param[in] p_cache_dev Caching block device
+ * @param[in] blk_id      Last block read
+ * */
+static void cache_read_ahead(nrf_block_dev_cache_t const * p_cache_dev, uint32_t blk_id)
+{
+    nrf_block_dev_cache_config_t const * p_config = &p_cache_dev->cache_config;
+    nrf_block_dev_cache_work_t const * p_work = p_cache_dev->p_work;
+    uint32_t line_blk_id = blk_id - (blk_id % p_work->line_blocks);
+
+    /* One line is kept for the block being read */
+    for (uint32_t i = 0; i < MIN(p_config->read_ahead, p_config->line_count - 1); i++)
+    {
+        nrf_block_dev_cache_line_t * p_line;
+
+        line_blk_id += p_work->line_blocks;
+        if (line_blk_id >= p_work->geometry.blk_count)
+        {
+            break;
+        }
+
+        if ((cache_line_get(p_cache_dev, line_blk_id, &p_line) != NRF_SUCCESS) ||
+            (cache_line_fill(p_cache_dev, p_line, UINT32_MAX) != NRF_SUCCESS))
+        {
+            break;
+        }
+    }
+}
+
+static void block_dev_cache_event(nrf_block_dev_t const * p_blk_dev,
+                                  nrf_block_dev_event_type_t event,
+                                  nrf_block_req_t const * p_blk)
+{
+    nrf_block_dev_cache_t const * p_cache_dev =
+        CONTAINER_OF(p_blk_dev, nrf_block_dev_cache_t, block_dev);
+    nrf_block_dev_cache_work_t const * p_work = p_cache_dev->p_work;
+
+    if (p_work->ev_handler)
+    {
+        /*Asynchronous operation (simulation)*/
+        const nrf_block_dev_event_t ev = {
+                event,
+                NRF_BLOCK_DEV_RESULT_SUCCESS,
+                p_blk,
+                p_work->p_context
+        };
+
+        p_work->ev_handler(p_blk_dev, &ev);
+    }
+}
+
+static ret_code_t block_dev_cache_init(nrf_block_dev_t const * p_blk_dev,
+                                       nrf_block_dev_ev_handler ev_handler,
+                                       void const * p_context)
+{
+    ASSERT(p_blk_dev);
+    nrf_block_dev_cache_t const * p_cache_dev =
+        CONTAINER_OF(p_blk_dev, nrf_block_dev_cache_t, block_dev);
+    nrf_block_dev_cache_config_t const * p_config = &p_cache_dev->cache_config;
+    nrf_block_dev_cache_work_t * p_work = p_cache_dev->p_work;
+
+    NRF_LOG_INST_DEBUG(p_cache_dev->p_log, "Init");
+
+    /* Without a handler, backend requests are expected to complete before returning */
+    ret_code_t ret = nrf_blk_dev_init(p_config->p_backend, NULL, NULL);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    nrf_block_dev_geometry_t const * p_geometry = nrf_blk_dev_geometry(p_config->p_backend);
+    uint32_t line_blocks = p_config->line_size / p_geometry->blk_size;
+
+    if (((p_config->line_size % p_geometry->blk_size) != 0) ||
+        (line_blocks == 0) ||
+        (line_blocks > NRF_BLOCK_DEV_CACHE_LINE_BLOCKS_MAX))
+    {
+        NRF_LOG_INST_ERROR(p_cache_dev->p_log,
+                           "Line size %"PRIu32" does not fit block size %"PRIu32,
+                           p_config->line_size, p_geometry->blk_size);
+        UNUSED_RETURN_VALUE(nrf_blk_dev_uninit(p_config->p_backend));
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_work->geometry = *p_geometry;
+    p_work->line_blocks = line_blocks;
+    p_work->use_stamp = 0;
+    p_work->seq_blk_id = UINT32_MAX;
+    p_work->p_context = p_context;
+    p_work->ev_handler = ev_handler;
+    memset(p_config->p_lines, 0, p_config->line_count * sizeof(nrf_block_dev_cache_line_t));
+
+    block_dev_cache_event(p_blk_dev, NRF_BLOCK_DEV_EVT_INIT, NULL);
+    return NRF_SUCCESS;
+}
+
+static ret_code_t block_dev_cache_uninit(nrf_block_dev_t const * p_blk_dev)
+{
+    ASSERT(p_blk_dev);
+    nrf_block_dev_cache_t const * p_cache_dev =
+        CONTAINER_OF(p_blk_dev, nrf_block_dev_cache_t, block_dev);
+    nrf_block_dev_cache_work_t * p_work = p_cache_dev->p_work;
+
+    NRF_LOG_INST_DEBUG(p_cache_dev->p_log, "Uninit");
+
+    /* Dirty blocks are kept when the write back fails, uninit can be retried */
+    ret_code_t ret = cache_flush(p_cache_dev);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    ret = nrf_blk_dev_uninit(p_cache_dev->cache_config.p_backend);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    block_dev_cache_event(p_blk_dev, NRF_BLOCK_DEV_EVT_UNINIT, NULL);
+
+    memset(p_work, 0, sizeof(nrf_block_dev_cache_work_t));
+    return NRF_SUCCESS;
+}
+
+static ret_code_t block_dev_cache_range_check(nrf_block_dev_cache_t const * p_cache_dev,
+                                              nrf_block_req_t const * p_blk)
+{
+    nrf_block_dev_cache_work_t const * p_work = p_cache_dev->p_work;
+
+    /* Written so that a large block ID or count can not wrap around */
+    if ((p_blk->blk_id > p_work->geometry.blk_count) ||
+        (p_blk->blk_count > (p_work->geometry.blk_count - p_blk->blk_id)))
+    {
+        NRF_LOG_INST_ERROR(p_cache_dev->p_log,
+            "Out of range req block %"PRIu32" count %"PRIu32" while max is %"PRIu32,
+            p_blk->blk_id,
+            p_blk->blk_count,
+            p_work->geometry.blk_count);
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    return NRF_SUCCESS;
+}
+
+static ret_code_t block_dev_cache_read_req(nrf_block_dev_t const * p_blk_dev,
+                                           nrf_block_req_t const * p_blk)
+{
+    ASSERT(p_blk_dev);
+    ASSERT(p_blk);
+    nrf_block_dev_cache_t const * p_cache_dev =
+        CONTAINER_OF(p_blk_dev, nrf_block_dev_cache_t, block_dev);
+    nrf_block_dev_cache_work_t * p_work = p_cache_dev->p_work;
+    uint32_t blk_size = p_work->geometry.blk_size;
+    uint8_t * p_buff = p_blk->p_buff;
+
+    NRF_LOG_INST_DEBUG(p_cache_dev->p_log,
+        "Read req from block %"PRIu32" size %"PRIu32"(x%"PRIu32") to %"PRIXPTR,
+        p_blk->blk_id,
+        p_blk->blk_count,
+        blk_size,
+        p_blk->p_buff);
+
+    ret_code_t ret = block_dev_cache_range_check(p_cache_dev, p_blk);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    for (uint32_t i = 0; i < p_blk->blk_count; i++)
+    {
+        nrf_block_dev_cache_line_t * p_line;
+        uint32_t blk_id = p_blk->blk_id + i;
+        uint32_t idx = blk_id % p_work->line_blocks;
+
+        ret = cache_line_get(p_cache_dev, blk_id - idx, &p_line);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+
+        if ((p_line->valid & (1u << idx)) == 0)
+        {
+            /* The whole line is loaded, the following blocks are likely to be read next */
+            ret = cache_line_fill(p_cache_dev, p_line, UINT32_MAX);
+            if (ret != NRF_SUCCESS)
+            {
+                return ret;
+            }
+        }
+
+        memcpy(p_buff, cache_line_data(p_cache_dev, p_line) + idx * blk_size, blk_size);
+        p_buff += blk_size;
+    }
+
+    if ((p_blk->blk_id == p_work->seq_blk_id) && (p_blk->blk_count != 0))
+    {
+        cache_read_ahead(p_cache_dev, p_blk->blk_id + p_blk->blk_count - 1);
+    }
+    p_work->seq_blk_id = p_blk->blk_id + p_blk->blk_count;
+
+    block_dev_cache_event(p_blk_dev, NRF_BLOCK_DEV_EVT_BLK_READ_DONE, p_blk);
+    return NRF_SUCCESS;
+}
+
+static ret_code_t block_dev_cache_write_req(nrf_block_dev_t const * p_blk_dev,
+                                            nrf_block_req_t const * p_blk)
+{
+    ASSERT(p_blk_dev);
+    ASSERT(p_blk);
+    nrf_block_dev_cache_t const * p_cache_dev =
+        CONTAINER_OF(p_blk_dev, nrf_block_dev_cache_t, block_dev);
+    nrf_block_dev_cache_work_t const * p_work = p_cache_dev->p_work;
+    uint32_t blk_size = p_work->geometry.blk_size;
+    uint8_t const * p_buff = p_blk->p_buff;
+
+    NRF_LOG_INST_DEBUG(p_cache_dev->p_log,
+        "Write req to block %"PRIu32" size %"PRIu32"(x%"PRIu32") from %"PRIXPTR,
+        p_blk->blk_id,
+        p_blk->blk_count,
+        blk_size,
+        p_blk->p_buff);
+
+    ret_code_t ret = block_dev_cache_range_check(p_cache_dev, p_blk);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    for (uint32_t i = 0; i < p_blk->blk_count; i++)
+    {
+        nrf_block_dev_cache_line_t * p_line;
+        uint32_t blk_id = p_blk->blk_id + i;
+        uint32_t idx = blk_id % p_work->line_blocks;
+
+        ret = cache_line_get(p_cache_dev, blk_id - idx, &p_line);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+
+        memcpy(cache_line_data(p_cache_dev, p_line) + idx * blk_size, p_buff, blk_size);
+        p_buff += blk_size;
+        p_line->valid |= 1u << idx;
+        p_line->dirty |= 1u << idx;
+
+        /* A completely written line is not likely to be written again soon */
+        if (p_line->dirty == cache_line_blk_mask(p_cache_dev, p_line))
+        {
+            ret = cache_line_flush(p_cache_dev, p_line);
+            if (ret != NRF_SUCCESS)
+            {
+                return ret;
+            }
+        }
+    }
+
+    block_dev_cache_event(p_blk_dev, NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE, p_blk);
+    return NRF_SUCCESS;
+}
+
+static ret_code_t block_dev_cache_ioctl(nrf_block_dev_t const * p_blk_dev,
+                                        nrf_block_dev_ioctl_req_t req,
+                                        void * p_data)
+{
+    nrf_block_dev_cache_t const * p_cache_dev =
+        CONTAINER_OF(p_blk_dev, nrf_block_dev_cache_t, block_dev);
+
+    if (req == NRF_BLOCK_DEV_IOCTL_REQ_CACHE_FLUSH)
+    {
+        NRF_LOG_INST_DEBUG(p_cache_dev->p_log, "IOCtl: Cache flush");
+        ret_code_t ret = cache_flush(p_cache_dev);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    /* The backend flushes its own cache and provides the info strings */
+    return nrf_blk_dev_ioctl(p_cache_dev->cache_config.p_backend, req, p_data);
+}
+
+static nrf_block_dev_geometry_t const * block_dev_cache_geometry(nrf_block_dev_t const * p_blk_dev)
+{
+    ASSERT(p_blk_dev);
+    nrf_block_dev_cache_t const * p_cache_dev =
+        CONTAINER_OF(p_blk_dev, nrf_block_dev_cache_t, block_dev);
+    nrf_block_dev_cache_work_t const * p_work = p_cache_dev->p_work;
+
+    return &p_work->geometry;
+}
+
+const nrf_block_dev_ops_t nrf_block_device_cache_ops = {
+        .init = block_dev_cache_init,
+        .uninit = block_dev_cache_uninit,
+        .read_req = block_dev_cache_read_req,
+        .write_req = block_dev_cache_write_req,
+        .ioctl = block_dev_cache_ioctl,
+        .geometry = block_dev_cache_geometry,
+};
+
+/** @} */
+#endif // NRF_MODULE_ENABLED(NRF_BLOCK_DEV_CACHE)
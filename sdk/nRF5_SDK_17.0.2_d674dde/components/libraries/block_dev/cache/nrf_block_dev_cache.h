@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2016 - 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef NRF_BLOCK_DEV_CACHE_H__
+#define NRF_BLOCK_DEV_CACHE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nrf_block_dev.h"
+#include "nrf_log_instance.h"
+
+/**@file
+ *
+ * @defgroup nrf_block_dev_cache Caching block device
+ * @ingroup nrf_block_dev
+ * @{
+ *
+ * @brief This module implements block device API on top of another block device.
+ *
+ * Blocks are cached in lines of consecutive blocks, aligned to the line size. A line is
+ * loaded from the backend with a single read request and lines are replaced in LRU order.
+ * When the blocks are read sequentially, the following lines are loaded ahead.
+ *
+ * Written blocks stay in the cache until their line is evicted, completely written or
+ * flushed with @ref NRF_BLOCK_DEV_IOCTL_REQ_CACHE_FLUSH. The dirty blocks of a line are then
+ * written back with a single write request, so with the line size set to the erase unit
+ * of a flash memory, appends turn into whole erase unit writes.
+ *
+ * The backend is initialized with a NULL event handler, and every backend request is
+ * assumed to be complete when its request function returns, as with the RAM block device.
+ * A backend that completes requests only later, from its event handler, can not be cached.
+ * Events of the caching block device are generated before the request functions return.
+ */
+
+/**
+ * @brief Caching block device operations
+ * */
+extern const nrf_block_dev_ops_t nrf_block_device_cache_ops;
+
+/**
+ * @brief Maximum number of blocks in a cache line
+ * */
+#define NRF_BLOCK_DEV_CACHE_LINE_BLOCKS_MAX (32)
+
+/**
+ * @brief Cache line descriptor
+ */
+typedef struct {
+    uint32_t blk_id;    //!< First block of the line
+    uint32_t valid;     //!< Mask of the line blocks holding data
+    uint32_t dirty;     //!< Mask of the line blocks not written to the backend yet
+    uint32_t last_use;  //!< Access stamp used for LRU replacement
+} nrf_block_dev_cache_line_t;
+
+/**
+ * @brief Work structure of caching block device
+ */
+typedef struct {
+    nrf_block_dev_geometry_t geometry;      //!< Block device geometry
+    nrf_block_dev_ev_handler ev_handler;    //!< Block device event handler
+    void const *             p_context;     //!< Context handle passed to event handler
+    uint32_t                 line_blocks;   //!< Number of blocks in a cache line
+    uint32_t                 use_stamp;     //!< Last access stamp
+    uint32_t                 seq_blk_id;    //!< Block following the last read request
+} nrf_block_dev_cache_work_t;
+
+/** @brief Name of the module used for logger messaging.
+ */
+#define NRF_BLOCK_DEV_CACHE_LOG_NAME block_dev_cache
+
+/**
+ * @brief Caching block device config
+ */
+typedef struct {
+    nrf_block_dev_t const *      p_backend;     //!< Cached block device
+    uint8_t *                    p_buffer;      //!< Cache data, line_count * line_size bytes
+    nrf_block_dev_cache_line_t * p_lines;       //!< Cache line descriptors
+    uint32_t                     line_size;     //!< Cache line size in bytes
+    uint32_t                     line_count;    //!< Number of cache lines
+    uint32_t                     read_ahead;    //!< Number of lines loaded ahead of sequential reads
+} nrf_block_dev_cache_config_t;
+
+/**
+ * @brief Caching block device
+ * */
+typedef struct {
+    nrf_block_dev_t              block_dev;     //!< Block device
+    nrf_block_dev_cache_config_t cache_config;  //!< Caching block device config
+    nrf_block_dev_cache_work_t * p_work;        //!< Caching block device work structure
+    NRF_LOG_INSTANCE_PTR_DECLARE(p_log)         //!< Pointer to instance of the logger object (Conditionally compiled).
+} nrf_block_dev_cache_t;
+
+/**
+ * @brief Defines a caching block device.
+ *
+ * The line size must be a multiple of the backend block size, up to
+ * @ref NRF_BLOCK_DEV_CACHE_LINE_BLOCKS_MAX blocks. Info strings are taken from the backend.
+ *
+ * @param name          Instance name
+ * @param backend       Cached block device handle
+ * @param line_sz       Cache line size in bytes, for example the flash erase unit size
+ * @param line_cnt      Number of cache lines
+ * @param ahead         Number of lines loaded ahead of sequential reads, 0 to disable
+ * */
+#define NRF_BLOCK_DEV_CACHE_DEFINE(name, backend, line_sz, line_cnt, ahead)                         \
+    static uint8_t CONCAT_2(name, _buff)[(line_cnt) * (line_sz)] __ALIGN(4);                        \
+    static nrf_block_dev_cache_line_t CONCAT_2(name, _lines)[line_cnt];                             \
+    static nrf_block_dev_cache_work_t CONCAT_2(name, _work);                                        \
+    NRF_LOG_INSTANCE_REGISTER(NRF_BLOCK_DEV_CACHE_LOG_NAME, name,                                   \
+                              NRF_BLOCK_DEV_CACHE_CONFIG_INFO_COLOR,                                \
+                              NRF_BLOCK_DEV_CACHE_CONFIG_DEBUG_COLOR,                               \
+                              NRF_BLOCK_DEV_CACHE_CONFIG_LOG_INIT_FILTER_LEVEL,                     \
+                              NRF_BLOCK_DEV_CACHE_CONFIG_LOG_ENABLED ?                              \
+                                   NRF_BLOCK_DEV_CACHE_CONFIG_LOG_LEVEL : NRF_LOG_SEVERITY_NONE);   \
+    static const nrf_block_dev_cache_t name = {                                                     \
+        .block_dev = { .p_ops = &nrf_block_device_cache_ops },                                      \
+        .cache_config = {                                                                           \
+            .p_backend = (backend),                                                                 \
+            .p_buffer = CONCAT_2(name, _buff),                                                      \
+            .p_lines = CONCAT_2(name, _lines),                                                      \
+            .line_size = (line_sz),                                                                 \
+            .line_count = (line_cnt),                                                               \
+            .read_ahead = (ahead),                                                                  \
+        },                                                                                          \
+        .p_work = &CONCAT_2(name, _work),                                                           \
+        NRF_LOG_INSTANCE_PTR_INIT(p_log, NRF_BLOCK_DEV_CACHE_LOG_NAME, name)                        \
+    }
+
+/**
+ * @brief Returns block device API handle from caching block device.
+ *
+ * @param[in] p_blk_cache Caching block device
+ * @return Block device handle
+ */
+static inline nrf_block_dev_t const *
+nrf_block_dev_cache_ops_get(nrf_block_dev_cache_t const * p_blk_cache)
+{
+    return &p_blk_cache->block_dev;
+}
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_BLOCK_DEV_CACHE_H__ */
@@ -56,6 +56,16 @@
 extern "C" {
 #endif
 
+/**@defgroup CRC16_ALGORITHMS CRC-16 implementations
+ *
+ * Selected with @c CRC16_CONFIG_ALGORITHM. All implementations produce the same result.
+ * @{
+ */
+#define CRC16_ALGORITHM_SHIFT   0   /**< One byte at a time using shifts. No lookup table. */
+#define CRC16_ALGORITHM_TABLE   1   /**< One byte at a time. 512 B lookup table. */
+#define CRC16_ALGORITHM_WORD    2   /**< Four bytes at a time. 2 kB lookup table. */
+/** @} */
+
 /**@brief Function for calculating CRC-16 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
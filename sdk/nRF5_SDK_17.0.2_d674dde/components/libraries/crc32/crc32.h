@@ -44,6 +44,9 @@
  * @ingroup hci_transport
  *
  * @brief    This module implements the CRC-32 calculation in the blocks.
+ *
+ * @details  The implementation is selected with @c CRC32_CONFIG_ALGORITHM, trading flash for speed.
+ *           All implementations produce the same result.
  */
 
 #ifndef CRC32_H__
@@ -55,6 +58,15 @@
 extern "C" {
 #endif
 
+/**@defgroup CRC32_ALGORITHMS CRC-32 implementations
+ * @{
+ */
+#define CRC32_ALGORITHM_BITWISE         0   /**< One bit at a time. No lookup table. */
+#define CRC32_ALGORITHM_TABLE           1   /**< One byte at a time. 1 kB lookup table. */
+#define CRC32_ALGORITHM_SLICING_BY_4    2   /**< Four bytes at a time. 4 kB lookup table. */
+#define CRC32_ALGORITHM_SLICING_BY_8    3   /**< Eight bytes at a time. 8 kB lookup table. */
+/** @} */
+
 /**@brief Function for calculating CRC-32 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
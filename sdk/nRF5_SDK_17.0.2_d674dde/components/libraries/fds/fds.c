@@ -62,9 +62,17 @@
 #include "crc16.h"
 #endif
 
+#if (FDS_GC_INCREMENTAL) && NRF_MODULE_ENABLED(APP_TIMER)
+#include "app_timer.h"
+#endif
+
 
 static void fs_event_handler(nrf_fstorage_evt_t * evt);
 
+#if (FDS_GC_INCREMENTAL) || (FDS_GC_DIRTY_THRESHOLD > 0)
+static ret_code_t gc_enqueue(bool dirty_only);
+#endif
+
 NRF_FSTORAGE_DEF(nrf_fstorage_t m_fs) =
 {
     // The flash area boundaries are set in fds_init().
@@ -99,6 +107,15 @@ static fds_swap_page_t      m_swap_page;
 // Garbage collection data.
 static fds_gc_data_t        m_gc;
 
+#if (FDS_INDEX_SIZE > 0)
+// RAM index of valid records. One is in use, the other one is used to rebuild it.
+static fds_index_t          m_index[2];
+static fds_index_t        * m_p_index = &m_index[0];
+// Incremented whenever records are added or removed, to detect changes while building.
+static uint32_t             m_index_changes;
+static bool                 m_index_building;
+#endif
+
 
 static void event_send(fds_evt_t const * const p_evt)
 {
@@ -154,6 +171,12 @@ static void event_prepare(fds_op_t const * const p_op, fds_evt_t * const p_evt)
             p_evt->id = FDS_EVT_GC;
             break;
 
+        case FDS_OP_WRITE_BATCH:
+            p_evt->id                    = FDS_EVT_WRITE_BATCH;
+            p_evt->batch.first_record_id = p_op->batch.first_id;
+            p_evt->batch.count           = p_op->batch.count;
+            break;
+
         default:
             // Should not happen.
             break;
@@ -176,6 +199,20 @@ static fds_header_t const * header_jump(fds_header_t const * const p_hdr)
 }
 
 
+// Jump over a batch marker. If the batch was not committed, jump over its records as well.
+static fds_header_t const * batch_jump(fds_header_t const * const p_hdr)
+{
+    uint32_t const * p_next = (uint32_t*)header_jump(p_hdr);
+
+    if (((uint32_t*)p_hdr)[FDS_OFFSET_DATA] == FDS_ERASED_WORD)
+    {
+        p_next += p_hdr->record_key;
+    }
+
+    return (fds_header_t*)p_next;
+}
+
+
 static fds_header_status_t header_check(fds_header_t const * p_hdr, uint32_t const * p_page_end)
 {
     if (((uint32_t*)header_jump(p_hdr) > p_page_end))
@@ -197,6 +234,16 @@ static fds_header_status_t header_check(fds_header_t const * p_hdr, uint32_t con
         return FDS_HEADER_DIRTY;
     }
 
+    if (p_hdr->file_id == FDS_FILE_ID_BATCH)
+    {
+        // The records of a batch that was not committed must not cross the page boundary either.
+        if (((uint32_t*)batch_jump(p_hdr) > p_page_end))
+        {
+            return FDS_HEADER_CORRUPT;
+        }
+        return FDS_HEADER_BATCH;
+    }
+
     return FDS_HEADER_VALID;
 }
 
@@ -314,7 +361,7 @@ static void page_scan(uint32_t const *       p_addr,
     {
         fds_header_status_t hdr = header_check(p_header, p_page_end);
 
-        if (hdr == FDS_HEADER_VALID)
+        if ((hdr == FDS_HEADER_VALID) || (hdr == FDS_HEADER_BATCH))
         {
             // Update the latest (largest) record ID.
             if (p_header->record_id > m_latest_rec_id)
@@ -322,8 +369,11 @@ static void page_scan(uint32_t const *       p_addr,
                 m_latest_rec_id = p_header->record_id;
             }
         }
-        else
+
+        if (hdr != FDS_HEADER_VALID)
         {
+            // Batch markers are not needed once the batch has been written,
+            // so they can be garbage collected as well.
             if (can_gc != NULL)
             {
                 *can_gc = true;
@@ -342,6 +392,15 @@ static void page_scan(uint32_t const *       p_addr,
             }
         }
 
+        if (hdr == FDS_HEADER_BATCH)
+        {
+            fds_header_t const * const p_next = batch_jump(p_header);
+
+            *words_written += (uint16_t)((uint32_t*)p_next - (uint32_t*)p_header);
+            p_header        = p_next;
+            continue;
+        }
+
         *words_written += (FDS_HEADER_SIZE + p_header->length_words);
         p_header        = header_jump(p_header);
     }
@@ -465,6 +524,11 @@ static bool record_find_next(uint16_t page, uint32_t const ** p_record)
                 p_header = header_jump(p_header);
                 break;
 
+            case FDS_HEADER_BATCH:
+                // Records of a batch that was not committed are never returned.
+                p_header = batch_jump(p_header);
+                break;
+
             case FDS_HEADER_CORRUPT:
                 // We can't reliably jump over this record.
                 // There is nothing more we can do on this page.
@@ -477,6 +541,344 @@ static bool record_find_next(uint16_t page, uint32_t const ** p_record)
 }
 
 
+#if (FDS_INDEX_SIZE > 0)
+
+static uint16_t index_hash(uint16_t file_id, uint16_t record_key)
+{
+    uint32_t const hash = (((uint32_t)file_id << 16) | record_key) * 2654435761UL;
+    return (uint16_t)((hash >> 16) & (FDS_INDEX_SIZE - 1));
+}
+
+
+static uint16_t index_next(uint16_t i)
+{
+    return (uint16_t)((i + 1) & (FDS_INDEX_SIZE - 1));
+}
+
+
+// Discard the index. It will be rebuilt the next time it is needed.
+static void index_invalidate(void)
+{
+    CRITICAL_SECTION_ENTER();
+    m_p_index->state = FDS_INDEX_STALE;
+    m_index_changes++;
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Insert a record into an index.
+// NOTE: Must be called from within a critical section if the index is in use.
+static void index_insert(fds_index_t * const p_index, fds_header_t const * const p_header)
+{
+    if (p_index->count < FDS_INDEX_MAX_RECORDS)
+    {
+        uint16_t i = index_hash(p_header->file_id, p_header->record_key);
+
+        while (p_index->entries[i].p_record != NULL)
+        {
+            i = index_next(i);
+        }
+
+        p_index->entries[i].p_record   = (uint32_t const *)p_header;
+        p_index->entries[i].file_id    = p_header->file_id;
+        p_index->entries[i].record_key = p_header->record_key;
+        p_index->count++;
+    }
+    else
+    {
+        // Too many records, searches will scan flash.
+        p_index->state = FDS_INDEX_OVERFLOW;
+    }
+}
+
+
+// Add a valid record to the index.
+static void index_add(fds_header_t const * const p_header)
+{
+    CRITICAL_SECTION_ENTER();
+    if ((m_p_index->state == FDS_INDEX_VALID) || (m_p_index->state == FDS_INDEX_UPDATING))
+    {
+        index_insert(m_p_index, p_header);
+    }
+    m_index_changes++;
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Free an index entry. Entries further down the same probe sequence are shifted back into
+// the hole, so that lookups can stop at the first free entry.
+// NOTE: Must be called from within a critical section.
+static void index_entry_remove(uint16_t i)
+{
+    uint16_t j = i;
+
+    while (true)
+    {
+        j = index_next(j);
+
+        if (m_p_index->entries[j].p_record == NULL)
+        {
+            break;
+        }
+
+        uint16_t const home = index_hash(m_p_index->entries[j].file_id,
+                                         m_p_index->entries[j].record_key);
+
+        // The entry can fill the hole unless its home slot lies between the hole and itself.
+        if (((j - home) & (FDS_INDEX_SIZE - 1)) >= ((j - i) & (FDS_INDEX_SIZE - 1)))
+        {
+            m_p_index->entries[i] = m_p_index->entries[j];
+            i = j;
+        }
+    }
+
+    m_p_index->entries[i].p_record = NULL;
+    m_p_index->count--;
+}
+
+
+// Remove a record from the index. Must be called before the record is flagged as dirty,
+// since that changes its record key.
+static void index_remove(fds_header_t const * const p_header)
+{
+    CRITICAL_SECTION_ENTER();
+    if (m_p_index->state == FDS_INDEX_VALID)
+    {
+        uint16_t i = index_hash(p_header->file_id, p_header->record_key);
+
+        while (m_p_index->entries[i].p_record != NULL)
+        {
+            if (m_p_index->entries[i].p_record == (uint32_t const *)p_header)
+            {
+                index_entry_remove(i);
+                break;
+            }
+            i = index_next(i);
+        }
+    }
+    m_index_changes++;
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Update the index after a page has been garbage collected: drop the records at the old
+// address of the page and add the records which were copied to its new address.
+// The page is scanned with interrupts enabled, searches scan flash meanwhile.
+static void index_page_replace(uint32_t const * const p_old_addr, uint16_t page)
+{
+    bool update;
+
+    CRITICAL_SECTION_ENTER();
+    update = (m_p_index->state == FDS_INDEX_VALID);
+    if (update)
+    {
+        uint16_t i = 0;
+
+        while (i < FDS_INDEX_SIZE)
+        {
+            uint32_t const * const p_record = m_p_index->entries[i].p_record;
+
+            if ((p_record > p_old_addr) && (p_record < p_old_addr + FDS_PAGE_SIZE))
+            {
+                // Another entry might have been moved here, check this slot again.
+                index_entry_remove(i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        m_p_index->state = FDS_INDEX_UPDATING;
+    }
+    m_index_changes++;
+    CRITICAL_SECTION_EXIT();
+
+    if (update)
+    {
+        uint32_t const * p_record = NULL;
+
+        while (record_find_next(page, &p_record))
+        {
+            index_add((fds_header_t const *)p_record);
+        }
+
+        CRITICAL_SECTION_ENTER();
+        if (m_p_index->state == FDS_INDEX_UPDATING)
+        {
+            m_p_index->state = FDS_INDEX_VALID;
+        }
+        CRITICAL_SECTION_EXIT();
+    }
+}
+
+
+// Give an overflowed index another chance once garbage collection has removed records.
+static void index_overflow_retry(void)
+{
+    CRITICAL_SECTION_ENTER();
+    if (m_p_index->state == FDS_INDEX_OVERFLOW)
+    {
+        m_p_index->state = FDS_INDEX_STALE;
+    }
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Build the index by scanning all data pages.
+// Flash is scanned with interrupts enabled, into the spare index. The result replaces the
+// index in use only if no record was added or removed meanwhile, otherwise the index stays
+// stale and is built again by the next search.
+static void index_build(void)
+{
+    fds_index_t * p_build;
+    uint32_t      changes;
+
+    CRITICAL_SECTION_ENTER();
+    p_build = m_index_building ? NULL :
+              ((m_p_index == &m_index[0]) ? &m_index[1] : &m_index[0]);
+    m_index_building = true;
+    changes          = m_index_changes;
+    CRITICAL_SECTION_EXIT();
+
+    if (p_build == NULL)
+    {
+        // Already being built in a lower priority context.
+        return;
+    }
+
+    memset(p_build, 0x00, sizeof(fds_index_t));
+    p_build->state = FDS_INDEX_VALID;
+
+    for (uint16_t page = 0; page < FDS_DATA_PAGES; page++)
+    {
+        if (m_pages[page].page_type == FDS_PAGE_DATA)
+        {
+            uint32_t const * p_record = NULL;
+
+            while (record_find_next(page, &p_record))
+            {
+                index_insert(p_build, (fds_header_t const *)p_record);
+            }
+        }
+    }
+
+    CRITICAL_SECTION_ENTER();
+    if (changes == m_index_changes)
+    {
+        m_p_index = p_build;
+    }
+    m_index_building = false;
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Search the index for the first matching record after the position stored in the token.
+// Records are returned in the same order as a flash scan would return them.
+// The index is searched FDS_INDEX_FIND_CHUNK entries at a time, each chunk in a critical
+// section. Returns false if the index could not be used, or if it changed between two chunks;
+// the caller must then scan flash. The token is only updated if true is returned.
+static bool index_find(uint16_t          const * p_file_id,
+                       uint16_t          const * p_record_key,
+                       fds_record_desc_t       * p_desc,
+                       fds_find_token_t        * p_token,
+                       ret_code_t              * p_ret)
+{
+    fds_index_t const * p_index;
+    uint32_t            changes;
+    bool                valid;
+    bool                done       = false;
+    uint32_t const    * p_found    = NULL;
+    uint16_t            found_page = FDS_DATA_PAGES;
+
+    // If both the file ID and the record key are known, only their probe sequence is searched.
+    bool     const   hashed     = (p_file_id != NULL) && (p_record_key != NULL);
+    uint16_t         i          = hashed ? index_hash(*p_file_id, *p_record_key) : 0;
+    uint16_t         n          = 0;
+
+    CRITICAL_SECTION_ENTER();
+    p_index = m_p_index;
+    changes = m_index_changes;
+    valid   = (p_index->state == FDS_INDEX_VALID);
+    CRITICAL_SECTION_EXIT();
+
+    while (valid && !done && (n < FDS_INDEX_SIZE))
+    {
+        CRITICAL_SECTION_ENTER();
+        valid = (m_p_index == p_index) && (m_index_changes == changes);
+
+        for (uint16_t const end = n + FDS_INDEX_FIND_CHUNK;
+             valid && !done && (n < end) && (n < FDS_INDEX_SIZE);
+             n++, i = index_next(i))
+        {
+            fds_index_entry_t const * const p_entry = &p_index->entries[i];
+            uint16_t                        page;
+
+            if (p_entry->p_record == NULL)
+            {
+                done = hashed;
+                continue;
+            }
+
+            if (((p_file_id    != NULL) && (p_entry->file_id    != *p_file_id)) ||
+                ((p_record_key != NULL) && (p_entry->record_key != *p_record_key)))
+            {
+                continue;
+            }
+
+            if (page_from_record(&page, p_entry->p_record) != NRF_SUCCESS)
+            {
+                // Should not happen.
+                continue;
+            }
+
+            // Skip records that have already been returned.
+            if ((page < p_token->page) ||
+                ((page == p_token->page) && (p_token->p_addr != NULL) &&
+                 (p_entry->p_record <= p_token->p_addr)))
+            {
+                continue;
+            }
+
+            if ((p_found == NULL) ||
+                (page < found_page) ||
+                ((page == found_page) && (p_entry->p_record < p_found)))
+            {
+                p_found    = p_entry->p_record;
+                found_page = page;
+            }
+        }
+        CRITICAL_SECTION_EXIT();
+    }
+
+    if (!valid)
+    {
+        return false;
+    }
+
+    if (p_found == NULL)
+    {
+        // Leave the token as a completed flash scan would.
+        p_token->page   = FDS_DATA_PAGES;
+        p_token->p_addr = NULL;
+        *p_ret          = FDS_ERR_NOT_FOUND;
+        return true;
+    }
+
+    p_token->page   = found_page;
+    p_token->p_addr = p_found;
+
+    p_desc->record_id    = ((fds_header_t const *)p_found)->record_id;
+    p_desc->p_record     = p_found;
+    p_desc->gc_run_count = m_gc.run_count;
+
+    *p_ret = NRF_SUCCESS;
+    return true;
+}
+
+#endif // FDS_INDEX_SIZE > 0
+
+
 // Find a record given its descriptor and retrive the page in which the record is stored.
 // NOTE: Do not pass NULL as an argument for p_page.
 static bool record_find_by_desc(fds_record_desc_t * const p_desc, uint16_t * const p_page)
@@ -533,6 +935,24 @@ static ret_code_t record_find(uint16_t          const * p_file_id,
         return FDS_ERR_NULL_ARG;
     }
 
+#if (FDS_INDEX_SIZE > 0)
+    // Search the index instead of flash, unless iterating through all records.
+    if ((p_file_id != NULL) || (p_record_key != NULL))
+    {
+        ret_code_t ret;
+
+        if (m_p_index->state == FDS_INDEX_STALE)
+        {
+            index_build();
+        }
+
+        if (index_find(p_file_id, p_record_key, p_desc, p_token, &ret))
+        {
+            return ret;
+        }
+    }
+#endif
+
     // Begin (or resume) searching for a record.
     for (; p_token->page < FDS_DATA_PAGES; p_token->page++)
     {
@@ -602,6 +1022,16 @@ static void records_stat(uint16_t   page,
                 p_header = header_jump(p_header);
                 break;
 
+            case FDS_HEADER_BATCH:
+            {
+                // Count the marker, and the records of a batch that was not committed, as dirty.
+                fds_header_t const * const p_next = batch_jump(p_header);
+
+                *p_dirty_records  += 1;
+                *p_freeable_words += (uint16_t)((uint32_t*)p_next - (uint32_t*)p_header);
+                p_header = p_next;
+            } break;
+
             case FDS_HEADER_CORRUPT:
             {
                 *p_dirty_records  += 1;
@@ -721,6 +1151,18 @@ static fds_init_opts_t pages_init(void)
                 // can be garbage collected. Additionally, update the latest kwown record ID.
                 page_scan(p_page_addr, &m_pages[page].write_offset, &m_pages[page].can_gc);
 
+#if (FDS_GC_DIRTY_THRESHOLD > 0)
+                // Count the words used by deleted records, for automatic garbage collection.
+                {
+                    uint16_t valid_records = 0;
+                    uint16_t dirty_records = 0;
+                    bool     corruption    = false;
+
+                    records_stat(page, &valid_records, &dirty_records,
+                                 &m_pages[page].words_dirty, &corruption);
+                }
+#endif
+
                 ret |= PAGE_DATA;
                 page++;
             } break;
@@ -819,16 +1261,37 @@ static ret_code_t record_header_flag_dirty(uint32_t * const p_record, uint16_t p
     // Flag the record as dirty.
     ret_code_t ret;
 
+#if (FDS_INDEX_SIZE > 0)
+    // The record key is needed to find the record in the index, so remove it first.
+    index_remove((fds_header_t const *)p_record);
+#endif
+
     ret = nrf_fstorage_write(&m_fs, (uint32_t)p_record,
         &dirty_header, FDS_HEADER_SIZE_TL * sizeof(uint32_t), NULL);
 
     if (ret != NRF_SUCCESS)
     {
+#if (FDS_INDEX_SIZE > 0)
+        // The record is still valid.
+        index_invalidate();
+#endif
         return FDS_ERR_BUSY;
     }
 
     m_pages[page_to_gc].can_gc = true;
 
+#if (FDS_GC_DIRTY_THRESHOLD > 0)
+    // The record length is not affected by flagging the record as dirty.
+    m_pages[page_to_gc].words_dirty += FDS_HEADER_SIZE + ((fds_header_t const *)p_record)->length_words;
+
+    // Start garbage collection, unless it is already running.
+    if ((m_pages[page_to_gc].words_dirty >= FDS_GC_DIRTY_THRESHOLD) &&
+        (m_gc.state == GC_BEGIN) && !m_gc.auto_queued)
+    {
+        m_gc.auto_queued = (gc_enqueue(true) == NRF_SUCCESS);
+    }
+#endif
+
     return NRF_SUCCESS;
 }
 
@@ -926,7 +1389,31 @@ static bool crc_verify_success(uint16_t crc, uint16_t len_words, uint32_t const
 #endif
 
 
-static void gc_init(void)
+#if (FDS_GC_INCREMENTAL)
+// Record when garbage collection of a page begins.
+static void gc_step_begin(void)
+{
+#if NRF_MODULE_ENABLED(APP_TIMER)
+    m_gc.step_start = app_timer_cnt_get();
+#endif
+}
+
+
+// Compute how long garbage collection of a page took.
+static void gc_step_end(void)
+{
+#if NRF_MODULE_ENABLED(APP_TIMER)
+    m_gc.step_duration = app_timer_cnt_diff_compute(app_timer_cnt_get(), m_gc.step_start);
+#else
+    m_gc.step_duration = 0;
+#endif
+}
+#endif
+
+
+// If dirty_only is set, only pages with at least FDS_GC_DIRTY_THRESHOLD words of deleted
+// records are garbage collected.
+static void gc_init(bool dirty_only)
 {
     m_gc.run_count++;
     m_gc.cur_page = 0;
@@ -937,7 +1424,14 @@ static void gc_init(void)
     for (uint16_t i = 0; i < FDS_DATA_PAGES; i++)
     {
         m_gc.do_gc_page[i] = (m_pages[i].page_type == FDS_PAGE_DATA);
+#if (FDS_GC_DIRTY_THRESHOLD > 0)
+        m_gc.do_gc_page[i] = m_gc.do_gc_page[i] &&
+                             (!dirty_only || (m_pages[i].words_dirty >= FDS_GC_DIRTY_THRESHOLD));
+#endif
     }
+#if (FDS_GC_DIRTY_THRESHOLD == 0)
+    UNUSED_PARAMETER(dirty_only);
+#endif
 }
 
 
@@ -1066,10 +1560,37 @@ static ret_code_t gc_next_page(void)
         return FDS_OP_COMPLETED;
     }
 
+#if (FDS_GC_INCREMENTAL)
+    gc_step_begin();
+#endif
+
     return gc_record_find_next();
 }
 
 
+#if (FDS_GC_INCREMENTAL)
+// End garbage collection between two pages, when it cannot be queued again.
+// Flash is consistent at this point, the remaining pages are collected by the next fds_gc().
+static void gc_abort(ret_code_t result)
+{
+    fds_evt_t const evt =
+    {
+        .id     = FDS_EVT_GC,
+        .result = result,
+    };
+
+    m_gc.state        = GC_BEGIN;
+    m_gc.cur_page     = 0;
+    m_gc.p_record_src = NULL;
+#if (FDS_GC_DIRTY_THRESHOLD > 0)
+    m_gc.auto_queued  = false;
+#endif
+
+    event_send(&evt);
+}
+#endif
+
+
 // Update the swap page offeset after a record has been successfully copied to it.
 static void gc_update_swap_offset(void)
 {
@@ -1094,16 +1615,28 @@ static void gc_swap_pages(void)
     m_swap_page.write_offset            = FDS_PAGE_TAG_SIZE;
 
     // Page has been garbage collected
-    m_pages[m_gc.cur_page].can_gc = false;
+    m_pages[m_gc.cur_page].can_gc      = false;
+    m_pages[m_gc.cur_page].words_dirty = 0;
+
+#if (FDS_GC_INCREMENTAL)
+    // Other operations run before GC completes. Make descriptors to the records which
+    // have been moved look them up again.
+    m_gc.run_count++;
+#endif
+
+#if (FDS_INDEX_SIZE > 0)
+    // The valid records of the page have been moved.
+    index_page_replace(m_swap_page.p_addr, m_gc.cur_page);
+#endif
 }
 
 
-static void gc_state_advance(void)
+static void gc_state_advance(bool dirty_only)
 {
     switch (m_gc.state)
     {
         case GC_BEGIN:
-            gc_init();
+            gc_init(dirty_only);
             m_gc.state = GC_NEXT_PAGE;
             break;
 
@@ -1175,6 +1708,9 @@ static ret_code_t init_execute(uint32_t prev_ret, fds_op_t * const p_op)
             }
             if (!write_reqd)
             {
+#if (FDS_INDEX_SIZE > 0)
+                index_build();
+#endif
                 m_flags.initialized  = true;
                 m_flags.initializing = false;
                 return FDS_OP_COMPLETED;
@@ -1287,6 +1823,10 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
             break;
 
         case FDS_OP_WRITE_FLAG_DIRTY:
+#if (FDS_INDEX_SIZE > 0)
+            // The new copy of the record is complete.
+            index_add((fds_header_t const *)p_write_addr);
+#endif
             p_op->write.step = FDS_OP_WRITE_DONE;
             ret = record_header_flag_dirty((uint32_t*)desc.p_record, page);
             break;
@@ -1294,6 +1834,13 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
         case FDS_OP_WRITE_DONE:
             ret = FDS_OP_COMPLETED;
 
+#if (FDS_INDEX_SIZE > 0)
+            if (p_op->op_code == FDS_OP_WRITE)
+            {
+                index_add((fds_header_t const *)p_write_addr);
+            }
+#endif
+
 #if (FDS_CRC_CHECK_ON_WRITE)
             if (!crc_verify_success(p_op->write.header.crc16,
                                     p_op->write.header.length_words,
@@ -1321,6 +1868,155 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
 }
 
 
+// Prepare the header of the next record of a batch.
+static void batch_record_prepare(fds_op_t * const p_op)
+{
+    fds_record_t const * const p_record = &p_op->batch.p_records[p_op->batch.current];
+    uint16_t                   crc      = 0;
+
+    p_op->batch.header.record_key   = p_record->key;
+    p_op->batch.header.length_words = (uint16_t)p_record->data.length_words;
+    p_op->batch.header.file_id      = p_record->file_id;
+    p_op->batch.header.record_id    = p_op->batch.first_id + p_op->batch.current;
+
+#if (FDS_CRC_CHECK_ON_READ)
+    // Same as write_enqueue().
+    crc = crc16_compute((uint8_t*)&p_op->batch.header,           6, NULL);
+    crc = crc16_compute((uint8_t*)&p_op->batch.header.record_id, 4, &crc);
+    crc = crc16_compute((uint8_t*)p_record->data.p_data,
+                        p_record->data.length_words * sizeof(uint32_t), &crc);
+#endif
+
+    p_op->batch.header.crc16 = crc;
+}
+
+
+// The batch has been committed. Its records are now valid, and its marker can be garbage collected.
+static ret_code_t batch_done(fds_op_t const * const p_op, uint32_t const * const p_marker)
+{
+    ret_code_t                 ret      = FDS_OP_COMPLETED;
+    fds_page_t         * const p_page   = &m_pages[p_op->batch.page];
+    fds_header_t const *       p_header = (fds_header_t*)(p_marker + FDS_BATCH_MARKER_SIZE);
+
+    for (uint16_t i = 0; i < p_op->batch.count; i++)
+    {
+#if (FDS_CRC_CHECK_ON_WRITE)
+        if (!crc_verify_success(p_header->crc16, p_header->length_words, (uint32_t*)p_header))
+        {
+            ret = FDS_ERR_CRC_CHECK_FAILED;
+        }
+#endif
+#if (FDS_INDEX_SIZE > 0)
+        index_add(p_header);
+#endif
+        p_header = header_jump(p_header);
+    }
+
+    p_page->can_gc       = true;
+    p_page->words_dirty += FDS_BATCH_MARKER_SIZE;
+
+    return ret;
+}
+
+
+// Executes batch write operations.
+static ret_code_t batch_execute(uint32_t prev_ret, fds_op_t * const p_op)
+{
+    // Must be statically allocated since it will be written to flash.
+    __ALIGN(4) static uint32_t const commit = FDS_BATCH_COMMITTED;
+
+    ret_code_t         ret;
+    fds_page_t * const p_page       = &m_pages[p_op->batch.page];
+    uint32_t   * const p_marker     = (uint32_t*)(p_page->p_addr + p_page->write_offset);
+    uint32_t   * const p_write_addr = p_marker + p_op->batch.offset;
+
+    if (prev_ret != NRF_SUCCESS)
+    {
+        ret = FDS_ERR_OPERATION_TIMEOUT;
+    }
+    else
+    {
+        switch (p_op->batch.step)
+        {
+            case FDS_OP_BATCH_MARKER:
+                // Write the whole header of the marker. If this is interrupted, the record ID
+                // (the last word to be written) is left erased and the marker is dirty.
+                p_op->batch.step   = FDS_OP_BATCH_HEADER_BEGIN;
+                p_op->batch.offset = FDS_BATCH_MARKER_SIZE;
+                ret = nrf_fstorage_write(&m_fs, (uint32_t)p_write_addr,
+                    &p_op->batch.header, FDS_HEADER_SIZE * sizeof(uint32_t), NULL);
+                break;
+
+            case FDS_OP_BATCH_HEADER_BEGIN:
+                batch_record_prepare(p_op);
+                p_op->batch.step = FDS_OP_BATCH_RECORD_ID;
+                ret = nrf_fstorage_write(&m_fs, (uint32_t)(p_write_addr + FDS_OFFSET_TL),
+                    &p_op->batch.header.record_key, FDS_HEADER_SIZE_TL * sizeof(uint32_t), NULL);
+                break;
+
+            case FDS_OP_BATCH_RECORD_ID:
+                p_op->batch.step = (p_op->batch.header.length_words != 0) ?
+                                    FDS_OP_BATCH_DATA : FDS_OP_BATCH_HEADER_FINALIZE;
+                ret = nrf_fstorage_write(&m_fs, (uint32_t)(p_write_addr + FDS_OFFSET_ID),
+                    &p_op->batch.header.record_id, FDS_HEADER_SIZE_ID * sizeof(uint32_t), NULL);
+                break;
+
+            case FDS_OP_BATCH_DATA:
+                p_op->batch.step = FDS_OP_BATCH_HEADER_FINALIZE;
+                ret = nrf_fstorage_write(&m_fs, (uint32_t)(p_write_addr + FDS_OFFSET_DATA),
+                    p_op->batch.p_records[p_op->batch.current].data.p_data,
+                    p_op->batch.header.length_words * sizeof(uint32_t), NULL);
+                break;
+
+            case FDS_OP_BATCH_HEADER_FINALIZE:
+                ret = nrf_fstorage_write(&m_fs, (uint32_t)(p_write_addr + FDS_OFFSET_IC),
+                    &p_op->batch.header.file_id, FDS_HEADER_SIZE_IC * sizeof(uint32_t), NULL);
+
+                // Move on to the next record, or commit the batch if this was the last one.
+                p_op->batch.offset += FDS_HEADER_SIZE + p_op->batch.header.length_words;
+                p_op->batch.current++;
+                p_op->batch.step = (p_op->batch.current < p_op->batch.count) ?
+                                    FDS_OP_BATCH_HEADER_BEGIN : FDS_OP_BATCH_COMMIT;
+                break;
+
+            case FDS_OP_BATCH_COMMIT:
+                // A single word write makes all records of the batch valid.
+                p_op->batch.step = FDS_OP_BATCH_DONE;
+                ret = nrf_fstorage_write(&m_fs, (uint32_t)(p_marker + FDS_OFFSET_DATA),
+                    &commit, sizeof(uint32_t), NULL);
+                break;
+
+            case FDS_OP_BATCH_DONE:
+                ret = batch_done(p_op, p_marker);
+                break;
+
+            default:
+                ret = FDS_ERR_INTERNAL;
+                break;
+        }
+
+        if ((ret != FDS_OP_COMPLETED) && (ret != FDS_ERR_CRC_CHECK_FAILED) &&
+            (ret != FDS_ERR_INTERNAL))
+        {
+            ret = (ret == NRF_SUCCESS) ? FDS_OP_EXECUTING : FDS_ERR_BUSY;
+        }
+    }
+
+    if (ret != FDS_OP_EXECUTING)
+    {
+        // Once the marker has been written, the space of the whole batch is skipped when
+        // reading the page, whether or not the batch was committed.
+        if (p_op->batch.step > FDS_OP_BATCH_HEADER_BEGIN)
+        {
+            p_page->write_offset += p_op->batch.length_words;
+        }
+        p_page->words_reserved -= p_op->batch.length_words;
+    }
+
+    return ret;
+}
+
+
 static ret_code_t delete_execute(uint32_t prev_ret, fds_op_t * const p_op)
 {
     ret_code_t ret;
@@ -1360,7 +2056,7 @@ static ret_code_t delete_execute(uint32_t prev_ret, fds_op_t * const p_op)
 }
 
 
-static ret_code_t gc_execute(uint32_t prev_ret)
+static ret_code_t gc_execute(uint32_t prev_ret, fds_op_t const * const p_op)
 {
     ret_code_t ret;
 
@@ -1375,7 +2071,17 @@ static ret_code_t gc_execute(uint32_t prev_ret)
     }
     else
     {
-        gc_state_advance();
+#if (FDS_GC_INCREMENTAL)
+        if (m_gc.state == GC_TAG_NEW_SWAP)
+        {
+            // A page has been garbage collected. Let other queued operations run
+            // before collecting the next one.
+            m_gc.state = GC_NEXT_PAGE;
+            gc_step_end();
+            return FDS_OP_GC_YIELD;
+        }
+#endif
+        gc_state_advance(p_op->gc.dirty_only);
     }
 
     switch (m_gc.state)
@@ -1454,7 +2160,11 @@ static void queue_process(ret_code_t result)
                 break;
 
             case FDS_OP_GC:
-                result = gc_execute(result);
+                result = gc_execute(result, m_p_cur_op);
+                break;
+
+            case FDS_OP_WRITE_BATCH:
+                result = batch_execute(result, m_p_cur_op);
                 break;
 
             default:
@@ -1468,11 +2178,38 @@ static void queue_process(ret_code_t result)
             break;
         }
 
+#if (FDS_INDEX_SIZE > 0)
+        if ((result != FDS_OP_COMPLETED) && (result != FDS_OP_GC_YIELD) &&
+            (result != FDS_ERR_NOT_FOUND))
+        {
+            // The operation was interrupted, the index might not match the contents of flash.
+            index_invalidate();
+        }
+
+        if ((m_p_cur_op->op_code == FDS_OP_GC) && (result == FDS_OP_COMPLETED))
+        {
+            // Records might have been removed, the index might hold all of them again.
+            index_overflow_retry();
+        }
+#endif
+
         // The operation has completed (either successfully or with an error).
         // - send an event to the user
         // - free the operation buffer
         // - execute any other queued operations
 
+#if (FDS_GC_INCREMENTAL)
+        bool const gc_yield = (result == FDS_OP_GC_YIELD);
+#endif
+
+#if (FDS_GC_DIRTY_THRESHOLD > 0)
+        if ((m_p_cur_op->op_code == FDS_OP_GC) && (result != FDS_OP_GC_YIELD))
+        {
+            // Garbage collection is done (or has failed), it can be started again.
+            m_gc.auto_queued = false;
+        }
+#endif
+
         fds_evt_t evt =
         {
             // The operation might have failed for one of the following reasons:
@@ -1480,10 +2217,21 @@ static void queue_process(ret_code_t result)
             // FDS_ERR_OPERATION_TIMEOUT - flash subsystem timed out
             // FDS_ERR_CRC_CHECK_FAILED  - a CRC check failed
             // FDS_ERR_NOT_FOUND         - no record found (delete/update)
-            .result = (result == FDS_OP_COMPLETED) ? NRF_SUCCESS : result,
+            .result = ((result == FDS_OP_COMPLETED) || (result == FDS_OP_GC_YIELD)) ?
+                      NRF_SUCCESS : result,
         };
 
         event_prepare(m_p_cur_op, &evt);
+
+#if (FDS_GC_INCREMENTAL)
+        if (gc_yield)
+        {
+            evt.id          = FDS_EVT_GC_STEP;
+            evt.gc.page     = m_gc.cur_page;
+            evt.gc.duration = m_gc.step_duration;
+        }
+#endif
+
         event_send(&evt);
 
         // Zero the pointer to the current operation so that this function
@@ -1497,6 +2245,18 @@ static void queue_process(ret_code_t result)
         // Free the queue element used by the current operation.
         queue_free(&m_iget_ctx);
 
+#if (FDS_GC_INCREMENTAL)
+        if (gc_yield)
+        {
+            // Continue garbage collection after the operations queued so far.
+            ret_code_t const ret = gc_enqueue(false);
+            if (ret != NRF_SUCCESS)
+            {
+                gc_abort(ret);
+            }
+        }
+#endif
+
         if (!queue_has_next())
         {
             // No more elements left. Nothing to do.
@@ -1521,6 +2281,30 @@ static void fs_event_handler(nrf_fstorage_evt_t * p_evt)
 }
 
 
+#if (FDS_GC_INCREMENTAL) || (FDS_GC_DIRTY_THRESHOLD > 0)
+// Enqueues a garbage collection operation from within fds.
+static ret_code_t gc_enqueue(bool dirty_only)
+{
+    fds_op_t * p_op;
+    nrf_atfifo_item_put_t iput_ctx;
+
+    p_op = queue_buf_get(&iput_ctx);
+    if (p_op == NULL)
+    {
+        return FDS_ERR_NO_SPACE_IN_QUEUES;
+    }
+
+    p_op->op_code       = FDS_OP_GC;
+    p_op->gc.dirty_only = dirty_only;
+
+    queue_buf_store(&iput_ctx);
+    queue_start();
+
+    return NRF_SUCCESS;
+}
+#endif
+
+
 // Enqueues write and update operations.
 static ret_code_t write_enqueue(fds_record_desc_t         * const p_desc,
                                 fds_record_t        const * const p_record,
@@ -1545,6 +2329,7 @@ static ret_code_t write_enqueue(fds_record_desc_t         * const p_desc,
     }
 
     if ((p_record->file_id == FDS_FILE_ID_INVALID) ||
+        (p_record->file_id == FDS_FILE_ID_BATCH)   ||
         (p_record->key     == FDS_RECORD_KEY_DIRTY))
     {
         return FDS_ERR_INVALID_ARG;
@@ -1747,6 +2532,9 @@ ret_code_t fds_init(void)
 
         case ALREADY_INSTALLED:
         {
+#if (FDS_INDEX_SIZE > 0)
+            index_build();
+#endif
             // No initialization is necessary. Notify the application immediately.
             m_flags.initialized  = true;
             m_flags.initializing = false;
@@ -1987,6 +2775,117 @@ ret_code_t fds_record_update(fds_record_desc_t       * const p_desc,
 }
 
 
+ret_code_t fds_record_write_batch(fds_record_desc_t       * const p_descs,
+                                  fds_record_t      const * const p_records,
+                                  uint16_t                        count)
+{
+    ret_code_t              ret;
+    uint16_t                page;
+    uint32_t                length_words = FDS_BATCH_MARKER_SIZE;
+    uint32_t                last_id;
+    fds_op_t              * p_op;
+    nrf_atfifo_item_put_t   iput_ctx;
+
+    if (!m_flags.initialized)
+    {
+        return FDS_ERR_NOT_INITIALIZED;
+    }
+
+    if (p_records == NULL)
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    if (count == 0)
+    {
+        return FDS_ERR_INVALID_ARG;
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if ((p_records[i].file_id == FDS_FILE_ID_INVALID) ||
+            (p_records[i].file_id == FDS_FILE_ID_BATCH)   ||
+            (p_records[i].key     == FDS_RECORD_KEY_DIRTY))
+        {
+            return FDS_ERR_INVALID_ARG;
+        }
+
+        if (!is_word_aligned(p_records[i].data.p_data))
+        {
+            return FDS_ERR_UNALIGNED_ADDR;
+        }
+
+        if (p_records[i].data.length_words > FDS_PAGE_SIZE)
+        {
+            return FDS_ERR_RECORD_TOO_LARGE;
+        }
+
+        length_words += FDS_HEADER_SIZE + p_records[i].data.length_words;
+    }
+
+    if (length_words > FDS_PAGE_SIZE - FDS_PAGE_TAG_SIZE)
+    {
+        return FDS_ERR_RECORD_TOO_LARGE;
+    }
+
+    // Reserve space for the whole batch on one page.
+    // write_space_reserve() accounts for one record header, that of the marker.
+    ret = write_space_reserve((uint16_t)(length_words - FDS_HEADER_SIZE), &page);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    p_op = queue_buf_get(&iput_ctx);
+    if (p_op == NULL)
+    {
+        CRITICAL_SECTION_ENTER();
+        write_space_free((uint16_t)(length_words - FDS_HEADER_SIZE), page);
+        CRITICAL_SECTION_EXIT();
+        return FDS_ERR_NO_SPACE_IN_QUEUES;
+    }
+
+    // One record ID for the marker, followed by consecutive IDs for the records.
+    last_id = nrf_atomic_u32_add(&m_latest_rec_id, count + 1);
+
+    p_op->op_code              = FDS_OP_WRITE_BATCH;
+    p_op->batch.step           = FDS_OP_BATCH_MARKER;
+    p_op->batch.p_records      = p_records;
+    p_op->batch.first_id       = last_id - count + 1;
+    p_op->batch.count          = count;
+    p_op->batch.page           = page;
+    p_op->batch.length_words   = (uint16_t)length_words;
+
+    // The marker comes first. Its record key holds the size of the records that follow it.
+    p_op->batch.header.record_key   = (uint16_t)(length_words - FDS_BATCH_MARKER_SIZE);
+    p_op->batch.header.length_words = FDS_BATCH_MARKER_SIZE - FDS_HEADER_SIZE;
+    p_op->batch.header.file_id      = FDS_FILE_ID_BATCH;
+    p_op->batch.header.record_id    = last_id - count;
+    // The marker is never returned as a record, so its CRC is not checked. Its data is
+    // programmed on commit anyway.
+    p_op->batch.header.crc16        = 0;
+
+    queue_buf_store(&iput_ctx);
+
+    // Initialize the record descriptors, if provided.
+    if (p_descs != NULL)
+    {
+        for (uint16_t i = 0; i < count; i++)
+        {
+            p_descs[i].p_record       = NULL;
+            p_descs[i].record_id      = p_op->batch.first_id + i;
+            p_descs[i].record_is_open = false;
+            p_descs[i].gc_run_count   = m_gc.run_count;
+        }
+    }
+
+    // Start processing the queue, if necessary.
+    queue_start();
+
+    return NRF_SUCCESS;
+}
+
+
 ret_code_t fds_record_delete(fds_record_desc_t * const p_desc)
 {
     fds_op_t * p_op;
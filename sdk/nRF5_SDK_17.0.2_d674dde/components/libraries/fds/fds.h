@@ -78,6 +78,14 @@ extern "C" {
 #define FDS_RECORD_KEY_DIRTY    (0x0000)
 
 
+/**@brief   File ID of the markers used by @ref fds_record_write_batch.
+ *
+ * Records with this file ID are used internally and are never returned by search functions.
+ * This value must not be used as a file ID by the application.
+ */
+#define FDS_FILE_ID_BATCH       (0xFFFE)
+
+
 /**@brief   FDS return values.
  */
 enum
@@ -191,7 +199,9 @@ typedef enum
     FDS_EVT_UPDATE,     //!< Event for @ref fds_record_update.
     FDS_EVT_DEL_RECORD, //!< Event for @ref fds_record_delete.
     FDS_EVT_DEL_FILE,   //!< Event for @ref fds_file_delete.
-    FDS_EVT_GC          //!< Event for @ref fds_gc.
+    FDS_EVT_GC,         //!< Event for @ref fds_gc.
+    FDS_EVT_GC_STEP,    //!< A virtual page was garbage collected. Only sent if FDS_GC_INCREMENTAL is enabled.
+    FDS_EVT_WRITE_BATCH //!< Event for @ref fds_record_write_batch.
 } fds_evt_id_t;
 
 
@@ -217,6 +227,16 @@ typedef struct
             uint16_t file_id;
             uint16_t record_key;
         } del; //!< Information for @ref FDS_EVT_DEL_RECORD and @ref FDS_EVT_DEL_FILE events.
+        struct
+        {
+            uint16_t page;      //!< The virtual page that was garbage collected.
+            uint32_t duration;  //!< Time spent on the page, in app_timer ticks. Zero if app_timer is disabled.
+        } gc; //!< Information for @ref FDS_EVT_GC_STEP events.
+        struct
+        {
+            uint32_t first_record_id;   //!< The record ID of the first record in the batch.
+            uint16_t count;             //!< The number of records in the batch.
+        } batch; //!< Information for @ref FDS_EVT_WRITE_BATCH events.
     };
 } fds_evt_t;
 
@@ -300,10 +320,10 @@ ret_code_t fds_init(void);
  *
  * There are no restrictions on the file ID and the record key, except that the record key must be
  * different from @ref FDS_RECORD_KEY_DIRTY and the file ID must be different from
- * @ref FDS_FILE_ID_INVALID. In particular, no restrictions are made regarding the uniqueness of
- * the file ID or the record key. All records with the same file ID are grouped into one file.
- * If no file with the specified ID exists, it is created. There can be multiple records with the
- * same record key in a file.
+ * @ref FDS_FILE_ID_INVALID and @ref FDS_FILE_ID_BATCH. In particular, no restrictions are made
+ * regarding the uniqueness of the file ID or the record key. All records with the same file ID
+ * are grouped into one file. If no file with the specified ID exists, it is created.
+ * There can be multiple records with the same record key in a file.
  *
  * Some modules need exclusive use of certain file IDs and record keys.
  * See @ref lib_fds_functionality_keys for details.
@@ -375,10 +395,10 @@ ret_code_t fds_reserve_cancel(fds_reserve_token_t * p_token);
  *
  * There are no restrictions on the file ID and the record key, except that the record key must be
  * different from @ref FDS_RECORD_KEY_DIRTY and the file ID must be different from
- * @ref FDS_FILE_ID_INVALID. In particular, no restrictions are made regarding the uniqueness of
- * the file ID or the record key. All records with the same file ID are grouped into one file.
- * If no file with the specified ID exists, it is created. There can be multiple records with the
- * same record key in a file.
+ * @ref FDS_FILE_ID_INVALID and @ref FDS_FILE_ID_BATCH. In particular, no restrictions are made
+ * regarding the uniqueness of the file ID or the record key. All records with the same file ID
+ * are grouped into one file. If no file with the specified ID exists, it is created.
+ * There can be multiple records with the same record key in a file.
  *
  * Record data can consist of multiple chunks. The data must be aligned to a 4 byte boundary, and
  * because it is not buffered internally, it must be kept in memory until the callback for the
@@ -412,6 +432,43 @@ ret_code_t fds_record_write_reserved(fds_record_desc_t         * p_desc,
                                      fds_reserve_token_t const * p_token);
 
 
+/**@brief   Function for writing several records to flash as one operation.
+ *
+ * The records are written back-to-back in a single reserved space and become valid together:
+ * until the whole batch has been written, none of its records can be found, and if writing is
+ * interrupted (for example, by a power loss), none of them is ever found. Space for deleted
+ * records is reclaimed by garbage collection as usual.
+ *
+ * The same restrictions as for @ref fds_record_write apply to each record. In addition, the file
+ * ID must be different from @ref FDS_FILE_ID_BATCH, and the whole batch, including a marker of
+ * 16 bytes, must fit in a virtual page. Neither the array of records nor the record data is
+ * buffered internally; both must be kept in memory until the callback for the operation has been
+ * received.
+ *
+ * The records are given consecutive record IDs. This function is asynchronous. Completion is
+ * reported through a single @ref FDS_EVT_WRITE_BATCH event that is sent to the registered event
+ * handler function.
+ *
+ * @param[out]  p_descs     Array of @p count descriptors of the records that were written.
+ *                          Pass NULL if you do not need the descriptors.
+ * @param[in]   p_records   Array of records to be written to flash.
+ * @param[in]   count       The number of records in the batch.
+ *
+ * @retval  NRF_SUCCESS                 If the operation was queued successfully.
+ * @retval  FDS_ERR_NOT_INITIALIZED     If the module is not initialized.
+ * @retval  FDS_ERR_NULL_ARG            If @p p_records is NULL.
+ * @retval  FDS_ERR_INVALID_ARG         If @p count is zero, or a file ID or record key is invalid.
+ * @retval  FDS_ERR_UNALIGNED_ADDR      If the data of a record is not aligned to a 4 byte boundary.
+ * @retval  FDS_ERR_RECORD_TOO_LARGE    If the batch does not fit in a virtual page.
+ * @retval  FDS_ERR_NO_SPACE_IN_QUEUES  If the operation queue is full.
+ * @retval  FDS_ERR_NO_SPACE_IN_FLASH   If there is not enough free space in flash to store the
+ *                                      batch.
+ */
+ret_code_t fds_record_write_batch(fds_record_desc_t       * p_descs,
+                                  fds_record_t      const * p_records,
+                                  uint16_t                  count);
+
+
 /**@brief   Function for deleting a record.
  *
  * Deleted records cannot be located using @ref fds_record_find, @ref fds_record_find_by_key, or
@@ -463,10 +520,10 @@ ret_code_t fds_file_delete(uint16_t file_id);
  *
  * There are no restrictions on the file ID and the record key, except that the record key must be
  * different from @ref FDS_RECORD_KEY_DIRTY and the file ID must be different from
- * @ref FDS_FILE_ID_INVALID. In particular, no restrictions are made regarding the uniqueness of
- * the file ID or the record key. All records with the same file ID are grouped into one file.
- * If no file with the specified ID exists, it is created. There can be multiple records with the
- * same record key in a file.
+ * @ref FDS_FILE_ID_INVALID and @ref FDS_FILE_ID_BATCH. In particular, no restrictions are made
+ * regarding the uniqueness of the file ID or the record key. All records with the same file ID
+ * are grouped into one file. If no file with the specified ID exists, it is created.
+ * There can be multiple records with the same record key in a file.
  *
  * Record data can consist of multiple chunks. The data must be aligned to a 4 byte boundary, and
  * because it is not buffered internally, it must be kept in memory until the callback for the
@@ -632,6 +689,14 @@ ret_code_t fds_record_close(fds_record_desc_t * p_desc);
  * This function is asynchronous. Completion is reported through the @ref FDS_EVT_GC event that
  * is sent to the registered event handler function.
  *
+ * If FDS_GC_INCREMENTAL is enabled, garbage collection yields after each virtual page so that
+ * operations queued in the meantime are executed before the next page is collected. An
+ * @ref FDS_EVT_GC_STEP event is sent for each page. If the queue is full when the next page is
+ * due, garbage collection ends with an @ref FDS_EVT_GC event with the result
+ * FDS_ERR_NO_SPACE_IN_QUEUES. If FDS_GC_DIRTY_THRESHOLD is set, garbage
+ * collection of pages with at least that many words of deleted records is started automatically
+ * when records are deleted or updated, and @ref FDS_EVT_GC is sent when it completes.
+ *
  * @retval  NRF_SUCCESS                 If the operation was queued successfully.
  * @retval  FDS_ERR_NOT_INITIALIZED     If the module is not initialized.
  * @retval  FDS_ERR_NO_SPACE_IN_QUEUES  If the operation queue is full.
@@ -73,8 +73,15 @@ extern "C" {
 #define FDS_HEADER_SIZE_ID      (1) // Size of the record ID in the header, in 4-byte words.
 #define FDS_HEADER_SIZE         (3) // Size of the whole header, in 4-byte words.
 
+// A batch marker is a record with file ID FDS_FILE_ID_BATCH, followed by the records of the batch.
+// Its record key holds the size of these records, in 4-byte words, and its data is one word
+// which is programmed to zero once all records of the batch have been written.
+#define FDS_BATCH_MARKER_SIZE   (FDS_HEADER_SIZE + 1)
+#define FDS_BATCH_COMMITTED     (0x00000000)
+
 #define FDS_OP_EXECUTING        (NRF_SUCCESS)
 #define FDS_OP_COMPLETED        (0x1D1D)
+#define FDS_OP_GC_YIELD         (0x1D1E) // A page was garbage collected; let other operations run.
 
 #define NRF_FSTORAGE_NVMC       1
 #define NRF_FSTORAGE_SD         2
@@ -109,6 +116,34 @@ extern "C" {
     #error "FDS requires at least two virtual pages."
 #endif
 
+// The number of entries in the RAM record index. Zero disables the index.
+#ifndef FDS_INDEX_SIZE
+    #define FDS_INDEX_SIZE          (0)
+#endif
+
+#if (FDS_INDEX_SIZE & (FDS_INDEX_SIZE - 1)) != 0
+    #error "FDS_INDEX_SIZE must be a power of two."
+#endif
+
+// Garbage collect one page per queued operation.
+#ifndef FDS_GC_INCREMENTAL
+    #define FDS_GC_INCREMENTAL      (0)
+#endif
+
+// The number of words of deleted records on a page that starts garbage collection automatically.
+// Zero disables automatic garbage collection.
+#ifndef FDS_GC_DIRTY_THRESHOLD
+    #define FDS_GC_DIRTY_THRESHOLD  (0)
+#endif
+
+// The maximum number of records in the index. The table is kept at most 3/4 full
+// so that chains of the open addressing scheme stay short.
+#define FDS_INDEX_MAX_RECORDS       (FDS_INDEX_SIZE - (FDS_INDEX_SIZE / 4))
+
+// The number of index entries searched per critical section. Searches which are not by both
+// file ID and record key walk the whole index, interrupts are served between the chunks.
+#define FDS_INDEX_FIND_CHUNK        (16)
+
 
 // Page types.
 typedef enum
@@ -124,7 +159,8 @@ typedef enum
 {
     FDS_HEADER_VALID,   // Valid header.
     FDS_HEADER_DIRTY,   // Header is incomplete, or record has been deleted.
-    FDS_HEADER_CORRUPT  // Header contains corrupt information, not related to CRC.
+    FDS_HEADER_CORRUPT, // Header contains corrupt information, not related to CRC.
+    FDS_HEADER_BATCH    // Valid batch marker.
 } fds_header_status_t;
 
 
@@ -136,6 +172,7 @@ typedef struct
     uint16_t                words_reserved; // The amount of words reserved.
     uint32_t volatile       records_open;   // The number of open records.
     bool                    can_gc;         // Indicates that there are some records that have been deleted.
+    uint16_t                words_dirty;    // The amount of words used by deleted records.
 } fds_page_t;
 
 
@@ -155,7 +192,8 @@ typedef enum
     FDS_OP_UPDATE,      // Update a record.
     FDS_OP_DEL_RECORD,  // Delete a record.
     FDS_OP_DEL_FILE,    // Delete a file.
-    FDS_OP_GC           // Run garbage collection.
+    FDS_OP_GC,          // Run garbage collection.
+    FDS_OP_WRITE_BATCH  // Write several records at once.
 } fds_op_code_t;
 
 
@@ -180,6 +218,18 @@ typedef enum
 } fds_write_step_t;
 
 
+typedef enum
+{
+    FDS_OP_BATCH_MARKER,            // Write the batch marker header.
+    FDS_OP_BATCH_HEADER_BEGIN,      // Write the record key and length of the next record.
+    FDS_OP_BATCH_RECORD_ID,         // Write the record ID.
+    FDS_OP_BATCH_DATA,              // Write the record data.
+    FDS_OP_BATCH_HEADER_FINALIZE,   // Write the file ID and CRC.
+    FDS_OP_BATCH_COMMIT,            // Program the commit word of the marker.
+    FDS_OP_BATCH_DONE,
+} fds_batch_step_t;
+
+
 typedef enum
 {
     FDS_OP_DEL_RECORD_FLAG_DIRTY,   // Flag a record as dirty.
@@ -221,6 +271,22 @@ typedef struct
             uint16_t          record_key;
             uint32_t          record_to_delete;
         } del;
+        struct
+        {
+            bool              dirty_only;       // Only collect pages above FDS_GC_DIRTY_THRESHOLD.
+        } gc;
+        struct
+        {
+            fds_header_t          header;       // The header being written (marker, then records).
+            fds_record_t const  * p_records;    // The records to write.
+            uint32_t              first_id;     // The record ID of the first record.
+            uint16_t              count;        // The number of records.
+            uint16_t              current;      // The record being written.
+            uint16_t              offset;       // The offset of the record being written from the marker.
+            uint16_t              page;         // The page the flash space was reserved in.
+            uint16_t              length_words; // The size of the batch, including the marker.
+            fds_batch_step_t      step;
+        } batch;
     };
 } fds_op_t;
 
@@ -305,9 +371,48 @@ typedef struct
     uint16_t         run_count;                  // Total number of times GC was run.
     bool             do_gc_page[FDS_DATA_PAGES]; // Controls which pages to garbage collect.
     bool             resume;                     // Whether or not GC should be resumed.
+#if (FDS_GC_INCREMENTAL)
+    uint32_t         step_start;                 // The time garbage collection of the current page started.
+    uint32_t         step_duration;              // The time spent on the last page.
+#endif
+#if (FDS_GC_DIRTY_THRESHOLD > 0)
+    bool             auto_queued;                // Whether GC was started automatically and is not done yet.
+#endif
 } fds_gc_data_t;
 
 
+#if (FDS_INDEX_SIZE > 0)
+
+// Record index entry.
+typedef struct
+{
+    uint32_t const * p_record;      // The address of the record, NULL if the entry is free.
+    uint16_t         file_id;       // The file ID of the record.
+    uint16_t         record_key;    // The record key of the record.
+} fds_index_entry_t;
+
+
+typedef enum
+{
+    FDS_INDEX_STALE,        // The index must be rebuilt before it can be used.
+    FDS_INDEX_VALID,        // The index holds every valid record.
+    FDS_INDEX_UPDATING,     // A garbage collected page is being added back to the index.
+    FDS_INDEX_OVERFLOW,     // There are more valid records than the index can hold.
+                            // Searches scan flash until garbage collection frees records.
+} fds_index_state_t;
+
+
+// RAM index of valid records, hashed by file ID and record key.
+typedef struct
+{
+    fds_index_entry_t entries[FDS_INDEX_SIZE];
+    uint16_t          count;        // The number of entries in use.
+    fds_index_state_t state;
+} fds_index_t;
+
+#endif // FDS_INDEX_SIZE > 0
+
+
 // Macros to enable and disable application interrupts.
 #if defined (FDS_THREADS)
 
@@ -43,6 +43,9 @@
 #include <stdbool.h>
 #include <stdio.h>
 
+STATIC_ASSERT(HCI_TX_BUF_COUNT > 0);
+STATIC_ASSERT(IS_POWER_OF_TWO(HCI_RX_BUF_QUEUE_SIZE) && (HCI_RX_BUF_QUEUE_SIZE <= 32));
+
 /**@brief RX buffer element instance structure.
  */
 typedef struct
@@ -64,14 +67,28 @@ typedef struct
     uint32_t           free_index;                                  /**< Free position index. */
 } rx_buffer_queue_t;
 
-static bool              m_is_tx_allocated;                         /**< Boolean value to determine if the TX buffer is allocated. */
+/**@brief TX buffer pool instance structure.
+ *
+ * @details Buffers are allocated and freed in FIFO order, so the pool is a circular buffer of
+ *          buffers in flight starting at the oldest allocated buffer.
+ */
+typedef struct
+{
+    uint8_t  buffer[HCI_TX_BUF_COUNT][HCI_TX_BUF_SIZE];            /**< TX buffer memory arrays. */
+    uint32_t free_index;                                            /**< Index of the oldest allocated buffer. */
+    uint32_t in_flight;                                             /**< Number of allocated buffers. */
+} tx_buffer_pool_t;
+
+static tx_buffer_pool_t     m_tx_buffer_pool;                     /**< TX buffer pool instance. */
+static hci_mem_pool_stats_t m_stats;                             /**< Occupancy statistics. */
 static rx_buffer_elem_t  m_rx_buffer_elem_queue[HCI_RX_BUF_QUEUE_SIZE]; /**< RX buffer element instances. */
 static rx_buffer_queue_t m_rx_buffer_queue;                         /**< RX buffer queue element instance. */
 
 
 uint32_t hci_mem_pool_open(void)
 {
-    m_is_tx_allocated                      = false;
+    m_tx_buffer_pool.free_index            = 0;
+    m_tx_buffer_pool.in_flight             = 0;
     m_rx_buffer_queue.p_buffer             = m_rx_buffer_elem_queue;
     m_rx_buffer_queue.free_window_count    = HCI_RX_BUF_QUEUE_SIZE;
     m_rx_buffer_queue.free_available_count = 0;
@@ -80,6 +97,8 @@ uint32_t hci_mem_pool_open(void)
     m_rx_buffer_queue.read_index           = 0;
     m_rx_buffer_queue.free_index           = 0;
 
+    memset(&m_stats, 0, sizeof(m_stats));
+
     return NRF_SUCCESS;
 }
 
@@ -92,8 +111,6 @@ uint32_t hci_mem_pool_close(void)
 
 uint32_t hci_mem_pool_tx_alloc(void ** pp_buffer)
 {
-    static uint8_t tx_buffer[HCI_TX_BUF_SIZE];
-
     uint32_t err_code;
 
     if (pp_buffer == NULL)
@@ -101,15 +118,22 @@ uint32_t hci_mem_pool_tx_alloc(void ** pp_buffer)
         return NRF_ERROR_NULL;
     }
 
-    if (!m_is_tx_allocated)
+    if (m_tx_buffer_pool.in_flight < HCI_TX_BUF_COUNT)
     {
-            m_is_tx_allocated = true;
-            *pp_buffer        = tx_buffer;
-            err_code          = NRF_SUCCESS;
+        const uint32_t index = (m_tx_buffer_pool.free_index + m_tx_buffer_pool.in_flight) %
+                               HCI_TX_BUF_COUNT;
+
+        ++(m_tx_buffer_pool.in_flight);
+        *pp_buffer = m_tx_buffer_pool.buffer[index];
+        err_code   = NRF_SUCCESS;
+
+        m_stats.tx_in_use = m_tx_buffer_pool.in_flight;
+        m_stats.tx_peak   = MAX(m_stats.tx_peak, m_stats.tx_in_use);
     }
     else
     {
-        err_code              = NRF_ERROR_NO_MEM;
+        ++(m_stats.tx_alloc_failures);
+        err_code = NRF_ERROR_NO_MEM;
     }
 
     return err_code;
@@ -118,7 +142,13 @@ uint32_t hci_mem_pool_tx_alloc(void ** pp_buffer)
 
 uint32_t hci_mem_pool_tx_free(void)
 {
-    m_is_tx_allocated = false;
+    if (m_tx_buffer_pool.in_flight != 0)
+    {
+        --(m_tx_buffer_pool.in_flight);
+        m_tx_buffer_pool.free_index = (m_tx_buffer_pool.free_index + 1u) % HCI_TX_BUF_COUNT;
+
+        m_stats.tx_in_use = m_tx_buffer_pool.in_flight;
+    }
 
     return NRF_SUCCESS;
 }
@@ -152,6 +182,10 @@ uint32_t hci_mem_pool_rx_produce(uint32_t length, void ** pp_buffer)
             m_rx_buffer_queue.write_index =
                     (m_rx_buffer_queue.write_index + 1u) & (HCI_RX_BUF_QUEUE_SIZE - 1u);
 
+            m_stats.rx_in_use             = HCI_RX_BUF_QUEUE_SIZE -
+                                            m_rx_buffer_queue.free_window_count;
+            m_stats.rx_peak               = MAX(m_stats.rx_peak, m_stats.rx_in_use);
+
             err_code                      = NRF_SUCCESS;
         }
         else
@@ -161,6 +195,7 @@ uint32_t hci_mem_pool_rx_produce(uint32_t length, void ** pp_buffer)
     }
     else
     {
+        ++(m_stats.rx_produce_failures);
         err_code = NRF_ERROR_NO_MEM;
     }
 
@@ -205,6 +240,8 @@ uint32_t hci_mem_pool_rx_consume(uint8_t * p_buffer)
             ++(m_rx_buffer_queue.free_window_count);
             start_index = (consume_index + 1u) & (HCI_RX_BUF_QUEUE_SIZE - 1u);
         }
+
+        m_stats.rx_in_use = HCI_RX_BUF_QUEUE_SIZE - m_rx_buffer_queue.free_window_count;
     }
     else
     {
@@ -261,4 +298,17 @@ uint32_t hci_mem_pool_rx_extract(uint8_t ** pp_buffer, uint32_t * p_length)
 
     return err_code;
 }
+
+
+uint32_t hci_mem_pool_stats_get(hci_mem_pool_stats_t * p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    *p_stats = m_stats;
+
+    return NRF_SUCCESS;
+}
 #endif //NRF_MODULE_ENABLED(HCI_MEM_POOL)
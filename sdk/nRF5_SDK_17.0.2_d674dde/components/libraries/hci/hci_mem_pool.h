@@ -46,7 +46,8 @@
  * @brief Memory pool implementation
  *
  * Memory pool implementation, based on circular buffer data structure, which supports asynchronous
- * processing of RX data. The current default implementation supports 1 TX buffer and 4 RX buffers.
+ * processing of RX data. The number of TX and RX buffers is configurable. The default configuration provides 1 TX buffer
+ * and 4 RX buffers.
  * The memory managed by the pool is allocated from static storage instead of heap. The internal
  * design of the circular buffer implementing the RX memory layout is illustrated in the picture
  * below.
@@ -65,6 +66,7 @@
  *
  * The following compile time configuration options are available to suit various implementations:
  * - TX_BUF_SIZE TX buffer size in bytes.
+ * - TX_BUF_COUNT Number of TX buffers that can be in flight at the same time.
  * - RX_BUF_SIZE RX buffer size in bytes.
  * - RX_BUF_QUEUE_SIZE RX buffer element size.
  */
@@ -79,6 +81,22 @@
 extern "C" {
 #endif
 
+#ifndef HCI_TX_BUF_COUNT
+#define HCI_TX_BUF_COUNT 1      /**< Number of TX buffers. */
+#endif
+
+/**@brief Memory pool occupancy statistics.
+ */
+typedef struct
+{
+    uint32_t tx_in_use;           /**< Number of TX buffers currently allocated. */
+    uint32_t tx_peak;             /**< Highest number of TX buffers allocated at the same time. */
+    uint32_t tx_alloc_failures;   /**< Number of TX allocations that failed because all buffers were in flight. */
+    uint32_t rx_in_use;           /**< Number of RX buffers currently produced and not consumed. */
+    uint32_t rx_peak;             /**< Highest number of RX buffers in use at the same time. */
+    uint32_t rx_produce_failures; /**< Number of RX produce requests that failed because all buffers were in use. */
+} hci_mem_pool_stats_t;
+
 /**@brief Function for opening the module.
  *
  * @retval NRF_SUCCESS          Operation success.
@@ -158,6 +176,17 @@ uint32_t hci_mem_pool_rx_extract(uint8_t ** pp_buffer, uint32_t * p_length);
  */
 uint32_t hci_mem_pool_rx_consume(uint8_t * p_buffer);
 
+/**@brief Function for getting the occupancy statistics of the pool.
+ *
+ * Statistics are reset by @ref hci_mem_pool_open.
+ *
+ * @param[out] p_stats          Statistics.
+ *
+ * @retval NRF_SUCCESS          Operation success.
+ * @retval NRF_ERROR_NULL       Operation failure. NULL pointer supplied.
+ */
+uint32_t hci_mem_pool_stats_get(hci_mem_pool_stats_t * p_stats);
+
 
 #ifdef __cplusplus
 }
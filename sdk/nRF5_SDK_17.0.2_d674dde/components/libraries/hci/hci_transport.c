@@ -45,6 +45,7 @@
 #include "hci_mem_pool.h"
 #include "app_timer.h"
 #include "app_error.h"
+#include "app_util_platform.h"
 #include <stdio.h>
 
 #define PKT_HDR_SIZE                    4u                                                                 /**< Packet header size in number of bytes. */
@@ -69,6 +70,7 @@
 typedef enum
 {
     TX_STATE_IDLE,                                                   /**< State for: no application transmission packet processing in progress. */
+    TX_STATE_RESERVED,                                               /**< State for: application packet is being prepared for transmission by @ref hci_transport_pkt_write, which queues further packets. */
     TX_STATE_PENDING,                                                /**< State for: TX in progress in slip layer and TX-done event is waited for to signal the end of transmission. */
     TX_STATE_ACTIVE                                                  /**< State for: application packet has been delivered to slip for transmission and peer transport entity acknowledgement packet is waited for. */
 } tx_state_t;
@@ -83,6 +85,7 @@ typedef enum
 } tx_event_t;
 
 static void tx_sm_state_change(tx_state_t new_state);
+static uint32_t pkt_write_handle(void);
 
 static tx_state_t                      m_tx_state;                   /**< Current TX state. */
 static hci_transport_tx_done_handler_t m_transport_tx_done_handle;   /**< TX done event callback function. */
@@ -98,6 +101,18 @@ static uint32_t                        m_tx_retry_counter;           /**< Applic
 static hci_transport_tx_done_result_t  m_tx_done_result_code;        /**< TX done event callback function result code. */
 static uint8_t                         m_rx_ack_buffer[ACK_BUF_SIZE];/**< RX buffer big enough to hold an acknowledgement packet and which is taken in use upon receiving  HCI_SLIP_RX_OVERFLOW event. */
 
+/**@brief Application packet waiting for the packet in transmission to be acknowledged.
+ */
+typedef struct
+{
+    uint8_t * p_buffer;                                              /**< Packet data. */
+    uint16_t  length;                                                /**< Packet data length in bytes. */
+} tx_queue_elem_t;
+
+static tx_queue_elem_t                 m_tx_queue[HCI_TX_BUF_COUNT]; /**< Queue of packets written while another packet is in transmission. */
+static uint32_t                        m_tx_queue_read_index;        /**< Index of the oldest packet in the queue. */
+static uint32_t                        m_tx_queue_count;             /**< Number of packets in the queue. */
+
 
 /**@brief Function for validating a received packet.
  *
@@ -407,6 +422,19 @@ static void tx_sm_event_handle(tx_event_t event)
                 {
                     m_transport_tx_done_handle(m_tx_done_result_code);
                 }
+
+                // Start transmission of the next queued packet unless the TX-done handler has
+                // already written a new one.
+                if ((m_tx_state == TX_STATE_IDLE) && (m_tx_queue_count != 0))
+                {
+                    mp_tx_buffer          = m_tx_queue[m_tx_queue_read_index].p_buffer;
+                    m_tx_buffer_length    = m_tx_queue[m_tx_queue_read_index].length;
+                    m_tx_queue_read_index = (m_tx_queue_read_index + 1u) % HCI_TX_BUF_COUNT;
+                    --m_tx_queue_count;
+
+                    err_code = pkt_write_handle();
+                    APP_ERROR_CHECK(err_code);
+                }
             }
             break;
 
@@ -615,6 +643,8 @@ uint32_t hci_transport_open(void)
     m_packet_expected_seq_number = INITIAL_ACK_NUMBER_EXPECTED;
     m_packet_transmit_seq_number = INITIAL_ACK_NUMBER_TX;
     m_tx_done_result_code        = HCI_TRANSPORT_TX_DONE_FAILURE;
+    m_tx_queue_read_index        = 0;
+    m_tx_queue_count             = 0;
 
     uint32_t err_code = app_timer_create(&m_app_timer_id,
                                          APP_TIMER_MODE_REPEATED,
@@ -700,7 +730,8 @@ static __INLINE uint8_t tx_packet_byte_zero_construct(void)
 }
 
 
-/**@brief Function for handling the application packet write request in tx-idle state.
+/**@brief Function for handling the application packet write request in tx-idle or tx-reserved
+ *        state.
  */
 static uint32_t pkt_write_handle(void)
 {
@@ -748,17 +779,60 @@ uint32_t hci_transport_pkt_write(const uint8_t * p_buffer, uint16_t length)
 
     if (p_buffer)
     {
-        switch (m_tx_state)
+        uint8_t * p_tx_buffer = NULL;
+        uint16_t  tx_length   = 0;
+
+        // The acknowledgement of the packet in transmission moves the TX state machine to idle
+        // from interrupt context, which sends the head of the queue. Check the state and queue
+        // the packet atomically, so that it is not queued after the queue was found empty.
+        // Only the state and the queue are updated here. The transmitter is reserved, so that
+        // packets written meanwhile are queued, and the packet is built and sent outside the
+        // critical region.
+        CRITICAL_REGION_ENTER();
+        if ((m_tx_state == TX_STATE_IDLE) && (m_tx_queue_count == 0))
+        {
+            p_tx_buffer = (uint8_t *)p_buffer;
+            tx_length   = length;
+            m_tx_state  = TX_STATE_RESERVED;
+            err_code    = NRF_SUCCESS;
+        }
+        else if ((m_tx_queue_count + 1u) < HCI_TX_BUF_COUNT)
         {
-            case TX_STATE_IDLE:
-                mp_tx_buffer       = (uint8_t *)p_buffer;
-                m_tx_buffer_length = length;
-                err_code = pkt_write_handle();
-                break;
-
-            default:
-                err_code = NRF_ERROR_NO_MEM;
-                break;
+            // Another packet is in transmission: queue this one, it is sent as soon as all
+            // packets before it are acknowledged.
+            const uint32_t index = (m_tx_queue_read_index + m_tx_queue_count) % HCI_TX_BUF_COUNT;
+
+            m_tx_queue[index].p_buffer = (uint8_t *)p_buffer;
+            m_tx_queue[index].length   = length;
+            ++m_tx_queue_count;
+            err_code = NRF_SUCCESS;
+
+            if (m_tx_state == TX_STATE_IDLE)
+            {
+                // A previous write failed with packets queued behind it: send the oldest one.
+                p_tx_buffer           = m_tx_queue[m_tx_queue_read_index].p_buffer;
+                tx_length             = m_tx_queue[m_tx_queue_read_index].length;
+                m_tx_queue_read_index = (m_tx_queue_read_index + 1u) % HCI_TX_BUF_COUNT;
+                --m_tx_queue_count;
+                m_tx_state            = TX_STATE_RESERVED;
+            }
+        }
+        else
+        {
+            err_code = NRF_ERROR_NO_MEM;
+        }
+        CRITICAL_REGION_EXIT();
+
+        if (p_tx_buffer != NULL)
+        {
+            mp_tx_buffer       = p_tx_buffer;
+            m_tx_buffer_length = tx_length;
+            err_code = pkt_write_handle();
+            if (err_code != NRF_SUCCESS)
+            {
+                // Packets queued meanwhile are sent by the next write.
+                m_tx_state = TX_STATE_IDLE;
+            }
         }
     }
     else
@@ -59,7 +59,9 @@
  * \par Implementation specific behaviour
  * - As Link establishment procedure is not supported following static link configuration parameters
  * are used:
- * + TX window size is 1.
+ * + TX window size is 1. Up to HCI_TX_BUF_COUNT application packets can be written at the same
+ * time: packets written while another packet waits for acknowledgement are queued and sent
+ * back-to-back as acknowledgements arrive, without waiting for the application.
  * + 16 bit CCITT-CRC must be used.
  * + Out of frame software flow control not supported.
  * + Parameters specific for resending reliable packets are compile time configurable (clarifed
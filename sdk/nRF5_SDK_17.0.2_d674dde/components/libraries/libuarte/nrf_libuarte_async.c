@@ -38,6 +38,7 @@
  *
  */
 #include "sdk_config.h"
+#include <string.h>
 #include "nrf_libuarte_async.h"
 #include "app_error.h"
 #include "nrf_balloc.h"
@@ -167,10 +168,56 @@ static uint32_t app_timer_us_to_ticks(uint32_t us)
                       1000000);
 }
 
-static bool rx_buffer_schedule(const nrf_libuarte_async_t * p_libuarte)
+/* @brief Function returns index of the RX buffer which contains given data. */
+static uint32_t rx_buf_idx_get(const nrf_libuarte_async_t * p_libuarte, uint8_t const * p_data)
+{
+    uint32_t idx = ((size_t)p_data - (size_t)p_libuarte->p_rx_pool->p_memory_begin) /
+                   p_libuarte->p_rx_pool->block_size;
+
+    ASSERT(idx < p_libuarte->rx_buf_cnt);
+    return idx;
+}
+
+/* @brief Function returns RX buffer (as allocated from the pool) with given index. */
+static uint8_t * rx_buf_get(const nrf_libuarte_async_t * p_libuarte, uint32_t idx)
+{
+    uint8_t * p_buf = (uint8_t *)p_libuarte->p_rx_pool->p_memory_begin +
+                      idx * p_libuarte->p_rx_pool->block_size;
+#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
+    p_buf += sizeof(uint32_t) *
+             NRF_BALLOC_DEBUG_HEAD_GUARD_WORDS_GET(p_libuarte->p_rx_pool->debug_flags);
+#endif
+    return p_buf;
+}
+
+/* @brief Function allocates RX buffer. Buffer is owned by the library until all its data is
+ * freed by @ref nrf_libuarte_async_rx_free and all references taken by
+ * @ref nrf_libuarte_async_rx_hold are released.
+ */
+static uint8_t * rx_buf_alloc(const nrf_libuarte_async_t * p_libuarte)
 {
+    nrf_libuarte_async_ctrl_blk_t * p_ctrl_blk = p_libuarte->p_ctrl_blk;
     uint8_t * p_data = nrf_balloc_alloc(p_libuarte->p_rx_pool);
 
+    if (p_data == NULL)
+    {
+        return NULL;
+    }
+
+    UNUSED_RETURN_VALUE(nrf_atomic_u32_store(&p_libuarte->p_rx_refs[rx_buf_idx_get(p_libuarte, p_data)], 1));
+    p_ctrl_blk->alloc_cnt++;
+    if ((uint32_t)p_ctrl_blk->alloc_cnt > p_ctrl_blk->stats.rx_buf_peak)
+    {
+        p_ctrl_blk->stats.rx_buf_peak = p_ctrl_blk->alloc_cnt;
+    }
+
+    return p_data;
+}
+
+static bool rx_buffer_schedule(const nrf_libuarte_async_t * p_libuarte)
+{
+    uint8_t * p_data = rx_buf_alloc(p_libuarte);
+
     if (p_data == NULL)
     {
         return false;
@@ -183,7 +230,6 @@ static bool rx_buffer_schedule(const nrf_libuarte_async_t * p_libuarte)
         return false;
     }
 
-    p_libuarte->p_ctrl_blk->alloc_cnt++;
     nrf_libuarte_drv_rx_buf_rsp(p_libuarte->p_libuarte, p_data, p_libuarte->rx_buf_size);
 
     return true;
@@ -199,6 +245,7 @@ static void uart_evt_handler(void * context, nrf_libuarte_drv_evt_t * p_evt)
     case NRF_LIBUARTE_DRV_EVT_TX_DONE:
     {
         NRF_LOG_DEBUG("(evt) TX completed (%d)", p_evt->data.rxtx.length);
+        p_libuarte->p_ctrl_blk->stats.tx_bytes += p_evt->data.rxtx.length;
         nrf_libuarte_async_evt_t evt = {
             .type = NRF_LIBUARTE_ASYNC_EVT_TX_DONE,
             .data = {
@@ -223,6 +270,7 @@ static void uart_evt_handler(void * context, nrf_libuarte_drv_evt_t * p_evt)
             if (p_libuarte->p_ctrl_blk->hwfc)
             {
                 p_libuarte->p_ctrl_blk->rx_halted = true;
+                p_libuarte->p_ctrl_blk->stats.rx_halt_count++;
             }
             else
             {
@@ -239,6 +287,8 @@ static void uart_evt_handler(void * context, nrf_libuarte_drv_evt_t * p_evt)
         if (rx_amount)
         {
             p_libuarte->p_ctrl_blk->rx_count += rx_amount;
+            p_libuarte->p_ctrl_blk->stats.rx_bytes += rx_amount;
+            p_libuarte->p_ctrl_blk->stats.rx_events++;
             nrf_libuarte_async_evt_t evt = {
                 .type = NRF_LIBUARTE_ASYNC_EVT_RX_DATA,
                 .data = {
@@ -293,6 +343,8 @@ static void uart_evt_handler(void * context, nrf_libuarte_drv_evt_t * p_evt)
         NRF_LOG_WARNING("Overrun error - data loss due to UARTE interrupt not handled on time.");
         uint32_t rx_amount = p_evt->data.overrun_err.overrun_length - p_libuarte->p_ctrl_blk->sub_rx_count;
         p_libuarte->p_ctrl_blk->rx_count += rx_amount;
+        p_libuarte->p_ctrl_blk->stats.overrun_bytes += p_evt->data.overrun_err.overrun_length;
+        p_libuarte->p_ctrl_blk->stats.overrun_count++;
         nrf_libuarte_async_evt_t evt = {
             .type = NRF_LIBUARTE_ASYNC_EVT_OVERRUN_ERROR,
             .data = {
@@ -333,6 +385,9 @@ void nrf_libuarte_async_timeout_handler(const nrf_libuarte_async_t * p_libuarte)
 
         p_libuarte->p_ctrl_blk->sub_rx_count += rx_amount;
         p_libuarte->p_ctrl_blk->rx_count = capt_rx_count;
+        p_libuarte->p_ctrl_blk->stats.rx_bytes += rx_amount;
+        p_libuarte->p_ctrl_blk->stats.rx_events++;
+        p_libuarte->p_ctrl_blk->stats.rx_timeouts++;
         p_libuarte->p_ctrl_blk->evt_handler(p_libuarte->p_ctrl_blk->context, &evt);
     }
 
@@ -413,6 +468,7 @@ ret_code_t nrf_libuarte_async_init(const nrf_libuarte_async_t * const p_libuarte
     p_libuarte->p_ctrl_blk->timeout_us = p_config->timeout_us;
     p_libuarte->p_ctrl_blk->rx_halted = false;
     p_libuarte->p_ctrl_blk->hwfc = (p_config->hwfc == NRF_UARTE_HWFC_ENABLED);
+    memset(&p_libuarte->p_ctrl_blk->stats, 0, sizeof(p_libuarte->p_ctrl_blk->stats));
 
     uint32_t i;
 
@@ -589,8 +645,7 @@ void nrf_libuarte_async_uninit(const nrf_libuarte_async_t * const p_libuarte)
 void nrf_libuarte_async_enable(const nrf_libuarte_async_t * const p_libuarte)
 {
     uint8_t * p_data;
-    p_data = nrf_balloc_alloc(p_libuarte->p_rx_pool);
-    p_libuarte->p_ctrl_blk->alloc_cnt++;
+    p_data = rx_buf_alloc(p_libuarte);
     if (p_data == NULL)
     {
         APP_ERROR_CHECK_BOOL(false);
@@ -632,40 +687,144 @@ ret_code_t nrf_libuarte_async_tx(const nrf_libuarte_async_t * const p_libuarte,
     return nrf_libuarte_drv_tx(p_libuarte->p_libuarte, p_data, length);
 }
 
+/* @brief Function drops a reference to the RX buffer and returns the buffer to the pool if it
+ * was the last one.
+ */
+static void rx_buf_put(const nrf_libuarte_async_t * p_libuarte, uint32_t idx)
+{
+    if (nrf_atomic_u32_sub(&p_libuarte->p_rx_refs[idx], 1) != 0)
+    {
+        return;
+    }
+
+    uint8_t * p_buf = rx_buf_get(p_libuarte, idx);
+
+    /* Buffer may be released from a context other than UARTE interrupt. */
+    CRITICAL_REGION_ENTER();
+
+    nrf_balloc_free(p_libuarte->p_rx_pool, p_buf);
+
+    p_libuarte->p_ctrl_blk->alloc_cnt--;
+    if (p_libuarte->p_ctrl_blk->alloc_cnt<0)
+    {
+        NRF_LOG_ERROR("Freeing more RX buffers than allocated.");
+        APP_ERROR_CHECK_BOOL(false);
+    }
+    NRF_LOG_INFO("Freeing full buffer 0x%08X, (currently allocated:%d).", p_buf, p_libuarte->p_ctrl_blk->alloc_cnt);
+
+    if (p_libuarte->p_ctrl_blk->rx_halted)
+    {
+        bool ret = rx_buffer_schedule(p_libuarte);
+        ASSERT(ret);
+        p_libuarte->p_ctrl_blk->rx_halted = false;
+    }
+
+    CRITICAL_REGION_EXIT();
+}
+
 void nrf_libuarte_async_rx_free(const nrf_libuarte_async_t * const p_libuarte, uint8_t * p_data, size_t length)
 {
     p_libuarte->p_ctrl_blk->rx_free_cnt += length;
     if (p_libuarte->p_ctrl_blk->rx_free_cnt == p_libuarte->rx_buf_size)
     {
-        p_data -= (p_libuarte->p_ctrl_blk->rx_free_cnt - length);
         p_libuarte->p_ctrl_blk->rx_free_cnt = 0;
-        nrf_balloc_free(p_libuarte->p_rx_pool, p_data);
+        rx_buf_put(p_libuarte, rx_buf_idx_get(p_libuarte, p_data));
+    }
+    else if (p_libuarte->p_ctrl_blk->rx_free_cnt > p_libuarte->rx_buf_size)
+    {
+        NRF_LOG_ERROR("Unexpected RX free input parameter.");
+        APP_ERROR_CHECK_BOOL(false);
+    }
+    else
+    {
+        NRF_LOG_INFO("Freeing partial buffer: 0x%08X, length:%d", p_data, length);
+    }
+
+}
+
+void nrf_libuarte_async_rx_hold(const nrf_libuarte_async_t * const p_libuarte, uint8_t const * p_data)
+{
+    uint32_t idx = rx_buf_idx_get(p_libuarte, p_data);
+
+    ASSERT(p_libuarte->p_rx_refs[idx] != 0);
+    UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&p_libuarte->p_rx_refs[idx], 1));
+}
+
+void nrf_libuarte_async_rx_release(const nrf_libuarte_async_t * const p_libuarte, uint8_t const * p_data)
+{
+    rx_buf_put(p_libuarte, rx_buf_idx_get(p_libuarte, p_data));
+}
 
-        p_libuarte->p_ctrl_blk->alloc_cnt--;
-        if (p_libuarte->p_ctrl_blk->alloc_cnt<0)
+ret_code_t nrf_libuarte_async_timeout_set(const nrf_libuarte_async_t * const p_libuarte, uint32_t timeout_us)
+{
+    if (p_libuarte->p_ctrl_blk->enabled == false)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_libuarte->p_rtc && RTC_IN_USE)
+    {
+        /* RTC is running at 32768 Hz. */
+        if ((timeout_us / 32) == 0)
         {
-            NRF_LOG_ERROR("Freeing more RX buffers than allocated.");
-            APP_ERROR_CHECK_BOOL(false);
+            return NRF_ERROR_INVALID_PARAM;
         }
-        NRF_LOG_INFO("Freeing full buffer 0x%08X, %d, (currently allocated:%d).",p_data, length, p_libuarte->p_ctrl_blk->alloc_cnt);
 
-        if (p_libuarte->p_ctrl_blk->rx_halted)
+        p_libuarte->p_ctrl_blk->timeout_us = timeout_us;
+        if (nrfx_rtc_cc_set(p_libuarte->p_rtc, 0, timeout_us / 32, true) != NRFX_SUCCESS)
         {
-            bool ret = rx_buffer_schedule(p_libuarte);
-            ASSERT(ret);
-            p_libuarte->p_ctrl_blk->rx_halted = false;
+            return NRF_ERROR_INTERNAL;
         }
     }
-    else if (p_libuarte->p_ctrl_blk->rx_free_cnt > p_libuarte->rx_buf_size)
+    else if (p_libuarte->p_timer && TIMER_IN_USE)
     {
-        NRF_LOG_ERROR("Unexpected RX free input parameter.");
-        APP_ERROR_CHECK_BOOL(false);
+        if (timeout_us == 0)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+
+        p_libuarte->p_ctrl_blk->timeout_us = timeout_us;
+        nrfx_timer_compare(p_libuarte->p_timer, NRF_TIMER_CC_CHANNEL0, timeout_us, true);
     }
     else
     {
-        NRF_LOG_INFO("Freeing partial buffer: 0x%08X, length:%d", p_data, length);
+        if (timeout_us == 0)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+
+        p_libuarte->p_ctrl_blk->timeout_us = timeout_us;
+
+        /* Line is polled every half of the timeout, restart polling with the new period. */
+        uint32_t ticks = app_timer_us_to_ticks(timeout_us)/2;
+        ticks = MAX(APP_TIMER_MIN_TIMEOUT_TICKS, ticks);
+        if ((local_app_timer_stop(*p_libuarte->p_app_timer) != NRF_SUCCESS) ||
+            (local_app_timer_start(*p_libuarte->p_app_timer, ticks, (void *)p_libuarte) != NRF_SUCCESS))
+        {
+            return NRF_ERROR_INTERNAL;
+        }
     }
 
+    NRF_LOG_INFO("RX timeout set to %d us.", timeout_us);
+    return NRF_SUCCESS;
+}
+
+void nrf_libuarte_async_stats_get(const nrf_libuarte_async_t * const p_libuarte,
+                                  nrf_libuarte_async_stats_t * p_stats)
+{
+    ASSERT(p_stats);
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = p_libuarte->p_ctrl_blk->stats;
+    CRITICAL_REGION_EXIT();
+}
+
+void nrf_libuarte_async_stats_reset(const nrf_libuarte_async_t * const p_libuarte)
+{
+    CRITICAL_REGION_ENTER();
+    memset(&p_libuarte->p_ctrl_blk->stats, 0, sizeof(p_libuarte->p_ctrl_blk->stats));
+    p_libuarte->p_ctrl_blk->stats.rx_buf_peak = p_libuarte->p_ctrl_blk->alloc_cnt;
+    CRITICAL_REGION_EXIT();
 }
 
 void nrf_libuarte_async_rts_clear(const nrf_libuarte_async_t * const p_libuarte)
@@ -43,6 +43,7 @@
 #include "sdk_errors.h"
 #include "nrf_balloc.h"
 #include "nrf_queue.h"
+#include "nrf_atomic.h"
 #include "nrfx_ppi.h"
 #include "nrfx_timer.h"
 #include "nrfx_rtc.h"
@@ -55,6 +56,18 @@
  *
  * @brief Module for reliable communication over UARTE.
  *
+ * @details Data is received by DMA directly into buffers from the RX pool. Buffers are chained
+ *          by PPI (ENDRX triggers STARTRX), so reception continues without CPU intervention as
+ *          long as the next buffer is provided before the current one is filled. Received data is
+ *          passed to the application in place with @ref NRF_LIBUARTE_ASYNC_EVT_RX_DATA and must
+ *          be returned with @ref nrf_libuarte_async_rx_free in the order it was received.
+ *
+ *          A consumer that processes data later (for example a CLI, SLIP or logger backend) can
+ *          take a reference to the RX buffer with @ref nrf_libuarte_async_rx_hold instead of
+ *          copying the data. Such a buffer stays allocated, even after all its data has been
+ *          freed with @ref nrf_libuarte_async_rx_free, until every reference is dropped with
+ *          @ref nrf_libuarte_async_rx_release. References can be dropped in any order.
+ *
  * @{
  */
 
@@ -131,6 +144,19 @@ typedef struct
     uint8_t              int_prio;   ///< Interrupt priority of UARTE (RTC, TIMER have int_prio - 1)
 } nrf_libuarte_async_config_t;
 
+/** @brief Structure for libuarte async statistics. */
+typedef struct
+{
+    uint32_t rx_bytes;       ///< Number of bytes passed to the application.
+    uint32_t rx_events;      ///< Number of @ref NRF_LIBUARTE_ASYNC_EVT_RX_DATA events.
+    uint32_t rx_timeouts;    ///< Number of RX events triggered by the receiver timeout.
+    uint32_t tx_bytes;       ///< Number of bytes transmitted.
+    uint32_t overrun_bytes;  ///< Number of bytes lost due to overrun.
+    uint32_t overrun_count;  ///< Number of overrun errors.
+    uint32_t rx_halt_count;  ///< Number of times RX was halted due to lack of RX buffers.
+    uint32_t rx_buf_peak;    ///< Maximum number of RX buffers allocated at the same time.
+} nrf_libuarte_async_stats_t;
+
 /**
  * @brief nrf_libuarte_async control block (placed in RAM).
  */
@@ -148,6 +174,7 @@ typedef struct {
     bool hwfc;
     bool rx_halted;
     bool enabled;
+    nrf_libuarte_async_stats_t stats;
 } nrf_libuarte_async_ctrl_blk_t;
 
 typedef struct {
@@ -172,8 +199,10 @@ typedef struct {
 	nrf_libuarte_app_timer_ctrl_blk_t * p_app_timer_ctrl_blk;
 	const nrf_libuarte_drv_t * p_libuarte;
 	nrf_libuarte_async_ctrl_blk_t * p_ctrl_blk;
+	nrf_atomic_u32_t * p_rx_refs;
 	nrfx_rtc_handler_t rtc_handler;
 	uint32_t rx_buf_size;
+	uint32_t rx_buf_cnt;
 } nrf_libuarte_async_t;
 
 void nrf_libuarte_async_timeout_handler(const nrf_libuarte_async_t * p_libuarte);
@@ -229,7 +258,11 @@ void nrf_libuarte_async_timeout_handler(const nrf_libuarte_async_t * p_libuarte)
  *                     _rx_buf_size bytes is received.
  * @param _rx_buf_cnt  Number of buffers in the RX buffer pool. Size impacts accepted latency
  *                     between NRF_LIBUARTE_ASYNC_EVT_RX_DATA event and
- *                     @ref nrf_libuarte_async_rx_free.
+ *                     @ref nrf_libuarte_async_rx_free. Buffers held with
+ *                     @ref nrf_libuarte_async_rx_hold are not available for reception.
+ *
+ * @note At 1 Mbaud a buffer of 255 bytes is filled in about 2.5 ms. The pool must cover the
+ *       time the application needs to process and release the received data.
  */
 #define NRF_LIBUARTE_ASYNC_DEFINE(_name, _uarte_idx, _timer0_idx,\
                                   _rtc1_idx, _timer1_idx,\
@@ -261,6 +294,7 @@ void nrf_libuarte_async_timeout_handler(const nrf_libuarte_async_t * p_libuarte)
                    nrf_libuarte_app_timer_ctrl_blk_t CONCAT_2(_name,_app_timer_ctrl_blk);))) \
       )\
       static nrf_libuarte_async_ctrl_blk_t CONCAT_2(_name, ctrl_blk);\
+      static nrf_atomic_u32_t CONCAT_2(_name, _rx_refs)[_rx_buf_cnt];\
       _LIBUARTE_ASYNC_EVAL(\
               NRFX_CONCAT_3(NRFX_RTC, _rtc1_idx, _ENABLED), \
               (static void CONCAT_2(_name, _rtc_handler)(nrfx_rtc_int_type_t int_type);),\
@@ -286,7 +320,9 @@ void nrf_libuarte_async_timeout_handler(const nrf_libuarte_async_t * p_libuarte)
 	            ),\
               .p_libuarte = &CONCAT_2(_name, _libuarte),\
               .p_ctrl_blk = &CONCAT_2(_name, ctrl_blk),\
+              .p_rx_refs = CONCAT_2(_name, _rx_refs),\
               .rx_buf_size = _rx_buf_size,\
+              .rx_buf_cnt = _rx_buf_cnt,\
               _LIBUARTE_ASYNC_EVAL(\
                   NRFX_CONCAT_3(NRFX_RTC, _rtc1_idx, _ENABLED),\
                   (.rtc_handler =CONCAT_2(_name, _rtc_handler)),\
@@ -380,6 +416,67 @@ ret_code_t nrf_libuarte_async_tx(const nrf_libuarte_async_t * const p_libuarte,
 void nrf_libuarte_async_rx_free(const nrf_libuarte_async_t * const p_libuarte,
                                 uint8_t * p_data, size_t length);
 
+/**
+ * @brief Function for taking a reference to the RX buffer that contains received data.
+ *
+ * The buffer is not returned to the RX pool until the reference is dropped with
+ * @ref nrf_libuarte_async_rx_release, so the data can be processed in place after it was freed
+ * with @ref nrf_libuarte_async_rx_free. Buffer can be referenced multiple times.
+ *
+ * @param[in] p_libuarte Libuarte_async instance.
+ * @param[in] p_data     Pointer to any byte of data from @ref NRF_LIBUARTE_ASYNC_EVT_RX_DATA
+ *                       event that was not yet freed or is held.
+ */
+void nrf_libuarte_async_rx_hold(const nrf_libuarte_async_t * const p_libuarte,
+                                uint8_t const * p_data);
+
+/**
+ * @brief Function for dropping a reference taken with @ref nrf_libuarte_async_rx_hold.
+ *
+ * Can be called from any context. If it was the last reference and all the data from the buffer
+ * was freed, the buffer is returned to the RX pool.
+ *
+ * @param[in] p_libuarte Libuarte_async instance.
+ * @param[in] p_data     Pointer to any byte of data from the held buffer.
+ */
+void nrf_libuarte_async_rx_release(const nrf_libuarte_async_t * const p_libuarte,
+                                   uint8_t const * p_data);
+
+/**
+ * @brief Function for changing the receiver timeout.
+ *
+ * Received data is passed to the application when the line is idle for the given time. Shorter
+ * timeout reduces latency, longer one reduces the number of events at high data rates. New
+ * timeout is applied starting from the next received byte.
+ *
+ * @param[in] p_libuarte Libuarte_async instance.
+ * @param[in] timeout_us Receiver timeout in us unit.
+ *
+ * @retval NRF_SUCCESS             Timeout changed.
+ * @retval NRF_ERROR_INVALID_PARAM Timeout is shorter than the resolution of the timer used.
+ * @retval NRF_ERROR_INVALID_STATE Library is not initialized.
+ */
+ret_code_t nrf_libuarte_async_timeout_set(const nrf_libuarte_async_t * const p_libuarte,
+                                          uint32_t timeout_us);
+
+/**
+ * @brief Function for getting the statistics of the instance.
+ *
+ * @param[in]  p_libuarte Libuarte_async instance.
+ * @param[out] p_stats    Statistics.
+ */
+void nrf_libuarte_async_stats_get(const nrf_libuarte_async_t * const p_libuarte,
+                                  nrf_libuarte_async_stats_t * p_stats);
+
+/**
+ * @brief Function for resetting the statistics of the instance.
+ *
+ * Peak buffer usage restarts from the current number of allocated buffers.
+ *
+ * @param[in] p_libuarte Libuarte_async instance.
+ */
+void nrf_libuarte_async_stats_reset(const nrf_libuarte_async_t * const p_libuarte);
+
 /** @} */
 
 #endif //UART_ASYNC_H
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2016 - 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+ /**@file
+ *
+ * @defgroup nrf_log_backend_cdc_acm Log USB CDC ACM backend
+ * @{
+ * @ingroup  nrf_log
+ * @brief Log USB CDC ACM backend.
+ *
+ * @details The backend does not format log entries. Each entry is queued on the CDC ACM port
+ *          as it is stored by the logger (header, arguments or hexdump data) with
+ *          @ref app_usbd_cdc_acm_write_memobj, so no temporary string buffer is needed and the
+ *          entry memory is released once the USB transfer completes. Format strings are sent as
+ *          addresses and must be resolved on the host using the application ELF file, for example
+ *          with the @c nrf_log_decode.py tool (see @c external_tools/nrf_log_decoder).
+ *
+ *          Entries are dropped if the port is closed or its transmit queue is full.
+ *
+ * @note Logs of the CDC ACM class and of the USB stack must be disabled when this backend is used,
+ *       otherwise every transfer generates new log entries.
+ */
+
+#ifndef NRF_LOG_BACKEND_CDC_ACM_H
+#define NRF_LOG_BACKEND_CDC_ACM_H
+
+#include "nrf_log_backend_interface.h"
+#include "app_usbd_cdc_acm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const nrf_log_backend_api_t nrf_log_backend_cdc_acm_api;
+
+/**@brief CDC ACM backend context. */
+typedef struct
+{
+    app_usbd_cdc_acm_t const * p_cdc_acm; //!< CDC ACM instance used for the transfer.
+    uint32_t                   dropped;   //!< Number of entries that could not be queued.
+    bool                       panic;     //!< Panic mode: entries are dropped.
+} nrf_log_backend_cdc_acm_ctx_t;
+
+/**@brief Macro for creating a CDC ACM backend instance.
+ *
+ * @param _name      Name of the backend instance.
+ * @param _p_cdc_acm Pointer to the CDC ACM class instance used by the backend.
+ */
+#define NRF_LOG_BACKEND_CDC_ACM_DEF(_name, _p_cdc_acm)                       \
+    static nrf_log_backend_cdc_acm_ctx_t CONCAT_2(_name, _ctx) =             \
+    {                                                                        \
+        .p_cdc_acm = _p_cdc_acm                                              \
+    };                                                                       \
+    NRF_LOG_BACKEND_DEF(_name, nrf_log_backend_cdc_acm_api, &CONCAT_2(_name, _ctx))
+
+/**@brief Function for getting the number of entries dropped by the backend.
+ *
+ * @param p_backend Pointer to the backend instance.
+ *
+ * @return Number of dropped entries.
+ */
+uint32_t nrf_log_backend_cdc_acm_dropped_get(nrf_log_backend_t const * p_backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //NRF_LOG_BACKEND_CDC_ACM_H
+
+/** @} */
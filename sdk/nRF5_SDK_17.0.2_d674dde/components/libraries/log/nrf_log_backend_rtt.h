@@ -44,6 +44,13 @@
  * @{
  * @ingroup  nrf_log
  * @brief Log RTT backend.
+ *
+ * @details If @c NRF_LOG_BACKEND_RTT_BINARY is set, entries are not formatted on the device but
+ *          written to RTT in binary form, as stored by the logger. They are decoded on the host
+ *          with the @c nrf_log_decode.py tool (see @c external_tools/nrf_log_decoder), which
+ *          resolves format strings and module names from the application ELF file.
+ *          @c NRF_LOG_BACKEND_RTT_TEMP_BUFFER_SIZE must then fit the largest entry; longer
+ *          hexdumps are truncated.
  */
 
 #ifndef NRF_LOG_BACKEND_RTT_H
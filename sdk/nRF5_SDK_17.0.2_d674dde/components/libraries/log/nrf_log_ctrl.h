@@ -216,6 +216,40 @@ nrf_log_severity_t nrf_log_module_filter_get(uint32_t backend_id,
                                              bool     is_ordered_idx,
                                              bool     dynamic);
 
+/**
+ * @brief Function for configuring rate limiting and sampling of logs in the module.
+ *
+ * Rate limiting uses a token bucket: up to @p burst entries can be logged at once, and the bucket
+ * refills at @p rate entries per second, measured with the timestamp function given to
+ * @ref nrf_log_init. Sampling logs only one in @p sample entries. Both apply to all backends and
+ * are checked before an entry is put into the buffer. Errors are never suppressed.
+ *
+ * The configuration is part of the filtering configuration, see @ref nrf_log_config_store.
+ *
+ * @note Only available if @c NRF_LOG_RATE_LIMIT_ENABLED is set.
+ *
+ * @param module_id Module ID.
+ * @param rate      Maximum sustained rate in entries per second, or 0 for no limit.
+ * @param burst     Maximum number of entries logged in a burst.
+ * @param sample    Log one in this number of entries, or 0 to log all.
+ */
+void nrf_log_module_rate_limit_set(uint32_t module_id,
+                                   uint16_t rate,
+                                   uint16_t burst,
+                                   uint16_t sample);
+
+/**
+ * @brief Function for getting the number of entries suppressed by rate limiting or sampling.
+ *
+ * @note Only available if @c NRF_LOG_RATE_LIMIT_ENABLED is set.
+ *
+ * @param module_id      Module ID.
+ * @param is_ordered_idx Module ID is given is index in alphabetically sorted list of modules.
+ *
+ * @return Number of suppressed entries.
+ */
+uint32_t nrf_log_module_suppressed_get(uint32_t module_id, bool is_ordered_idx);
+
 /**
  * @brief Function stores current filtering configuration into non-volatile memory using @ref fds module.
  *
@@ -41,6 +41,7 @@
 #define NRF_LOG_TYPES_H
 
 #include <stdint.h>
+#include "sdk_common.h"
 
 /**
  * @brief Logger severity levels.
@@ -64,6 +65,12 @@ typedef struct
 {
     uint16_t     order_idx;     ///< Ordered index of the module (used for auto-completion).
     uint16_t     filter;        ///< Current highest severity level accepted (redundant to @ref nrf_log_module_filter_data_t::filter_lvls, used for optimization)
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    uint32_t     rate_stamp;    ///< Timestamp of the last rate limit token refill.
+    uint16_t     tokens;        ///< Number of entries that can be logged before rate limiting applies.
+    uint16_t     sample_cnt;    ///< Number of entries skipped since the last sampled entry.
+    uint32_t     suppressed;    ///< Number of entries suppressed by rate limiting or sampling.
+#endif
 } nrf_log_module_dynamic_data_t;
 
 /**
@@ -74,6 +81,12 @@ typedef struct
 typedef struct
 {
     uint32_t     filter_lvls;   ///< Current severity levels for each backend (3 bits per backend).
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    uint16_t     rate;          ///< Maximum sustained rate in entries per second (0 if not limited).
+    uint16_t     burst;         ///< Maximum number of entries logged in a burst.
+    uint16_t     sample;        ///< Only one in this number of entries is logged (0 or 1 to log all).
+    uint16_t     reserved;      ///< Reserved.
+#endif
 } nrf_log_module_filter_data_t;
 
 /**
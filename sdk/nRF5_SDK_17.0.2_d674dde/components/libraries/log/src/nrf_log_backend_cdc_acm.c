@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2016 - 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_BACKEND_CDC_ACM)
+#include "nrf_log_backend_cdc_acm.h"
+#include "nrf_log_internal.h"
+
+/**@brief Function for getting the number of bytes the logger stored for an entry. */
+static size_t entry_size_get(nrf_log_entry_t * p_msg)
+{
+    nrf_log_header_t header;
+    size_t           size = HEADER_SIZE * sizeof(uint32_t);
+
+    nrf_memobj_read(p_msg, &header, size, 0);
+
+    if (header.base.generic.type == HEADER_TYPE_STD)
+    {
+        size += header.base.std.nargs * sizeof(uint32_t);
+    }
+    else if (header.base.generic.type == HEADER_TYPE_HEXDUMP)
+    {
+        size += header.base.hexdump.len;
+    }
+    else
+    {
+        size = 0;
+    }
+    return size;
+}
+
+static void nrf_log_backend_cdc_acm_put(nrf_log_backend_t const * p_backend,
+                                        nrf_log_entry_t * p_msg)
+{
+    nrf_log_backend_cdc_acm_ctx_t * p_ctx = p_backend->p_ctx;
+    size_t                          size  = entry_size_get(p_msg);
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    if (p_ctx->panic ||
+        (app_usbd_cdc_acm_write_memobj(p_ctx->p_cdc_acm, p_msg, 0, size) != NRF_SUCCESS))
+    {
+        p_ctx->dropped++;
+    }
+}
+
+static void nrf_log_backend_cdc_acm_flush(nrf_log_backend_t const * p_backend)
+{
+
+}
+
+static void nrf_log_backend_cdc_acm_panic_set(nrf_log_backend_t const * p_backend)
+{
+    nrf_log_backend_cdc_acm_ctx_t * p_ctx = p_backend->p_ctx;
+
+    /* USB transfers cannot complete without interrupts. */
+    p_ctx->panic = true;
+}
+
+uint32_t nrf_log_backend_cdc_acm_dropped_get(nrf_log_backend_t const * p_backend)
+{
+    nrf_log_backend_cdc_acm_ctx_t * p_ctx = p_backend->p_ctx;
+    return p_ctx->dropped;
+}
+
+const nrf_log_backend_api_t nrf_log_backend_cdc_acm_api = {
+        .put       = nrf_log_backend_cdc_acm_put,
+        .flush     = nrf_log_backend_cdc_acm_flush,
+        .panic_set = nrf_log_backend_cdc_acm_panic_set,
+};
+#endif //NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_BACKEND_CDC_ACM)
@@ -99,10 +99,47 @@ static void serial_tx(void const * p_context, char const * buffer, size_t len)
         } while (len);
     }
 }
+
+#if NRF_LOG_BACKEND_RTT_BINARY
+static void binary_tx(uint8_t const * p_data, size_t len)
+{
+    uint32_t watchdog_counter = NRF_LOG_BACKEND_RTT_TX_RETRY_CNT;
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    /* Entries are written whole or not at all, so that the host can always parse the stream.
+     * The host presence is tracked the same way as in serial_tx().
+     */
+    while (SEGGER_RTT_WriteSkipNoLock(0, p_data, len) == 0)
+    {
+        if (!m_host_present)
+        {
+            return;
+        }
+        nrf_delay_ms(NRF_LOG_BACKEND_RTT_TX_RETRY_DELAY_MS);
+        watchdog_counter--;
+        if (watchdog_counter == 0)
+        {
+            m_host_present = false;
+            return;
+        }
+    }
+    m_host_present = true;
+}
+#endif
+
 static void nrf_log_backend_rtt_put(nrf_log_backend_t const * p_backend,
                                nrf_log_entry_t * p_msg)
 {
+#if NRF_LOG_BACKEND_RTT_BINARY
+    uint32_t len = nrf_log_backend_serial_binary_get(p_msg, m_string_buff, sizeof(m_string_buff));
+    binary_tx(m_string_buff, len);
+#else
     nrf_log_backend_serial_put(p_backend, p_msg, m_string_buff, NRF_LOG_BACKEND_RTT_TEMP_BUFFER_SIZE, serial_tx);
+#endif
 }
 
 static void nrf_log_backend_rtt_flush(nrf_log_backend_t const * p_backend)
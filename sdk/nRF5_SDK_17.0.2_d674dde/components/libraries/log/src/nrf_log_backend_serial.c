@@ -113,4 +113,47 @@ void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
     nrf_memobj_put(p_msg);
     /*lint -restore*/
 }
+
+uint32_t nrf_log_backend_serial_binary_get(nrf_log_entry_t * p_msg,
+                                           uint8_t * p_buffer,
+                                           uint32_t  length)
+{
+    nrf_log_header_t header;
+    uint32_t         header_size = HEADER_SIZE*sizeof(uint32_t);
+    uint32_t         data_len;
+
+    if (length < header_size)
+    {
+        return 0;
+    }
+
+    nrf_memobj_get(p_msg);
+    nrf_memobj_read(p_msg, &header, header_size, 0);
+
+    if (header.base.generic.type == HEADER_TYPE_STD)
+    {
+        data_len = header.base.std.nargs * sizeof(uint32_t);
+    }
+    else if (header.base.generic.type == HEADER_TYPE_HEXDUMP)
+    {
+        data_len = MIN(header.base.hexdump.len, length - header_size);
+        header.base.hexdump.len = data_len;
+    }
+    else
+    {
+        data_len = length;  // Invalid entry, rejected below.
+    }
+
+    if ((header_size + data_len) > length)
+    {
+        nrf_memobj_put(p_msg);
+        return 0;
+    }
+
+    memcpy(p_buffer, &header, header_size);
+    nrf_memobj_read(p_msg, &p_buffer[header_size], data_len, header_size);
+    nrf_memobj_put(p_msg);
+
+    return header_size + data_len;
+}
 #endif //NRF_LOG_ENABLED
@@ -68,6 +68,25 @@ void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
                                uint32_t  length,
                                nrf_fprintf_fwrite tx_func);
 
+/**
+ * @brief A function for copying a logger entry in binary form, as stored by the logger.
+ *
+ * The entry (header, followed by arguments or hexdump data) is copied without formatting.
+ * Format strings are left as addresses, to be resolved on the host using the application ELF file.
+ * Hexdump data that does not fit in the buffer is truncated and the length in the copied
+ * header is updated accordingly, so that the output is always a well-formed entry.
+ *
+ * @param p_msg    Logger entry.
+ * @param p_buffer Buffer for the entry.
+ * @param length   Size of the buffer.
+ *
+ * @return Number of bytes copied, or 0 if the entry is invalid or its header and
+ *         arguments do not fit in the buffer.
+ */
+uint32_t nrf_log_backend_serial_binary_get(nrf_log_entry_t * p_msg,
+                                           uint8_t * p_buffer,
+                                           uint32_t  length);
+
 #endif //NRF_LOG_BACKEND_SERIAL_H
 
 #ifdef __cplusplus
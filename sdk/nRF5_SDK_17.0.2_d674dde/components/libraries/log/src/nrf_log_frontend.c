@@ -63,6 +63,10 @@ STATIC_ASSERT(IS_POWER_OF_TWO(NRF_LOG_BUFSIZE));
 #define LOG_CONFIG_LOAD_STORE_ENABLED 0
 #endif
 
+#if NRF_LOG_RATE_LIMIT_ENABLED && !NRF_LOG_FILTERS_ENABLED
+#error "NRF_LOG_RATE_LIMIT_ENABLED requires NRF_LOG_FILTERS_ENABLED."
+#endif
+
 #if NRF_LOG_BUF_WORDS < 32
 #warning "NRF_LOG_BUFSIZE too small, significant number of logs may be lost."
 #endif
@@ -94,10 +98,15 @@ static uint32_t m_buffer_mask =  NRF_LOG_BUF_WORDS - 1; // Size of buffer (must
 typedef struct
 {
     bool                      autoflush;
-    uint32_t                  wr_idx;          // Current write index (never reset)
+    bool                      panic;           // Set by nrf_log_panic(), never cleared
+    nrf_atomic_u32_t          wr_idx;          // Current write index (never reset)
     uint32_t                  rd_idx;          // Current read index  (never_reset)
+    nrf_atomic_u32_t          writing;         // Number of contexts writing an entry
     uint32_t                  buffer[NRF_LOG_BUF_WORDS];
     nrf_log_timestamp_func_t  timestamp_func;  // A pointer to function that returns timestamp
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    uint32_t                  timestamp_freq;  // Frequency of the timestamp, used for rate limiting
+#endif
     nrf_log_backend_t const * p_backend_head;
     nrf_atomic_flag_t         log_skipping;
     nrf_atomic_flag_t         log_skipped;
@@ -132,6 +141,12 @@ ret_code_t nrf_log_init(nrf_log_timestamp_func_t timestamp_func, uint32_t timest
         m_log_data.timestamp_func = timestamp_func;
     }
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    // Rate limiting needs a time base, even if entries are not timestamped.
+    m_log_data.timestamp_func = timestamp_func;
+    m_log_data.timestamp_freq = timestamp_freq;
+#endif
+
 #ifdef UNIT_TEST
     m_buffer_mask = NRF_LOG_BUF_WORDS - 1;
 #endif
@@ -281,6 +296,98 @@ void nrf_log_module_filter_set(uint32_t backend_id, uint32_t module_id, nrf_log_
     }
 }
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+void nrf_log_module_rate_limit_set(uint32_t module_id,
+                                   uint16_t rate,
+                                   uint16_t burst,
+                                   uint16_t sample)
+{
+    nrf_log_module_dynamic_data_t * p_module_data = NRF_LOG_DYNAMIC_SECTION_VARS_GET(module_id);
+    nrf_log_module_filter_data_t *  p_filter      = NRF_LOG_FILTER_SECTION_VARS_GET(module_id);
+
+    p_filter->rate   = rate;
+    p_filter->burst  = MAX(burst, 1);
+    p_filter->sample = sample;
+
+    p_module_data->tokens     = p_filter->burst;
+    p_module_data->sample_cnt = 0;
+    p_module_data->rate_stamp = m_log_data.timestamp_func ? m_log_data.timestamp_func() : 0;
+}
+
+uint32_t nrf_log_module_suppressed_get(uint32_t module_id, bool ordered_idx)
+{
+    if (module_idx_get(&module_id, ordered_idx) != NRF_SUCCESS)
+    {
+        return 0;
+    }
+    return NRF_LOG_DYNAMIC_SECTION_VARS_GET(module_id)->suppressed;
+}
+
+/**
+ * @brief Function for checking if an entry passes rate limiting and sampling of its module.
+ *
+ * The state is updated without locking. Entries logged by the same module at the same time from
+ * different priorities may be accounted for only once, which is acceptable for rate limiting.
+ *
+ * @param severity_mid Severity level and module ID of the entry.
+ *
+ * @return True if the entry is to be logged, false if it is suppressed.
+ */
+static bool rate_limit_check(uint32_t severity_mid)
+{
+    uint32_t                        module_id     = severity_mid >> NRF_LOG_MODULE_ID_POS;
+    nrf_log_module_dynamic_data_t * p_module_data = NRF_LOG_DYNAMIC_SECTION_VARS_GET(module_id);
+    nrf_log_module_filter_data_t *  p_filter      = NRF_LOG_FILTER_SECTION_VARS_GET(module_id);
+
+    if ((severity_mid & NRF_LOG_LEVEL_MASK) == NRF_LOG_SEVERITY_ERROR)
+    {
+        return true;
+    }
+
+    if (p_filter->sample > 1)
+    {
+        if (++p_module_data->sample_cnt < p_filter->sample)
+        {
+            p_module_data->suppressed++;
+            return false;
+        }
+        p_module_data->sample_cnt = 0;
+    }
+
+    if ((p_filter->rate != 0) && (m_log_data.timestamp_func != NULL))
+    {
+        uint32_t now             = m_log_data.timestamp_func();
+        uint32_t ticks_per_token = MAX(m_log_data.timestamp_freq / p_filter->rate, 1);
+        uint32_t new_tokens      = (now - p_module_data->rate_stamp) / ticks_per_token;
+
+        if (new_tokens > 0)
+        {
+            uint32_t tokens = p_module_data->tokens + new_tokens;
+            if (tokens >= p_filter->burst)
+            {
+                // The bucket is full: the time elapsed beyond that is not accounted.
+                p_module_data->tokens     = p_filter->burst;
+                p_module_data->rate_stamp = now;
+            }
+            else
+            {
+                p_module_data->tokens      = (uint16_t)tokens;
+                p_module_data->rate_stamp += new_tokens * ticks_per_token;
+            }
+        }
+
+        if (p_module_data->tokens == 0)
+        {
+            p_module_data->suppressed++;
+            return false;
+        }
+        p_module_data->tokens--;
+    }
+
+    return true;
+}
+#endif // NRF_LOG_RATE_LIMIT_ENABLED
+
 static nrf_log_severity_t nrf_log_module_init_filter_get(uint32_t module_id)
 {
     nrf_log_module_const_data_t * p_module_data =
@@ -442,6 +549,16 @@ static inline void std_header_set(uint32_t severity_mid,
  * @brief Allocates chunk in a buffer for one entry and injects overflow if
  * there is no room for requested entry.
  *
+ * The chunk is claimed by advancing the write index with compare-and-exchange, so that logging
+ * does not mask interrupts. If a preempting context claims space first, the claim is retried
+ * after it. The chunk is marked as in progress only after it has been claimed, so a context
+ * which preempts the allocation could find stale data where the header of the chunk will be.
+ * While another context is writing an entry, the buffer is therefore not parsed: old entries
+ * are not skipped on overflow, the new entry is dropped instead, and
+ * @ref nrf_log_frontend_dequeue leaves processing to the preempted context.
+ *
+ * On success, the entry must be completed with @ref buf_commit.
+ *
  * @param content_len   Number of 32bit arguments. In case of allocating for hex dump it
  *                      is the size of the buffer in 32bit words (ceiled).
  * @param p_wr_idx      Pointer to write index.
@@ -452,24 +569,35 @@ static inline void std_header_set(uint32_t severity_mid,
 static inline bool buf_prealloc(uint32_t content_len, uint32_t * p_wr_idx, bool std)
 {
     uint32_t req_len = content_len + HEADER_SIZE;
-    bool     ret            = true;
-    CRITICAL_REGION_ENTER();
-    *p_wr_idx = m_log_data.wr_idx;
-    uint32_t available_words = (m_buffer_mask + 1) - (m_log_data.wr_idx - m_log_data.rd_idx);
-    while (req_len > available_words)
-    {
-        UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.log_dropped_cnt, 1));
-        if (NRF_LOG_ALLOW_OVERFLOW)
+    bool     ret     = true;
+    uint32_t wr_idx;
+
+    UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.writing, 1));
+    wr_idx = m_log_data.wr_idx;
+
+    while (true)
+    {
+        uint32_t available_words = (m_buffer_mask + 1) - (wr_idx - m_log_data.rd_idx);
+        if (req_len > available_words)
         {
-            uint32_t dropped_in_skip = log_skip();
-            UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.log_dropped_cnt, dropped_in_skip));
-            available_words = (m_buffer_mask + 1) - (m_log_data.wr_idx - m_log_data.rd_idx);
+            UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.log_dropped_cnt, 1));
+            if (NRF_LOG_ALLOW_OVERFLOW && (m_log_data.writing == 1))
+            {
+                uint32_t dropped_in_skip = log_skip();
+                UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.log_dropped_cnt, dropped_in_skip));
+                wr_idx = m_log_data.wr_idx;
+            }
+            else
+            {
+                ret = false;
+                break;
+            }
         }
-        else
+        else if (nrf_atomic_u32_cmp_exch(&m_log_data.wr_idx, &wr_idx, wr_idx + req_len))
         {
-            ret = false;
             break;
         }
+        // On failure, wr_idx has been updated with the index claimed by the preempting context.
     }
 
     if (ret)
@@ -491,17 +619,28 @@ static inline bool buf_prealloc(uint32_t content_len, uint32_t * p_wr_idx, bool
         }
 
         nrf_log_main_header_t * p_header =
-                   (nrf_log_main_header_t *)&m_log_data.buffer[m_log_data.wr_idx & m_buffer_mask];
+                   (nrf_log_main_header_t *)&m_log_data.buffer[wr_idx & m_buffer_mask];
 
         p_header->raw = invalid_header.raw;
 
-        m_log_data.wr_idx += req_len;
+        *p_wr_idx = wr_idx;
+    }
+    else
+    {
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_sub(&m_log_data.writing, 1));
     }
 
-    CRITICAL_REGION_EXIT();
     return ret;
 }
 
+/**
+ * @brief Completes an entry allocated with @ref buf_prealloc, after its header is set.
+ */
+static inline void buf_commit(void)
+{
+    UNUSED_RETURN_VALUE(nrf_atomic_u32_sub(&m_log_data.writing, 1));
+}
+
 char const * nrf_log_push(char * const p_str)
 {
     if ((m_log_data.autoflush) || (p_str == NULL))
@@ -547,6 +686,13 @@ static inline void std_n(uint32_t           severity_mid,
     uint32_t mask   = m_buffer_mask;
     uint32_t wr_idx;
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    if (!rate_limit_check(severity_mid))
+    {
+        return;
+    }
+#endif
+
     if (buf_prealloc(nargs, &wr_idx, true))
     {
         // Proceed only if buffer was successfully preallocated.
@@ -558,6 +704,7 @@ static inline void std_n(uint32_t           severity_mid,
             m_log_data.buffer[data_idx++ & mask] =args[i];
         }
         std_header_set(severity_mid, p_str, nargs, wr_idx, mask);
+        buf_commit();
     }
     if (m_log_data.autoflush)
     {
@@ -655,6 +802,13 @@ void nrf_log_frontend_hexdump(uint32_t           severity_mid,
 {
     uint32_t mask   = m_buffer_mask;
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    if (!rate_limit_check(severity_mid))
+    {
+        return;
+    }
+#endif
+
     uint32_t wr_idx;
     if (buf_prealloc(CEIL_DIV(length, sizeof(uint32_t)), &wr_idx, false))
     {
@@ -689,8 +843,7 @@ void nrf_log_frontend_hexdump(uint32_t           severity_mid,
         p_header->base.hexdump.type        = HEADER_TYPE_HEXDUMP;
         p_header->base.hexdump.in_progress = 0;
 
-
-
+        buf_commit();
     }
 
     if (m_log_data.autoflush)
@@ -720,6 +873,13 @@ bool nrf_log_frontend_dequeue(void)
     {
         return false;
     }
+    if ((m_log_data.writing != 0) && !m_log_data.panic)
+    {
+        // A preempted context is writing an entry, see buf_prealloc(). The entries are
+        // processed when it flushes its own, or by the next call. After a panic, the
+        // preempted context may never resume, so its entry is omitted instead.
+        return false;
+    }
     m_log_data.log_skipped      = 0;
     //It has to be ensured that reading rd_idx occurs after skipped flag is cleared.
     __DSB();
@@ -994,6 +1154,7 @@ void nrf_log_panic(void)
 {
     nrf_log_backend_t const * p_backend = m_log_data.p_backend_head;
     m_log_data.autoflush = true;
+    m_log_data.panic     = true;
     while (p_backend)
     {
         nrf_log_backend_enable(p_backend);
@@ -1333,6 +1494,103 @@ static void log_backend_ctrl(nrf_cli_t const * p_cli, size_t argc, char **argv)
     nrf_cli_backend_cmd_execute(p_cli, argc, argv, log_ctrl);
 }
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+/**
+ * @brief Function for updating rate limiting of modules given by name, or of all modules.
+ *
+ * Parameters given as UINT32_MAX are left unchanged.
+ */
+static void rate_limit_update(nrf_cli_t const * p_cli,
+                              size_t            argc,
+                              char * *          argv,
+                              uint32_t          rate,
+                              uint32_t          burst,
+                              uint32_t          sample)
+{
+    uint32_t modules_cnt = (argc == 0) ? nrf_log_module_cnt_get() : argc;
+
+    for (uint32_t i = 0; i < modules_cnt; i++)
+    {
+        uint32_t module_id = i;
+
+        if ((argc != 0) && (module_id_get(argv[i], &module_id) == false))
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Unknown module:%s\r\n", argv[i]);
+            continue;
+        }
+
+        nrf_log_module_filter_data_t const * p_filter = NRF_LOG_FILTER_SECTION_VARS_GET(module_id);
+
+        nrf_log_module_rate_limit_set(module_id,
+                                      (rate   == UINT32_MAX) ? p_filter->rate   : (uint16_t)rate,
+                                      (burst  == UINT32_MAX) ? p_filter->burst  : (uint16_t)burst,
+                                      (sample == UINT32_MAX) ? p_filter->sample : (uint16_t)sample);
+    }
+}
+
+
+static void log_cmd_rate_limit(nrf_cli_t const * p_cli, size_t argc, char **argv)
+{
+    if ((argc < 3) || nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    rate_limit_update(p_cli, argc - 3, &argv[3],
+                      strtoul(argv[1], NULL, 0), strtoul(argv[2], NULL, 0), UINT32_MAX);
+}
+
+
+static void log_cmd_sample(nrf_cli_t const * p_cli, size_t argc, char **argv)
+{
+    if ((argc < 2) || nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    rate_limit_update(p_cli, argc - 2, &argv[2],
+                      UINT32_MAX, UINT32_MAX, strtoul(argv[1], NULL, 0));
+}
+
+
+static void log_cmd_suppressed(nrf_cli_t const * p_cli, size_t argc, char **argv)
+{
+    UNUSED_PARAMETER(argc);
+    UNUSED_PARAMETER(argv);
+
+    if (nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-40s | rate  | burst | sample | suppressed\r\n",
+                    "module_name");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL,
+                    "-----------------------------------------------------------------------\r\n");
+    for (uint32_t i = 0; i < nrf_log_module_cnt_get(); i++)
+    {
+        uint32_t module_id = i;
+
+        if (module_idx_get(&module_id, true) != NRF_SUCCESS)
+        {
+            continue;
+        }
+
+        nrf_log_module_filter_data_t const * p_filter = NRF_LOG_FILTER_SECTION_VARS_GET(module_id);
+
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-40s | %-5d | %-5d | %-6d | %d\r\n",
+                        nrf_log_module_name_get(i, true),
+                        p_filter->rate,
+                        p_filter->burst,
+                        p_filter->sample,
+                        NRF_LOG_DYNAMIC_SECTION_VARS_GET(module_id)->suppressed);
+    }
+}
+#endif // NRF_LOG_RATE_LIMIT_ENABLED
+
 static void module_name_get(size_t idx, nrf_cli_static_entry_t * p_static);
 
 NRF_CLI_CREATE_DYNAMIC_CMD(m_module_name, module_name_get);
@@ -1561,7 +1819,22 @@ NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_sub_log_stat)
     NRF_CLI_CMD(go, NULL, "Resume logging", log_self_go),
     NRF_CLI_CMD(halt, NULL, "Halt logging", log_self_halt),
     NRF_CLI_CMD(list_backends, NULL, "Lists logger backends.", log_cmd_backends_list),
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    NRF_CLI_CMD(rate_limit, NULL,
+        "'log rate_limit <rate> <burst> <module_0> .. <module_n>' limits logs to <rate> entries "
+        "per second with bursts of up to <burst> entries in specified modules "
+        "(all if no modules specified). Rate 0 removes the limit.",
+        log_cmd_rate_limit),
+    NRF_CLI_CMD(sample, NULL,
+        "'log sample <n> <module_0> .. <module_n>' logs one in <n> entries in specified "
+        "modules (all if no modules specified). 0 logs all entries.",
+        log_cmd_sample),
+#endif
     NRF_CLI_CMD(status, NULL, "Logger status", log_self_status),
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    NRF_CLI_CMD(suppressed, NULL, "Rate limiting status and suppressed entries.",
+        log_cmd_suppressed),
+#endif
     NRF_CLI_SUBCMD_SET_END
 };
 
@@ -43,6 +43,7 @@
 #include "nrf_log_internal.h"
 #include "nrf_log_ctrl.h"
 #include "nrf_fprintf.h"
+#include "nrf_fprintf_format.h"
 #include <ctype.h>
 
 #define NRF_LOG_COLOR_CODE_DEFAULT "\x1B[0m"
@@ -80,6 +81,47 @@ static const char * m_colors[] = {
 static uint32_t m_freq;
 static uint32_t m_timestamp_div;
 
+#if NRF_LOG_STR_FORMATTER_PLAN_CACHE_SIZE
+/* Entries have up to six arguments: one item per argument and one for the trailing text. */
+#define PLAN_ITEMS 7
+
+/**
+ * @brief Cached format plan.
+ *
+ * Log format strings are constants, so the address identifies the string.
+ */
+typedef struct
+{
+    nrf_fprintf_plan_t      plan;
+    nrf_fprintf_plan_item_t items[PLAN_ITEMS];
+    bool                    supported;  ///< False if the string cannot be compiled.
+} plan_cache_entry_t;
+
+static plan_cache_entry_t m_plan_cache[NRF_LOG_STR_FORMATTER_PLAN_CACHE_SIZE];
+
+/**
+ * @brief Function for getting the compiled plan of a format string.
+ *
+ * The cache is direct-mapped on the string address.
+ *
+ * @return Plan or NULL if the string cannot be compiled.
+ */
+static nrf_fprintf_plan_t const * plan_get(char const * p_str)
+{
+    plan_cache_entry_t * p_entry =
+        &m_plan_cache[((uint32_t)p_str >> 2) % NRF_LOG_STR_FORMATTER_PLAN_CACHE_SIZE];
+
+    if (p_entry->plan.p_fmt != p_str)
+    {
+        p_entry->plan.p_items   = p_entry->items;
+        p_entry->plan.max_items = PLAN_ITEMS;
+        p_entry->supported = (nrf_fprintf_plan_compile(&p_entry->plan, p_str) == NRF_SUCCESS);
+    }
+
+    return p_entry->supported ? &p_entry->plan : NULL;
+}
+#endif // NRF_LOG_STR_FORMATTER_PLAN_CACHE_SIZE
+
 static void timestamp_print(nrf_fprintf_ctx_t * p_ctx, uint32_t timestamp)
 {
     if (NRF_LOG_USES_TIMESTAMP)
@@ -150,16 +192,20 @@ static void postfix_process(nrf_log_str_formatter_entry_params_t * p_params,
     nrf_fprintf_buffer_flush(p_ctx);
 }
 
-void nrf_log_std_entry_process(char const * p_str,
-                                  uint32_t const * p_args,
-                                  uint32_t nargs,
-                                  nrf_log_str_formatter_entry_params_t * p_params,
-                                  nrf_fprintf_ctx_t * p_ctx)
+static void std_args_print(char const *        p_str,
+                           uint32_t const *    p_args,
+                           uint32_t            nargs,
+                           nrf_fprintf_ctx_t * p_ctx)
 {
-    bool auto_flush = p_ctx->auto_flush;
-    p_ctx->auto_flush = false;
+#if NRF_LOG_STR_FORMATTER_PLAN_CACHE_SIZE
+    nrf_fprintf_plan_t const * p_plan = plan_get(p_str);
 
-    prefix_process(p_params, p_ctx);
+    if (p_plan != NULL)
+    {
+        nrf_fprintf_plan_render(p_ctx, p_plan, p_args, nargs);
+        return;
+    }
+#endif
 
     switch (nargs)
     {
@@ -188,6 +234,20 @@ void nrf_log_std_entry_process(char const * p_str,
         default:
             break;
     }
+}
+
+void nrf_log_std_entry_process(char const * p_str,
+                                  uint32_t const * p_args,
+                                  uint32_t nargs,
+                                  nrf_log_str_formatter_entry_params_t * p_params,
+                                  nrf_fprintf_ctx_t * p_ctx)
+{
+    bool auto_flush = p_ctx->auto_flush;
+    p_ctx->auto_flush = false;
+
+    prefix_process(p_params, p_ctx);
+
+    std_args_print(p_str, p_args, nargs, p_ctx);
 
     postfix_process(p_params, p_ctx, false);
     p_ctx->auto_flush = auto_flush;
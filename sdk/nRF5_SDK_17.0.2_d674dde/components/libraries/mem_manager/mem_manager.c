@@ -431,6 +431,9 @@ NRF_LOG_MODULE_REGISTER();
 
 #define BITMAP_SIZE                    32                                                           /**< Bitmap size for each word used to contain block information. */
 #define BLOCK_BITMAP_ARRAY_SIZE        CEIL_DIV(TOTAL_BLOCK_COUNT, BITMAP_SIZE)                     /**< Determines number of blocks needed for book keeping availability status of all blocks. */
+#define BLOCK_INDEX_INVALID            0xFFFF                                                       /**< Marks the end of a free list. */
+
+STATIC_ASSERT(TOTAL_BLOCK_COUNT < BLOCK_INDEX_INVALID);
 
 
 /**@brief Lookup table for maximum memory size per block category. */
@@ -481,8 +484,23 @@ static const uint32_t m_block_mem_start[BLOCK_CAT_COUNT] =
     XXLARGE_MEMORY_START
 };
 
+/**@brief Lookup table for count of block available in each block category. */
+static const uint32_t m_block_count[BLOCK_CAT_COUNT] =
+{
+    MEMORY_MANAGER_XXSMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_XSMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_SMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,
+    MEMORY_MANAGER_LARGE_BLOCK_COUNT,
+    MEMORY_MANAGER_XLARGE_BLOCK_COUNT,
+    MEMORY_MANAGER_XXLARGE_BLOCK_COUNT
+};
+
 static uint8_t  m_memory[TOTAL_MEMORY_SIZE];                                                        /**< Memory managed by the module. */
 static uint32_t m_mem_pool[BLOCK_BITMAP_ARRAY_SIZE];                                                /**< Bitmap used for book-keeping availability of all blocks managed by the module.  */
+static uint16_t m_free_next[TOTAL_BLOCK_COUNT];                                                     /**< Link to the next free block of the same category, one entry per block. */
+static uint16_t m_free_head[BLOCK_CAT_COUNT];                                                       /**< First free block of each category, or BLOCK_INDEX_INVALID if the category is exhausted. */
+static uint32_t m_free_cat_mask;                                                                    /**< Bit N is set when category N has at least one free block. */
 
 #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
 
@@ -501,7 +519,7 @@ static const char * m_block_desc_str[BLOCK_CAT_COUNT] =
     "XXLarge"
 };
 
-static const uint32_t m_min_size_default[BLOC_CAT_COUNT] =
+static const uint32_t m_min_size_default[BLOCK_CAT_COUNT] =
 {
     MEMORY_MANAGER_XXSMALL_BLOCK_SIZE,
     MEMORY_MANAGER_XSMALL_BLOCK_SIZE,
@@ -510,7 +528,7 @@ static const uint32_t m_min_size_default[BLOC_CAT_COUNT] =
     MEMORY_MANAGER_LARGE_BLOCK_SIZE,
     MEMORY_MANAGER_XLARGE_BLOCK_SIZE,
     MEMORY_MANAGER_XXLARGE_BLOCK_SIZE
-}
+};
 
 /**@brief Table for book keeping smallest size allocated in each block range. */
 static uint32_t m_min_size[BLOCK_CAT_COUNT];
@@ -524,23 +542,20 @@ static uint32_t m_peak_count[BLOCK_CAT_COUNT];
 /**@brief Table for keeping the current count in each block range. */
 static uint32_t m_cur_count[BLOCK_CAT_COUNT];
 
-/**@brief Global pointing to minimum size holder for block type being allocated. */
-static uint32_t * p_min_size;
+/**@brief Table for counting allocations served by a category larger than the requested one. */
+static uint32_t m_spill_count[BLOCK_CAT_COUNT];
 
-/**@brief Global pointing to maximum size holder for block type being allocated. */
-static uint32_t * p_max_size;
+/**@brief Table for keeping the bytes reserved but not requested in each block range. */
+static uint32_t m_wasted_size[BLOCK_CAT_COUNT];
 
-/**@brief Lookup table for count of block available in each block category. */
-static uint32_t m_block_count[BLOCK_CAT_COUNT] =
-{
-    MEMORY_MANAGER_XXSMALL_BLOCK_COUNT,
-    MEMORY_MANAGER_XSMALL_BLOCK_COUNT,
-    MEMORY_MANAGER_SMALL_BLOCK_COUNT,
-    MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,
-    MEMORY_MANAGER_LARGE_BLOCK_COUNT,
-    MEMORY_MANAGER_XLARGE_BLOCK_COUNT,
-    MEMORY_MANAGER_XXLARGE_BLOCK_COUNT
-};
+/**@brief Peak number of bytes in use by all block ranges. */
+static uint32_t m_peak_mem_in_use;
+
+/**@brief Current number of bytes in use by all block ranges. */
+static uint32_t m_cur_mem_in_use;
+
+/**@brief Size requested for each block currently in use. */
+static uint16_t m_req_size[TOTAL_BLOCK_COUNT];
 
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
 
@@ -587,45 +602,76 @@ static __INLINE uint32_t get_block_cat(uint32_t size, uint32_t block_index)
     return 0;
 }
 
-/**@brief Initializes the block by setting it to be free. */
-static void block_init (uint32_t block_index)
+
+/**@brief Function to get the category of the block that starts at memory index 'memory_index'.
+ *
+ * @retval BLOCK_CAT_COUNT if the memory index is outside of the managed memory.
+ */
+static __INLINE uint32_t get_block_cat_by_mem(uint32_t memory_index)
 {
-    uint32_t x;
-    uint32_t y;
+    for (uint32_t block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
+    {
+        if ((memory_index >= m_block_mem_start[block_cat]) &&
+            (memory_index <  m_block_mem_start[block_cat] +
+                             m_block_count[block_cat] * m_block_size[block_cat]))
+        {
+            return block_cat;
+        }
+    }
 
-    // Determine position of the block in the bitmap.
-    // X determines relevant word for the block. Y determines the actual bit in the word.
-    get_block_coordinates(block_index, &x, &y);
+    return BLOCK_CAT_COUNT;
+}
 
-#if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
-    // Update current use statistics: lower current count in block
-    if (!IS_SET(m_mem_pool[x], y))
+
+/**@brief Function to get the memory index of the block number 'block_index' in category 'block_cat'. */
+static __INLINE uint32_t get_block_mem_index(uint32_t block_cat, uint32_t block_index)
+{
+    return m_block_mem_start[block_cat] +
+           (block_index - m_block_start[block_cat]) * m_block_size[block_cat];
+}
+
+
+/**@brief Function to find the first category, starting at 'block_cat', that has a free block.
+ *
+ * @details Categories are ordered by increasing block size, so the lowest set bit of the free
+ *          category mask at or above the requested category is the best fit.
+ *
+ * @retval BLOCK_CAT_COUNT if no such category has a free block.
+ */
+static __INLINE uint32_t free_cat_find(uint32_t block_cat)
+{
+    const uint32_t mask = m_free_cat_mask & ~((1UL << block_cat) - 1);
+
+    if (mask == 0)
     {
-        uint32_t block_cat = get_block_cat(0, block_index);
-        m_cur_count[block_cat]--;
+        return BLOCK_CAT_COUNT;
     }
-#endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
 
-    // Set bit related to the block to indicate that the block is free.
-    SET_BIT(m_mem_pool[x], y);
+    return __CLZ(__RBIT(mask));
 }
 
 
-/**@brief Function to get the size of the block number 'block_index'. */
-static __INLINE uint32_t get_block_size(uint32_t block_index)
+/**@brief Initializes the block by setting it to be free and returning it to its free list. */
+static void block_init(uint32_t block_cat, uint32_t block_index)
 {
-    const uint32_t block_cat = get_block_cat(0, block_index);
+    uint32_t x;
+    uint32_t y;
 
-#if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
-    p_min_size = &m_min_size[block_cat];
-    p_max_size = &m_max_size[block_cat];
-#endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+    // Determine position of the block in the bitmap.
+    // X determines relevant word for the block. Y determines the actual bit in the word.
+    get_block_coordinates(block_index, &x, &y);
+
+    // Set bit related to the block to indicate that the block is free.
+    SET_BIT(m_mem_pool[x], y);
 
-    return m_block_size[block_cat];
+    // Push the block on the free list of its category.
+    m_free_next[block_index] = m_free_head[block_cat];
+    m_free_head[block_cat]   = (uint16_t)block_index;
+    m_free_cat_mask         |= (1UL << block_cat);
 }
 
 
-/**@brief Function to free the block identified by block number 'block_index'. */
+/**@brief Function to check if the block identified by block number 'block_index' is free. */
 static bool is_block_free(uint32_t block_index)
 {
     uint32_t x;
@@ -639,11 +685,22 @@ static bool is_block_free(uint32_t block_index)
 }
 
 
-/**@brief Function to allocate the block identified by block number 'block_index'. */
-static void block_allocate(uint32_t block_index)
+/**@brief Function to allocate the first free block of category 'block_cat'.
+ *
+ * @return Block number of the allocated block.
+ */
+static uint32_t block_allocate(uint32_t block_cat)
 {
-    uint32_t x;
-    uint32_t y;
+    uint32_t       x;
+    uint32_t       y;
+    const uint32_t block_index = m_free_head[block_cat];
+
+    // Pop the block from the free list of its category.
+    m_free_head[block_cat] = m_free_next[block_index];
+    if (m_free_head[block_cat] == BLOCK_INDEX_INVALID)
+    {
+        m_free_cat_mask &= ~(1UL << block_cat);
+    }
 
     // Determine position of the block in the bitmap.
     // X determines relevant word for the block. Y determines the actual bit in the word.
@@ -653,8 +710,8 @@ static void block_allocate(uint32_t block_index)
 
 #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
     // Update statistics: Add to current count in block.
-    uint32_t block_cat = get_block_cat(0, block_index);
     m_cur_count[block_cat]++;
+    m_cur_mem_in_use += m_block_size[block_cat];
 
     // Report if the peak usage goes up in current block
     if (m_cur_count[block_cat] > m_peak_count[block_cat])
@@ -662,7 +719,11 @@ static void block_allocate(uint32_t block_index)
         NRF_LOG_INFO("%d: %d -> %d", block_cat, m_peak_count[block_cat], m_cur_count[block_cat]);
         m_peak_count[block_cat] = m_cur_count[block_cat];
     }
+
+    m_peak_mem_in_use = MAX(m_peak_mem_in_use, m_cur_mem_in_use);
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+
+    return block_index;
 }
 
 
@@ -674,20 +735,35 @@ uint32_t nrf_mem_init(void)
 
     MM_MUTEX_LOCK();
 
-    uint32_t block_index = 0;
+    uint32_t block_cat;
+    uint32_t block_index;
+
+    m_free_cat_mask = 0;
 
-    for (block_index = 0; block_index < TOTAL_BLOCK_COUNT; block_index++)
+#if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
+    memset(&m_cur_count, 0, sizeof(m_cur_count));
+    memset(&m_wasted_size, 0, sizeof(m_wasted_size));
+    m_cur_mem_in_use = 0;
+#endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+
+    for (block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
     {
-        block_init(block_index);
+        m_free_head[block_cat] = BLOCK_INDEX_INVALID;
+
+        // Push in reverse order so that the lowest address is handed out first.
+        for (block_index = m_block_end[block_cat]; block_index > m_block_start[block_cat]; block_index--)
+        {
+            block_init(block_cat, block_index - 1);
+        }
     }
 
-    NRF_MEM_MANAGER_DIAGNOSE_RESET
+    NRF_MEM_MANAGER_DIAGNOSE_RESET;
 
 #if (MEM_MANAGER_DISABLE_API_PARAM_CHECK == 0)
     m_module_initialized = true;
 #endif // MEM_MANAGER_DISABLE_API_PARAM_CHECK
 
-    NRF_MEM_MANAGER_DIAGNOSE
+    NRF_MEM_MANAGER_DIAGNOSE;
 
     MM_MUTEX_UNLOCK();
 
@@ -711,49 +787,45 @@ uint32_t nrf_mem_reserve(uint8_t ** pp_buffer, uint32_t * p_size)
 
     MM_MUTEX_LOCK();
 
-    const uint32_t block_cat    = get_block_cat(requested_size, TOTAL_BLOCK_COUNT);
-    uint32_t       block_index  = m_block_start[block_cat];
-    uint32_t       memory_index = m_block_mem_start[block_cat];
-    uint32_t       err_code     = (NRF_ERROR_NO_MEM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE);
+    const uint32_t requested_cat = get_block_cat(requested_size, TOTAL_BLOCK_COUNT);
+    const uint32_t block_cat     = free_cat_find(requested_cat);
+    uint32_t       err_code      = (NRF_ERROR_NO_MEM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE);
 
-    NRF_LOG_DEBUG("Start index for the pool = 0x%08lX, total block count 0x%08X",
-           block_index,
-           TOTAL_BLOCK_COUNT);
+    NRF_LOG_DEBUG("Requested category %d, serving category %d", requested_cat, block_cat);
 
-    for (; block_index < TOTAL_BLOCK_COUNT; block_index++)
+    if (block_cat < BLOCK_CAT_COUNT)
     {
-        uint32_t block_size = get_block_size(block_index);
-
-        if (is_block_free(block_index) == true)
-        {
-            NRF_LOG_DEBUG("Reserving block 0x%08lX", block_index);
+        // Search succeeded, found free block.
+        err_code = NRF_SUCCESS;
 
-            // Search succeeded, found free block.
-            err_code     = NRF_SUCCESS;
+        // Allocate block.
+        const uint32_t block_index = block_allocate(block_cat);
 
-            // Allocate block.
-            block_allocate(block_index);
+        NRF_LOG_DEBUG("Reserving block 0x%08lX", block_index);
 
-            (*pp_buffer) = &m_memory[memory_index];
-            (*p_size)    = block_size;
+        (*pp_buffer) = &m_memory[get_block_mem_index(block_cat, block_index)];
+        (*p_size)    = m_block_size[block_cat];
 
-        #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
-            (*p_min_size) = MIN((*p_min_size), requested_size);
-            (*p_max_size) = MAX((*p_max_size), requested_size);
-        #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+    #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
+        m_min_size[block_cat]     = MIN(m_min_size[block_cat], requested_size);
+        m_max_size[block_cat]     = MAX(m_max_size[block_cat], requested_size);
+        m_req_size[block_index]   = (uint16_t)requested_size;
+        m_wasted_size[block_cat] += (m_block_size[block_cat] - requested_size);
 
-            break;
+        if (block_cat != requested_cat)
+        {
+            m_spill_count[block_cat]++;
         }
-        memory_index += block_size;
+    #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
     }
-    if (err_code != NRF_SUCCESS)
+    else
     {
         NRF_LOG_ERROR("Memory reservation failed: err_code %d, memory %p, size %d!",
                 err_code,
                 (uint32_t)(*pp_buffer),
                 (*p_size));
 
-        NRF_MEM_MANAGER_DIAGNOSE
+        NRF_MEM_MANAGER_DIAGNOSE;
     }
 
     MM_MUTEX_UNLOCK();
@@ -812,21 +884,44 @@ void nrf_free(void * p_mem)
 
     NRF_LOG_DEBUG(">> %s %p.", (uint32_t)__func__, (uint32_t)p_mem);
 
+    if (((uint8_t *)p_mem < &m_memory[0]) || ((uint8_t *)p_mem >= &m_memory[TOTAL_MEMORY_SIZE]))
+    {
+        NRF_LOG_WARNING("Pointer %p is not managed by the module.", (uint32_t)p_mem);
+        return;
+    }
+
     MM_MUTEX_LOCK();
 
-    uint32_t index;
-    uint32_t memory_index = 0;
+    const uint32_t memory_index = (uint32_t)((uint8_t *)p_mem - &m_memory[0]);
+    const uint32_t block_cat    = get_block_cat_by_mem(memory_index);
 
-    for (index = 0; index < TOTAL_BLOCK_COUNT; index++)
+    if (block_cat < BLOCK_CAT_COUNT)
     {
-        if (&m_memory[memory_index] == p_mem)
+        const uint32_t offset      = memory_index - m_block_mem_start[block_cat];
+        const uint32_t block_index = m_block_start[block_cat] + (offset / m_block_size[block_cat]);
+
+        if ((offset % m_block_size[block_cat]) != 0)
+        {
+            NRF_LOG_WARNING("Pointer %p is not the start of a block.", (uint32_t)p_mem);
+        }
+        else if (is_block_free(block_index))
+        {
+            NRF_LOG_WARNING("Block %d is already free.", block_index);
+        }
+        else
         {
             // Found a free block of memory, assign.
-            NRF_LOG_DEBUG("<< Freeing block %d.", index);
-            block_init(index);
-            break;
+            NRF_LOG_DEBUG("<< Freeing block %d.", block_index);
+
+        #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
+            // Update current use statistics: lower current count in block
+            m_cur_count[block_cat]--;
+            m_cur_mem_in_use         -= m_block_size[block_cat];
+            m_wasted_size[block_cat] -= (m_block_size[block_cat] - m_req_size[block_index]);
+        #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+
+            block_init(block_cat, block_index);
         }
-        memory_index += get_block_size(index);
     }
 
     MM_MUTEX_UNLOCK();
@@ -856,14 +951,12 @@ void * nrf_realloc(void * p_mem, uint32_t size)
 void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
 {
     #define PRINT_COLUMN_WIDTH      13
-    #define PRINT_BUFFER_SIZE       100
+    #define PRINT_COLUMN_COUNT      9
+    #define PRINT_BUFFER_SIZE       (PRINT_COLUMN_WIDTH * PRINT_COLUMN_COUNT + 2)
     #define ASCII_VALUE_FOR_SPACE   32
 
     char           print_buffer[PRINT_BUFFER_SIZE];
-    const uint32_t total_count   = (m_block_start[block_cat] + m_block_count[block_cat]);
-    uint32_t       in_use        = 0;
-    uint32_t       num_of_blocks = 0;
-    uint32_t       index         = m_block_start[block_cat];
+    const uint32_t in_use        = m_cur_count[block_cat] * m_block_size[block_cat];
     uint32_t       column_number;
 
     // No statistic provided in case block category is not included.
@@ -871,15 +964,6 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
     {
         memset(print_buffer, ASCII_VALUE_FOR_SPACE, PRINT_BUFFER_SIZE);
 
-        for (; index < total_count; index++)
-        {
-            if (is_block_free(index) == false)
-            {
-                num_of_blocks++;
-                in_use += m_block_size[block_cat];
-            }
-        }
-
         column_number = 0;
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
                  PRINT_COLUMN_WIDTH,
@@ -902,7 +986,7 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
                  PRINT_COLUMN_WIDTH,
                  "| %d",
-                 (int)num_of_blocks);
+                 (int)m_cur_count[block_cat]);
 
         column_number++;
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
@@ -920,7 +1004,19 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
                  PRINT_COLUMN_WIDTH,
                  "| %d",
-                 (int)m_max_count[block_cat]);
+                 (int)m_peak_count[block_cat]);
+
+        column_number++;
+        snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
+                 PRINT_COLUMN_WIDTH,
+                 "| %d",
+                 (int)m_spill_count[block_cat]);
+
+        column_number++;
+        snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
+                 PRINT_COLUMN_WIDTH,
+                 "| %d",
+                 (int)m_wasted_size[block_cat]);
 
         column_number++;
         const uint32_t column_end = (column_number * PRINT_COLUMN_WIDTH);
@@ -934,7 +1030,7 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
         }
         snprintf(&print_buffer[column_end], 2, "|");
 
-        NRF_LOG_INFO("%s", print_buffer);
+        NRF_LOG_INFO("%s", NRF_LOG_PUSH(print_buffer));
 
         (*p_mem_in_use) += in_use;
     }
@@ -946,9 +1042,9 @@ void nrf_mem_diagnose(void)
     uint32_t in_use = 0;
 
     NRF_LOG_INFO("");
-    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+");
-    NRF_LOG_INFO("| Block      | Size       | Total      | In Use     | Min Alloc  | Max Alloc  |");
-    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+");
+    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+------------+------------+------------+");
+    NRF_LOG_INFO("| Block      | Size       | Total      | In Use     | Min Alloc  | Max Alloc  | Peak Use   | Spilled    | Wasted     |");
+    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+------------+------------+------------+");
 
     print_block_info(BLOCK_CAT_XXS, &in_use);
     print_block_info(BLOCK_CAT_XS, &in_use);
@@ -958,10 +1054,11 @@ void nrf_mem_diagnose(void)
     print_block_info(BLOCK_CAT_XL, &in_use);
     print_block_info(BLOCK_CAT_XXL, &in_use);
 
-    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+");
+    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+------------+------------+------------+");
     NRF_LOG_INFO("| Total      | %d      | %d        | %d",
             TOTAL_MEMORY_SIZE, TOTAL_BLOCK_COUNT,in_use);
-    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+");
+    NRF_LOG_INFO("| Peak       | %d", m_peak_mem_in_use);
+    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+------------+------------+------------+");
 }
 
 
@@ -969,8 +1066,43 @@ void nrf_mem_diagnose_reset(void)
 {
     memcpy(&m_min_size, &m_min_size_default, sizeof(m_min_size));
     memset(&m_max_size, 0, sizeof(m_max_size));
-    memset(&m_peak_count, 0, sizeof(m_max_count));
-    memset(&m_cur_count, 0, sizeof(m_cur_count));
+    memset(&m_spill_count, 0, sizeof(m_spill_count));
+
+    // Usage counters restart from what is currently in use, so that freeing blocks
+    // reserved before the reset keeps them consistent.
+    memcpy(&m_peak_count, &m_cur_count, sizeof(m_peak_count));
+    m_peak_mem_in_use = m_cur_mem_in_use;
+}
+
+
+uint32_t nrf_mem_stats_get(uint32_t block_cat, nrf_mem_stats_t * p_stats)
+{
+    VERIFY_MODULE_INITIALIZED();
+    NULL_PARAM_CHECK(p_stats);
+
+    if (block_cat >= BLOCK_CAT_COUNT)
+    {
+        return (NRF_ERROR_INVALID_PARAM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE);
+    }
+
+    MM_MUTEX_LOCK();
+
+    p_stats->block_size  = m_block_size[block_cat];
+    p_stats->block_count = m_block_count[block_cat];
+    p_stats->in_use      = m_cur_count[block_cat];
+    p_stats->peak        = m_peak_count[block_cat];
+    p_stats->spilled     = m_spill_count[block_cat];
+    p_stats->wasted      = m_wasted_size[block_cat];
+
+    MM_MUTEX_UNLOCK();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_mem_peak_get(void)
+{
+    return m_peak_mem_in_use;
 }
 
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
@@ -56,6 +56,10 @@
  * To use fewer than seven buffer pools, do not define the count for the unwanted block
  * or explicitly set it to zero. At least one block category must be configured
  * for this module to function as expected.
+ *
+ * Free blocks of each category are kept on a separate free list, so reserving and freeing a block
+ * takes constant time regardless of the pool size and how full it is. A request is served by the
+ * smallest category that fits it and has a free block.
  */
 
 #ifndef MEM_MANAGER_H__
@@ -167,12 +171,46 @@ void nrf_mem_diagnose(void);
 
 /**@brief Function to reset memory block statistics.
  *
- * @details This API resets the statistics of the memory manager.
+ * @details This API resets the statistics of the memory manager. Peak usage restarts from the
+ *          current usage.
  *
  */
 void nrf_mem_diagnose_reset(void);
 
 
+/**@brief Usage statistics of one block category. */
+typedef struct
+{
+    uint32_t block_size;  //!< Size of each block in the category.
+    uint32_t block_count; //!< Number of blocks in the category.
+    uint32_t in_use;      //!< Number of blocks currently in use.
+    uint32_t peak;        //!< Highest number of blocks in use at the same time (high-water mark).
+    uint32_t spilled;     //!< Number of allocations served by this category because all smaller
+                          //!< categories that fit the request were exhausted.
+    uint32_t wasted;      //!< Bytes reserved but not requested in the blocks currently in use
+                          //!< (internal fragmentation).
+} nrf_mem_stats_t;
+
+
+/**@brief Function to get the usage statistics of a block category.
+ *
+ * @param[in]  block_cat Block category, from 0 (xxsmall) to 6 (xxlarge).
+ * @param[out] p_stats   Statistics of the block category.
+ *
+ * @retval NRF_SUCCESS             If the statistics were retrieved.
+ * @retval NRF_ERROR_INVALID_PARAM If the block category does not exist.
+ */
+uint32_t nrf_mem_stats_get(uint32_t block_cat, nrf_mem_stats_t * p_stats);
+
+
+/**@brief Function to get the highest number of bytes in use at the same time by all block
+ *        categories (high-water mark).
+ *
+ * @return Peak memory usage in bytes.
+ */
+uint32_t nrf_mem_peak_get(void);
+
+
 /**@brief Macro that will log the mem_manager statistics if MEM_MANAGER_ENABLE_DIAGNOSTICS
  * is enabled
  */
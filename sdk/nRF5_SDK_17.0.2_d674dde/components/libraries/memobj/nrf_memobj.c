@@ -256,3 +256,31 @@ void nrf_memobj_read(nrf_memobj_t * p_obj,
     ASSERT(op_len == len);
 
 }
+
+size_t nrf_memobj_chunk_get(nrf_memobj_t * p_obj,
+                            void **        pp_data,
+                            size_t         offset)
+{
+    ASSERT(p_obj);
+
+    memobj_head_t * p_head       = (memobj_head_t *)p_obj;
+    memobj_elem_t * p_curr_chunk = (memobj_elem_t *)p_obj;
+    size_t          chunk_size   = p_head->head_header.data.fields.chunk_size;
+
+    ASSERT(offset < (chunk_size * p_head->head_header.data.fields.chunk_cnt) -
+                    sizeof(memobj_head_header_fields_t));
+
+    size_t chunk_idx    = (offset + sizeof(memobj_head_header_fields_t)) / chunk_size;
+    size_t chunk_offset = (offset + sizeof(memobj_head_header_fields_t)) % chunk_size;
+
+    //Move to the chunk containing the offset
+    while (chunk_idx > 0)
+    {
+        p_curr_chunk = p_curr_chunk->header.p_next;
+        chunk_idx--;
+    }
+
+    *pp_data = &p_curr_chunk->data[chunk_offset];
+
+    return chunk_size - chunk_offset;
+}
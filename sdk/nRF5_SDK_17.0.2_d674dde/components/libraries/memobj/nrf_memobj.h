@@ -194,6 +194,24 @@ void nrf_memobj_read(nrf_memobj_t * p_obj,
                      size_t         len,
                      size_t         offset);
 
+/**
+ * @brief Function for getting direct access to the data of the memory object.
+ *
+ * Memory object data is fragmented into chunks. This function returns a pointer to the data at
+ * the given offset and the number of bytes that can be accessed through that pointer before the
+ * end of the chunk is reached. It can be used to pass the data to a peripheral (for example, using
+ * EasyDMA) chunk by chunk without copying it out of the memory object.
+ *
+ * @param[in]  p_obj   Pointer to memory object.
+ * @param[out] pp_data Pointer to the data at the given offset.
+ * @param[in]  offset  Offset.
+ *
+ * @return Number of contiguous bytes available at @p pp_data.
+ */
+size_t nrf_memobj_chunk_get(nrf_memobj_t * p_obj,
+                            void **        pp_data,
+                            size_t         offset);
+
 #ifdef __cplusplus
 }
 #endif
@@ -66,19 +66,62 @@ static const uint32_t k[64] = {
 };
 
 
+/**@brief Macro for one round of the compression function.
+ *
+ * The working variables are rotated by renaming them in the next invocation instead of moving them.
+ */
+#define SHA256_ROUND(a,b,c,d,e,f,g,h,i,w)                        \
+    do                                                          \
+    {                                                           \
+        uint32_t t1 = (h) + EP1(e) + CH(e,f,g) + k[i] + (w);    \
+        (d) += t1;                                              \
+        (h)  = t1 + EP0(a) + MAJ(a,b,c);                        \
+    } while (0)
+
+/**@brief Macro for eight rounds of the compression function. */
+#define SHA256_ROUNDS_8(i, W)                                   \
+    do                                                          \
+    {                                                           \
+        SHA256_ROUND(a,b,c,d,e,f,g,h,(i) + 0, W((i) + 0));      \
+        SHA256_ROUND(h,a,b,c,d,e,f,g,(i) + 1, W((i) + 1));      \
+        SHA256_ROUND(g,h,a,b,c,d,e,f,(i) + 2, W((i) + 2));      \
+        SHA256_ROUND(f,g,h,a,b,c,d,e,(i) + 3, W((i) + 3));      \
+        SHA256_ROUND(e,f,g,h,a,b,c,d,(i) + 4, W((i) + 4));      \
+        SHA256_ROUND(d,e,f,g,h,a,b,c,(i) + 5, W((i) + 5));      \
+        SHA256_ROUND(c,d,e,f,g,h,a,b,(i) + 6, W((i) + 6));      \
+        SHA256_ROUND(b,c,d,e,f,g,h,a,(i) + 7, W((i) + 7));      \
+    } while (0)
+
+/**@brief Message words of the first 16 rounds. */
+#define SHA256_W_LOAD(i)     (m[(i)])
+
+/**@brief Message words of the remaining rounds, expanded in place in a 16-word window. */
+#define SHA256_W_EXPAND(i)   (m[(i) & 15] += SIG1(m[((i) - 2) & 15]) + m[((i) - 7) & 15] \
+                                           + SIG0(m[((i) - 15) & 15]))
+
+
 /**@brief Function for calculating the hash of a 64-byte section of data.
  *
  * @param[in,out] ctx   Hash instance.
- * @param[in]     data  Aray with data to be hashed. Assumed to be 64 bytes long.
+ * @param[in]     data  Aray with data to be hashed. Assumed to be 64 bytes long. Need not be
+ *                      word-aligned.
  */
 void sha256_transform(sha256_context_t *ctx, const uint8_t * data)
 {
-    uint32_t a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
+    uint32_t a, b, c, d, e, f, g, h, i, m[16];
 
-    for (i = 0, j = 0; i < 16; ++i, j += 4)
-        m[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | (data[j + 3]);
-    for ( ; i < 64; ++i)
-        m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
+    if (((uint32_t)data & 0x03) == 0)
+    {
+        // SHA-256 words are big-endian.
+        for (i = 0; i < 16; ++i)
+            m[i] = __REV(((uint32_t const *)data)[i]);
+    }
+    else
+    {
+        for (i = 0; i < 16; ++i, data += 4)
+            m[i] = ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+                   ((uint32_t)data[2] << 8)  |  (uint32_t)data[3];
+    }
 
     a = ctx->state[0];
     b = ctx->state[1];
@@ -89,18 +132,10 @@ void sha256_transform(sha256_context_t *ctx, const uint8_t * data)
     g = ctx->state[6];
     h = ctx->state[7];
 
-    for (i = 0; i < 64; ++i) {
-        t1 = h + EP1(e) + CH(e,f,g) + k[i] + m[i];
-        t2 = EP0(a) + MAJ(a,b,c);
-        h = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
-    }
+    for (i = 0; i < 16; i += 8)
+        SHA256_ROUNDS_8(i, SHA256_W_LOAD);
+    for ( ; i < 64; i += 8)
+        SHA256_ROUNDS_8(i, SHA256_W_EXPAND);
 
     ctx->state[0] += a;
     ctx->state[1] += b;
@@ -140,16 +175,41 @@ ret_code_t sha256_update(sha256_context_t *ctx, const uint8_t * data, size_t len
         return NRF_ERROR_NULL;
     }
 
-    uint32_t i;
+    size_t fill;
+
+    // Complete a partially filled block first.
+    if (ctx->datalen > 0)
+    {
+        fill = MIN(len, 64 - ctx->datalen);
+        memcpy(&ctx->data[ctx->datalen], data, fill);
+        ctx->datalen += fill;
+        data         += fill;
+        len          -= fill;
 
-    for (i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
-        if (ctx->datalen == 64) {
-            sha256_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
+        if (ctx->datalen < 64)
+        {
+            return NRF_SUCCESS;
         }
+
+        sha256_transform(ctx, ctx->data);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
+    }
+
+    // Hash full blocks directly from the input, without copying them.
+    while (len >= 64)
+    {
+        sha256_transform(ctx, data);
+        ctx->bitlen += 512;
+        data        += 64;
+        len         -= 64;
+    }
+
+    // Keep the remainder for the next call.
+    if (len > 0)
+    {
+        memcpy(ctx->data, data, len);
+        ctx->datalen = len;
     }
 
     return NRF_SUCCESS;
@@ -50,35 +50,152 @@
 #define SLIP_BYTE_ESC_ESC         0335    /* ESC ESC_ESC means ESC data byte */
 
 
-ret_code_t slip_encode(uint8_t * p_output,  uint8_t * p_input, uint32_t input_length, uint32_t * p_output_buffer_length)
+#define SLIP_WORD_ONES            0x01010101UL
+#define SLIP_WORD_HIGHS           0x80808080UL
+
+/* Non-zero if any byte of the word is zero. */
+#define SLIP_WORD_HAS_ZERO(w)     (((w) - SLIP_WORD_ONES) & ~(w) & SLIP_WORD_HIGHS)
+
+/* Non-zero if any byte of the word is equal to b. */
+#define SLIP_WORD_HAS_BYTE(w, b)  SLIP_WORD_HAS_ZERO((w) ^ ((b) * SLIP_WORD_ONES))
+
+/** @brief Result of decoding a run of bytes. */
+typedef enum
 {
-    if (p_output == NULL || p_input == NULL || p_output_buffer_length == NULL)
+    DECODE_CHUNK_END,   /* All bytes of the chunk were consumed. */
+    DECODE_FRAME_END,   /* END byte was found. */
+    DECODE_NO_MEM,      /* Frame does not fit in the buffer. */
+    DECODE_INVALID      /* Invalid escape sequence. */
+} decode_result_t;
+
+static __INLINE bool is_special(uint8_t c)
+{
+    return (c == SLIP_BYTE_END) || (c == SLIP_BYTE_ESC);
+}
+
+/**
+ * @brief Function for finding the first END or ESC byte.
+ *
+ * Aligned words are checked four bytes at a time.
+ *
+ * @return Index of the first END or ESC byte, or @p length if there is none.
+ */
+static uint32_t special_find(uint8_t const * p_data, uint32_t length)
+{
+    uint32_t i = 0;
+
+    while ((i < length) && (((uintptr_t)&p_data[i] & (sizeof(uint32_t) - 1)) != 0))
+    {
+        if (is_special(p_data[i]))
+        {
+            return i;
+        }
+        i++;
+    }
+
+    for (; (i + sizeof(uint32_t)) <= length; i += sizeof(uint32_t))
+    {
+        uint32_t word = *(uint32_t const *)&p_data[i];
+
+        if (SLIP_WORD_HAS_BYTE(word, SLIP_BYTE_END) || SLIP_WORD_HAS_BYTE(word, SLIP_BYTE_ESC))
+        {
+            break;
+        }
+    }
+
+    for (; i < length; i++)
+    {
+        if (is_special(p_data[i]))
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+
+ret_code_t slip_encoder_start(slip_encoder_t * p_encoder, uint8_t const * p_input, uint32_t length)
+{
+    if (p_encoder == NULL || p_input == NULL)
     {
         return NRF_ERROR_NULL;
     }
 
-    *p_output_buffer_length = 0;
-    uint32_t input_index;
+    p_encoder->p_input  = p_input;
+    p_encoder->length   = length;
+    p_encoder->index    = 0;
+    p_encoder->pending  = 0;
+    p_encoder->end_sent = false;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t slip_encoder_run(slip_encoder_t * p_encoder, uint8_t * p_output, uint32_t output_len)
+{
+    uint32_t out = 0;
 
-    for (input_index = 0; input_index < input_length; input_index++)
+    while (out < output_len)
     {
-        switch (p_input[input_index])
+        if (p_encoder->pending != 0)
         {
-            case SLIP_BYTE_END:
-                p_output[(*p_output_buffer_length)++] = SLIP_BYTE_ESC;
-                p_output[(*p_output_buffer_length)++] = SLIP_BYTE_ESC_END;
-                break;
+            p_output[out++]    = p_encoder->pending;
+            p_encoder->pending = 0;
+            continue;
+        }
 
-            case SLIP_BYTE_ESC:
-                p_output[(*p_output_buffer_length)++] = SLIP_BYTE_ESC;
-                p_output[(*p_output_buffer_length)++] = SLIP_BYTE_ESC_ESC;
-                break;
+        if (p_encoder->index == p_encoder->length)
+        {
+            if (!p_encoder->end_sent)
+            {
+                p_output[out++]     = SLIP_BYTE_END;
+                p_encoder->end_sent = true;
+            }
+            break;
+        }
 
-            default:
-                p_output[(*p_output_buffer_length)++] = p_input[input_index];
+        uint8_t c = p_encoder->p_input[p_encoder->index];
+
+        if (is_special(c))
+        {
+            p_output[out++]    = SLIP_BYTE_ESC;
+            p_encoder->pending = (c == SLIP_BYTE_END) ? SLIP_BYTE_ESC_END : SLIP_BYTE_ESC_ESC;
+            p_encoder->index++;
+            continue;
         }
+
+        uint32_t run = special_find(&p_encoder->p_input[p_encoder->index],
+                                    MIN(p_encoder->length - p_encoder->index, output_len - out));
+
+        memcpy(&p_output[out], &p_encoder->p_input[p_encoder->index], run);
+        out              += run;
+        p_encoder->index += run;
+    }
+
+    return out;
+}
+
+
+bool slip_encoder_done(slip_encoder_t const * p_encoder)
+{
+    return p_encoder->end_sent && (p_encoder->pending == 0);
+}
+
+
+ret_code_t slip_encode(uint8_t * p_output,  uint8_t * p_input, uint32_t input_length, uint32_t * p_output_buffer_length)
+{
+    if (p_output == NULL || p_input == NULL || p_output_buffer_length == NULL)
+    {
+        return NRF_ERROR_NULL;
     }
-    p_output[(*p_output_buffer_length)++] = SLIP_BYTE_END;
+
+    slip_encoder_t encoder;
+
+    UNUSED_RETURN_VALUE(slip_encoder_start(&encoder, p_input, input_length));
+
+    // The caller guarantees room for the worst case of 2 * input_length + 1 bytes.
+    *p_output_buffer_length = slip_encoder_run(&encoder, p_output, 2 * input_length + 1);
 
     return NRF_SUCCESS;
 }
@@ -147,4 +264,171 @@ ret_code_t slip_decode_add_byte(slip_t * p_slip, uint8_t c)
 
     return NRF_ERROR_BUSY;
 }
+
+
+/**
+ * @brief Function for decoding bytes of a chunk until the end of the frame or of the chunk.
+ *
+ * Decoded bytes are written to @p p_dst, which may point into the chunk itself because decoding
+ * never produces more bytes than it consumes.
+ *
+ * @param[in,out] p_slip    Decoder state. Only the escape state is used.
+ * @param[in]     p_data    Chunk.
+ * @param[in]     length    Length of the chunk.
+ * @param[in,out] p_index   Index of the next byte in the chunk.
+ * @param[out]    p_dst     Frame buffer.
+ * @param[in,out] p_dst_len Number of bytes in the frame buffer.
+ */
+static decode_result_t decode_run(slip_t *        p_slip,
+                                  uint8_t const * p_data,
+                                  uint32_t        length,
+                                  uint32_t *      p_index,
+                                  uint8_t *       p_dst,
+                                  uint32_t *      p_dst_len)
+{
+    decode_result_t result;
+    uint32_t        index   = *p_index;
+    uint32_t        dst_len = *p_dst_len;
+
+    while (true)
+    {
+        if (p_slip->state == SLIP_STATE_ESC_RECEIVED)
+        {
+            if (index == length)
+            {
+                result = DECODE_CHUNK_END;
+                break;
+            }
+
+            uint8_t c = p_data[index++];
+
+            if (c == SLIP_BYTE_ESC_END)
+            {
+                c = SLIP_BYTE_END;
+            }
+            else if (c == SLIP_BYTE_ESC_ESC)
+            {
+                c = SLIP_BYTE_ESC;
+            }
+            else
+            {
+                result = DECODE_INVALID;
+                break;
+            }
+
+            if (dst_len == p_slip->buffer_len)
+            {
+                result = DECODE_NO_MEM;
+                break;
+            }
+
+            p_dst[dst_len++] = c;
+            p_slip->state    = SLIP_STATE_DECODING;
+        }
+
+        uint32_t run = special_find(&p_data[index], length - index);
+
+        if (run > p_slip->buffer_len - dst_len)
+        {
+            result = DECODE_NO_MEM;
+            break;
+        }
+
+        // Regions overlap when decoding in place.
+        memmove(&p_dst[dst_len], &p_data[index], run);
+        dst_len += run;
+        index   += run;
+
+        if (index == length)
+        {
+            result = DECODE_CHUNK_END;
+            break;
+        }
+
+        if (p_data[index++] == SLIP_BYTE_END)
+        {
+            result = DECODE_FRAME_END;
+            break;
+        }
+
+        p_slip->state = SLIP_STATE_ESC_RECEIVED;
+    }
+
+    *p_index   = index;
+    *p_dst_len = dst_len;
+
+    return result;
+}
+
+
+ret_code_t slip_decode_chunk(slip_t *             p_slip,
+                             uint8_t *            p_data,
+                             uint32_t             length,
+                             slip_frame_handler_t handler,
+                             void *               p_context)
+{
+    if (p_slip == NULL || p_data == NULL || handler == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    ret_code_t err_code = NRF_SUCCESS;
+    uint32_t   index    = 0;
+
+    while (index < length)
+    {
+        if (p_slip->state == SLIP_STATE_CLEARING_INVALID_PACKET)
+        {
+            uint8_t const * p_end = memchr(&p_data[index], SLIP_BYTE_END, length - index);
+
+            if (p_end == NULL)
+            {
+                break;
+            }
+
+            index                 = (uint32_t)(p_end - p_data) + 1;
+            p_slip->state         = SLIP_STATE_DECODING;
+            p_slip->current_index = 0;
+            continue;
+        }
+
+        // A frame that starts in this chunk is decoded in place.
+        bool      in_place = (p_slip->current_index == 0) && (p_slip->state == SLIP_STATE_DECODING);
+        uint8_t * p_dst    = in_place ? &p_data[index] : p_slip->p_buffer;
+        uint32_t  dst_len  = p_slip->current_index;
+
+        switch (decode_run(p_slip, p_data, length, &index, p_dst, &dst_len))
+        {
+            case DECODE_FRAME_END:
+                p_slip->current_index = 0;
+                if (dst_len > 0)
+                {
+                    handler(p_context, p_dst, dst_len);
+                }
+                break;
+
+            case DECODE_CHUNK_END:
+                // Keep the beginning of the frame until the next chunk arrives.
+                if (in_place)
+                {
+                    memcpy(p_slip->p_buffer, p_dst, dst_len);
+                }
+                p_slip->current_index = dst_len;
+                break;
+
+            case DECODE_NO_MEM:
+                p_slip->state = SLIP_STATE_CLEARING_INVALID_PACKET;
+                err_code      = (err_code == NRF_SUCCESS) ? NRF_ERROR_NO_MEM : err_code;
+                break;
+
+            case DECODE_INVALID:
+            default:
+                p_slip->state = SLIP_STATE_CLEARING_INVALID_PACKET;
+                err_code      = (err_code == NRF_SUCCESS) ? NRF_ERROR_INVALID_DATA : err_code;
+                break;
+        }
+    }
+
+    return err_code;
+}
 #endif //NRF_MODULE_ENABLED(SLIP)
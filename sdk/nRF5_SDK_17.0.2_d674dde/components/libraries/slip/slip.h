@@ -41,6 +41,7 @@
 #define SLIP_H__
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "sdk_errors.h"
 
 #ifdef __cplusplus
@@ -108,6 +109,89 @@ ret_code_t slip_encode(uint8_t * p_output,  uint8_t * p_input, uint32_t input_le
  */
 ret_code_t slip_decode_add_byte(slip_t * p_slip, uint8_t c);
 
+/**@brief Streaming SLIP encoder.
+ *
+ * Encodes a packet into output segments of any size, for example the segments returned by
+ * @ref nrf_ringbuf_alloc, so that no buffer for the whole encoded packet is needed.
+ */
+typedef struct
+{
+    uint8_t const * p_input;  //!< Packet being encoded.
+    uint32_t        length;   //!< Length of the packet.
+    uint32_t        index;    //!< Index of the next input byte to encode.
+    uint8_t         pending;  //!< Second byte of an escape sequence that did not fit, or 0.
+    bool            end_sent; //!< True if the END byte has been output.
+} slip_encoder_t;
+
+/**@brief SLIP frame handler.
+ *
+ * @param[in] p_context Context passed to @ref slip_decode_chunk.
+ * @param[in] p_frame   Decoded frame. Valid only until the handler returns.
+ * @param[in] length    Length of the frame.
+ */
+typedef void (* slip_frame_handler_t)(void * p_context, uint8_t * p_frame, uint32_t length);
+
+/**@brief Function for starting the encoding of a packet.
+ *
+ * @param[out] p_encoder Encoder.
+ * @param[in]  p_input   Packet to encode. Must stay valid until encoding is done.
+ * @param[in]  length    Length of the packet.
+ *
+ * @retval NRF_SUCCESS    If the encoder was initialized.
+ * @retval NRF_ERROR_NULL If one of the provided parameters is NULL.
+ */
+ret_code_t slip_encoder_start(slip_encoder_t * p_encoder, uint8_t const * p_input, uint32_t length);
+
+/**@brief Function for encoding the next part of a packet.
+ *
+ * Runs of bytes that do not need escaping are copied in blocks.
+ *
+ * @param[in,out] p_encoder  Encoder.
+ * @param[out]    p_output   Output segment.
+ * @param[in]     output_len Size of the output segment.
+ *
+ * @return Number of bytes written to @p p_output. Less than @p output_len only when the packet
+ *         is fully encoded.
+ */
+uint32_t slip_encoder_run(slip_encoder_t * p_encoder, uint8_t * p_output, uint32_t output_len);
+
+/**@brief Function for checking if a packet is fully encoded, including its END byte.
+ *
+ * @param[in] p_encoder Encoder.
+ *
+ * @return True if encoding is done.
+ */
+bool slip_encoder_done(slip_encoder_t const * p_encoder);
+
+/**@brief Function for decoding a chunk of received data.
+ *
+ * The chunk is scanned for END and ESC bytes a word at a time. Frames that start and end in the
+ * chunk are decoded in place and passed to @p handler without copying, so the chunk is modified.
+ * Only the part of a frame that continues in the next chunk is copied to @p p_slip::p_buffer,
+ * which limits the frame size in both cases. Empty frames are ignored.
+ *
+ * Ensure that @p p_slip is properly initialized. The initial state must be set to
+ * @ref SLIP_STATE_DECODING and the current index to 0.
+ *
+ * @param[in,out] p_slip    State of the decoding process.
+ * @param[in,out] p_data    Received data.
+ * @param[in]     length    Length of the received data.
+ * @param[in]     handler   Handler called for each decoded frame.
+ * @param[in]     p_context Context passed to @p handler.
+ *
+ * @retval NRF_SUCCESS            If the whole chunk has been decoded.
+ * @retval NRF_ERROR_NULL         If one of the provided parameters is NULL.
+ * @retval NRF_ERROR_NO_MEM       If a frame did not fit in @p p_slip::p_buffer. The frame was
+ *                                dropped and the rest of the chunk decoded.
+ * @retval NRF_ERROR_INVALID_DATA If a frame was encoded wrong. The frame was dropped and the rest
+ *                                of the chunk decoded.
+ */
+ret_code_t slip_decode_chunk(slip_t *             p_slip,
+                             uint8_t *            p_data,
+                             uint32_t             length,
+                             slip_frame_handler_t handler,
+                             void *               p_context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -341,6 +341,260 @@ static ret_code_t cdc_acm_req_out_datastage(app_usbd_class_inst_t const * p_inst
     return ret;
 }
 
+/**
+ * @brief CDC ACM memory object feeder.
+ *
+ * Packets are sent directly from the memory object chunks. A packet that spans two chunks
+ * is gathered in the driver's feeder buffer.
+ *
+ * @note See @ref nrf_drv_usbd_feeder_t
+ */
+static bool cdc_acm_memobj_feeder(nrf_drv_usbd_ep_transfer_t * p_next,
+                                  void *                       p_context,
+                                  size_t                       ep_size)
+{
+    cdc_memobj_tx_t * p_tx    = (cdc_memobj_tx_t *)p_context;
+    size_t            tx_size = MIN(p_tx->size, ep_size);
+
+    if (tx_size == 0)
+    {
+        // Zero length packet after the data.
+        p_tx->zlp         = false;
+        p_next->p_data.tx = NULL;
+        p_next->size      = 0;
+        return false;
+    }
+
+    void * p_chunk;
+    size_t chunk_len = nrf_memobj_chunk_get(p_tx->p_obj, &p_chunk, p_tx->offset);
+
+    if (chunk_len >= tx_size)
+    {
+        p_next->p_data.tx = p_chunk;
+    }
+    else
+    {
+        void * p_buffer = nrf_drv_usbd_feeder_buffer_get();
+        nrf_memobj_read(p_tx->p_obj, p_buffer, tx_size, p_tx->offset);
+        p_next->p_data.tx = p_buffer;
+    }
+    p_next->size = tx_size;
+
+    p_tx->offset += tx_size;
+    p_tx->size   -= tx_size;
+
+    return (p_tx->size != 0) || p_tx->zlp;
+}
+
+/**
+ * @brief Release the oldest queued memory object transmission.
+ *
+ * @param p_cdc_acm_ctx CDC ACM class context.
+ */
+static void cdc_acm_memobj_tx_release(app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx)
+{
+    cdc_memobj_tx_t * p_tx = &p_cdc_acm_ctx->tx_memobj[p_cdc_acm_ctx->tx_memobj_rd];
+
+    nrf_memobj_put(p_tx->p_obj);
+    p_tx->p_obj = NULL;
+
+    p_cdc_acm_ctx->tx_memobj_rd = (p_cdc_acm_ctx->tx_memobj_rd + 1) %
+                                  APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE;
+    p_cdc_acm_ctx->tx_memobj_cnt--;
+    p_cdc_acm_ctx->tx_memobj_active = false;
+}
+
+/**
+ * @brief Release all queued memory object transmissions.
+ *
+ * @param p_cdc_acm_ctx CDC ACM class context.
+ */
+static void cdc_acm_memobj_tx_flush(app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx)
+{
+    while (p_cdc_acm_ctx->tx_memobj_cnt > 0)
+    {
+        cdc_acm_memobj_tx_release(p_cdc_acm_ctx);
+    }
+}
+
+/**
+ * @brief Start the oldest queued memory object transmission if the DATA IN endpoint is free.
+ *
+ * @param p_inst Generic class instance.
+ *
+ * @return Standard error code.
+ */
+static ret_code_t cdc_acm_memobj_tx_start(app_usbd_class_inst_t const * p_inst)
+{
+    app_usbd_cdc_acm_t const * p_cdc_acm     = cdc_acm_get(p_inst);
+    app_usbd_cdc_acm_ctx_t *   p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+
+    if (p_cdc_acm_ctx->tx_memobj_active || (p_cdc_acm_ctx->tx_memobj_cnt == 0))
+    {
+        return NRF_SUCCESS;
+    }
+
+    nrf_drv_usbd_handler_desc_t const handler_desc = {
+        .handler.feeder = cdc_acm_memobj_feeder,
+        .p_context      = &p_cdc_acm_ctx->tx_memobj[p_cdc_acm_ctx->tx_memobj_rd]
+    };
+
+    ret_code_t ret = app_usbd_ep_handled_transfer(data_ep_in_addr_get(p_inst), &handler_desc);
+    if (ret == NRF_SUCCESS)
+    {
+        p_cdc_acm_ctx->tx_memobj_active = true;
+    }
+    else if (ret == NRF_ERROR_BUSY)
+    {
+        // Endpoint is used by app_usbd_cdc_acm_write. Transmission is started when it is done.
+        ret = NRF_SUCCESS;
+    }
+    else
+    {
+        cdc_acm_memobj_tx_flush(p_cdc_acm_ctx);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Move the read and write positions of the receive ring back to the beginning
+ *        when the data before them is consumed.
+ *
+ * @note Must be called with the USBD interrupt disabled or from the USBD interrupt.
+ *
+ * @param p_stream Receive ring.
+ */
+static void cdc_acm_rx_stream_normalize(cdc_rx_stream_t * p_stream)
+{
+    if (p_stream->wrapped)
+    {
+        if (p_stream->rd == p_stream->end)
+        {
+            p_stream->rd      = 0;
+            p_stream->wrapped = false;
+        }
+    }
+    else if (p_stream->rd == p_stream->wr)
+    {
+        p_stream->rd = 0;
+        p_stream->wr = 0;
+    }
+}
+
+/**
+ * @brief Get the receive ring offset for a packet.
+ *
+ * Packets are never split, a packet that does not fit at the end of the ring is stored
+ * at the beginning. The write position never reaches the read position from behind, so
+ * an empty ring cannot be confused with a full one.
+ *
+ * @param p_stream Receive ring.
+ * @param len      Packet length.
+ *
+ * @return Offset of the packet or the ring size if there is no room.
+ */
+static size_t cdc_acm_rx_stream_offset(cdc_rx_stream_t const * p_stream, size_t len)
+{
+    if (p_stream->wrapped)
+    {
+        return ((p_stream->rd - p_stream->wr) > len) ? p_stream->wr : p_stream->size;
+    }
+    if ((p_stream->size - p_stream->wr) >= len)
+    {
+        return p_stream->wr;
+    }
+    return (p_stream->rd > len) ? 0 : p_stream->size;
+}
+
+/**
+ * @brief CDC ACM streaming consumer.
+ *
+ * Each packet is received directly into the user ring and finalizes the transfer, so that
+ * @ref APP_USBD_CDC_ACM_USER_EVT_RX_DONE is raised for every packet.
+ *
+ * @note See @ref nrf_drv_usbd_consumer_t
+ */
+static bool cdc_acm_stream_consumer(nrf_drv_usbd_ep_transfer_t * p_next,
+                                    void *                       p_context,
+                                    size_t                       ep_size,
+                                    size_t                       data_size)
+{
+    app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = (app_usbd_cdc_acm_ctx_t *) p_context;
+    cdc_rx_stream_t *        p_stream      = &p_cdc_acm_ctx->rx_stream;
+
+    cdc_acm_rx_stream_normalize(p_stream);
+    size_t offset = cdc_acm_rx_stream_offset(p_stream, data_size);
+
+    if (offset == p_stream->size)
+    {
+        // Room for a full packet is checked before the transfer is set, not expected.
+        p_next->p_data.rx = NULL;
+        p_next->size      = 0;
+        p_cdc_acm_ctx->cur_read = 0;
+        NRF_LOG_WARNING("Received %d bytes. No room in the receive ring.", data_size);
+        return false;
+    }
+
+    if (offset != p_stream->wr)
+    {
+        p_stream->end     = p_stream->wr;
+        p_stream->wrapped = true;
+    }
+    p_next->p_data.rx = p_stream->p_buf + offset;
+    p_next->size      = data_size;
+
+    p_stream->wr = offset + data_size;
+    p_cdc_acm_ctx->cur_read = data_size;
+    NRF_LOG_DEBUG("Received %d bytes. Stored in the receive ring.", data_size);
+    return false;
+}
+
+/**
+ * @brief Set the next transfer into the receive ring if there is room for a full packet.
+ *
+ * When the ring is full, the transfer is set once the user frees data and the host is
+ * NAKed meanwhile.
+ *
+ * @param p_inst Generic class instance.
+ *
+ * @return Standard error code.
+ */
+static ret_code_t cdc_acm_rx_stream_arm(app_usbd_class_inst_t const * p_inst)
+{
+    app_usbd_cdc_acm_t const * p_cdc_acm     = cdc_acm_get(p_inst);
+    app_usbd_cdc_acm_ctx_t *   p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+    cdc_rx_stream_t *          p_stream      = &p_cdc_acm_ctx->rx_stream;
+    ret_code_t                 ret           = NRF_SUCCESS;
+
+    nrf_drv_usbd_handler_desc_t const handler_desc = {
+        .handler.consumer = cdc_acm_stream_consumer,
+        .p_context        = p_cdc_acm_ctx
+    };
+
+    CRITICAL_REGION_ENTER();
+    cdc_acm_rx_stream_normalize(p_stream);
+    if ((p_stream->p_buf != NULL) && !p_stream->armed &&
+        (cdc_acm_rx_stream_offset(p_stream, NRF_DRV_USBD_EPSIZE) != p_stream->size))
+    {
+        ret = app_usbd_ep_handled_transfer(data_ep_out_addr_get(p_inst), &handler_desc);
+        p_stream->armed = (ret == NRF_SUCCESS);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return ret;
+}
+
+/**
+ * @brief Stop streaming into the receive ring.
+ *
+ * @param p_cdc_acm_ctx CDC ACM class context.
+ */
+static void cdc_acm_rx_stream_reset(app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx)
+{
+    memset(&p_cdc_acm_ctx->rx_stream, 0, sizeof(p_cdc_acm_ctx->rx_stream));
+}
+
 /**
  * @brief Reset port to default state.
  *
@@ -353,6 +607,12 @@ static void cdc_acm_reset_port(app_usbd_class_inst_t const * p_inst)
 
     p_cdc_acm_ctx->line_state = 0;
 
+    // Drop queued memory object transmissions.
+    cdc_acm_memobj_tx_flush(p_cdc_acm_ctx);
+
+    // Stop streaming, data left in the receive ring is lost.
+    cdc_acm_rx_stream_reset(p_cdc_acm_ctx);
+
     // Set rx transfers configuration to default state.
     p_cdc_acm_ctx->rx_transfer[0].p_buf = NULL;
     p_cdc_acm_ctx->rx_transfer[1].p_buf = NULL;
@@ -423,6 +683,12 @@ static ret_code_t setup_req_class_out(app_usbd_class_inst_t const * p_inst,
                 ep = data_ep_out_addr_get(p_inst);
                 nrf_drv_usbd_ep_abort(ep);
 
+                // Drop queued memory object transmissions.
+                cdc_acm_memobj_tx_flush(p_cdc_acm_ctx);
+
+                // Stop streaming, data left in the receive ring is lost.
+                cdc_acm_rx_stream_reset(p_cdc_acm_ctx);
+
                 // Set rx transfers configuration to default state.
                 p_cdc_acm_ctx->rx_transfer[0].p_buf = NULL;
                 p_cdc_acm_ctx->rx_transfer[1].p_buf = NULL;
@@ -687,6 +953,7 @@ static ret_code_t cdc_acm_endpoint_ev(app_usbd_class_inst_t const *  p_inst,
         NRF_LOG_INFO("EPIN_COMM: notify");
         return NRF_SUCCESS;
     }
+    app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(cdc_acm_get(p_inst));
     ret_code_t ret;
     if (NRF_USBD_EPIN_CHECK(p_event->drv_evt.data.eptransfer.ep))
     {
@@ -694,9 +961,21 @@ static ret_code_t cdc_acm_endpoint_ev(app_usbd_class_inst_t const *  p_inst,
         {
             case NRF_USBD_EP_OK:
                 NRF_LOG_INFO("EPIN_DATA: %02x done", p_event->drv_evt.data.eptransfer.ep);
-                user_event_handler(p_inst, APP_USBD_CDC_ACM_USER_EVT_TX_DONE);
-                return NRF_SUCCESS;
+                if (p_cdc_acm_ctx->tx_memobj_active)
+                {
+                    cdc_acm_memobj_tx_release(p_cdc_acm_ctx);
+                    user_event_handler(p_inst, APP_USBD_CDC_ACM_USER_EVT_MEMOBJ_TX_DONE);
+                }
+                else
+                {
+                    user_event_handler(p_inst, APP_USBD_CDC_ACM_USER_EVT_TX_DONE);
+                }
+                return cdc_acm_memobj_tx_start(p_inst);
             case NRF_USBD_EP_ABORTED:
+                if (p_cdc_acm_ctx->tx_memobj_active)
+                {
+                    cdc_acm_memobj_tx_release(p_cdc_acm_ctx);
+                }
                 return NRF_SUCCESS;
             default:
                 return NRF_ERROR_INTERNAL;
@@ -708,7 +987,16 @@ static ret_code_t cdc_acm_endpoint_ev(app_usbd_class_inst_t const *  p_inst,
         switch (p_event->drv_evt.data.eptransfer.status)
         {
             case NRF_USBD_EP_OK:
-                ret = cdc_acm_rx_block_finished(p_inst);
+                if (p_cdc_acm_ctx->rx_stream.p_buf != NULL)
+                {
+                    p_cdc_acm_ctx->rx_stream.armed = false;
+                    p_cdc_acm_ctx->last_read = p_cdc_acm_ctx->cur_read;
+                    ret = cdc_acm_rx_stream_arm(p_inst);
+                }
+                else
+                {
+                    ret = cdc_acm_rx_block_finished(p_inst);
+                }
                 NRF_LOG_INFO("EPOUT_DATA: %02x done", p_event->drv_evt.data.eptransfer.ep);
                 user_event_handler(p_inst, APP_USBD_CDC_ACM_USER_EVT_RX_DONE);
                 return ret;
@@ -964,6 +1252,54 @@ ret_code_t app_usbd_cdc_acm_write(app_usbd_cdc_acm_t const * p_cdc_acm,
     }
 }
 
+ret_code_t app_usbd_cdc_acm_write_memobj(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                         nrf_memobj_t *             p_obj,
+                                         size_t                     offset,
+                                         size_t                     length)
+{
+    ASSERT(p_obj != NULL);
+    ret_code_t ret;
+    app_usbd_class_inst_t const * p_inst = app_usbd_cdc_acm_class_inst_get(p_cdc_acm);
+    app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+
+    if (0U == (p_cdc_acm_ctx->line_state & APP_USBD_CDC_ACM_LINE_STATE_DTR))
+    {
+        /*Port is not opened*/
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+#if (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
+    CRITICAL_REGION_ENTER();
+#endif // (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
+
+    if (p_cdc_acm_ctx->tx_memobj_cnt < APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE)
+    {
+        uint8_t idx = (p_cdc_acm_ctx->tx_memobj_rd + p_cdc_acm_ctx->tx_memobj_cnt) %
+                      APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE;
+        cdc_memobj_tx_t * p_tx = &p_cdc_acm_ctx->tx_memobj[idx];
+
+        nrf_memobj_get(p_obj);
+        p_tx->p_obj  = p_obj;
+        p_tx->offset = offset;
+        p_tx->size   = length;
+        p_tx->zlp    = APP_USBD_CDC_ACM_ZLP_ON_EPSIZE_WRITE &&
+                       ((length % NRF_DRV_USBD_EPSIZE) == 0);
+        p_cdc_acm_ctx->tx_memobj_cnt++;
+
+        ret = cdc_acm_memobj_tx_start(p_inst);
+    }
+    else
+    {
+        ret = NRF_ERROR_NO_MEM;
+    }
+
+#if (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
+    CRITICAL_REGION_EXIT();
+#endif // (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
+
+    return ret;
+}
+
 size_t app_usbd_cdc_acm_rx_size(app_usbd_cdc_acm_t const * p_cdc_acm)
 {
     app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
@@ -974,8 +1310,20 @@ size_t app_usbd_cdc_acm_rx_size(app_usbd_cdc_acm_t const * p_cdc_acm)
 size_t app_usbd_cdc_acm_bytes_stored(app_usbd_cdc_acm_t const * p_cdc_acm)
 {
     app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+    cdc_rx_stream_t *        p_stream      = &p_cdc_acm_ctx->rx_stream;
+    size_t                   stored;
+
+    if (p_stream->p_buf == NULL)
+    {
+        return p_cdc_acm_ctx->bytes_left;
+    }
+
+    CRITICAL_REGION_ENTER();
+    stored = p_stream->wrapped ? (p_stream->end - p_stream->rd + p_stream->wr) :
+                                 (p_stream->wr - p_stream->rd);
+    CRITICAL_REGION_EXIT();
 
-    return p_cdc_acm_ctx->bytes_left;
+    return stored;
 }
 
 ret_code_t app_usbd_cdc_acm_read(app_usbd_cdc_acm_t const * p_cdc_acm,
@@ -992,6 +1340,12 @@ ret_code_t app_usbd_cdc_acm_read(app_usbd_cdc_acm_t const * p_cdc_acm,
         return NRF_ERROR_INVALID_STATE;
     }
 
+    if (p_cdc_acm_ctx->rx_stream.p_buf != NULL)
+    {
+        /*Data is received into the streaming ring*/
+        return NRF_ERROR_INVALID_STATE;
+    }
+
 #if (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
     CRITICAL_REGION_ENTER();
 #endif // (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
@@ -1065,6 +1419,12 @@ ret_code_t app_usbd_cdc_acm_read_any(app_usbd_cdc_acm_t const * p_cdc_acm,
         return NRF_ERROR_INVALID_STATE;
     }
 
+    if (p_cdc_acm_ctx->rx_stream.p_buf != NULL)
+    {
+        /*Data is received into the streaming ring*/
+        return NRF_ERROR_INVALID_STATE;
+    }
+
 #if (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
     CRITICAL_REGION_ENTER();
 #endif // (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
@@ -1108,6 +1468,108 @@ ret_code_t app_usbd_cdc_acm_read_any(app_usbd_cdc_acm_t const * p_cdc_acm,
     return ret;
 }
 
+ret_code_t app_usbd_cdc_acm_rx_stream_start(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                            void *                     p_buf,
+                                            size_t                     size)
+{
+    ASSERT(p_buf != NULL);
+    ret_code_t ret;
+    app_usbd_class_inst_t const * p_inst = app_usbd_cdc_acm_class_inst_get(p_cdc_acm);
+    app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+    cdc_rx_stream_t *        p_stream      = &p_cdc_acm_ctx->rx_stream;
+
+    if (0U == (p_cdc_acm_ctx->line_state & APP_USBD_CDC_ACM_LINE_STATE_DTR))
+    {
+        /*Port is not opened*/
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (size < (2 * NRF_DRV_USBD_EPSIZE))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+#if (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
+    CRITICAL_REGION_ENTER();
+#endif // (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
+
+    if ((p_stream->p_buf != NULL) || (p_cdc_acm_ctx->rx_transfer[0].p_buf != NULL))
+    {
+        ret = NRF_ERROR_BUSY;
+    }
+    else
+    {
+        // Data left in the internal buffer by app_usbd_cdc_acm_read goes first.
+        memcpy(p_buf, p_cdc_acm_ctx->p_copy_pos, p_cdc_acm_ctx->bytes_left);
+
+        p_stream->p_buf   = p_buf;
+        p_stream->size    = size;
+        p_stream->rd      = 0;
+        p_stream->wr      = p_cdc_acm_ctx->bytes_left;
+        p_stream->end     = 0;
+        p_stream->wrapped = false;
+        p_stream->armed   = false;
+        p_cdc_acm_ctx->bytes_left = 0;
+
+        ret = cdc_acm_rx_stream_arm(p_inst);
+        if (ret != NRF_SUCCESS)
+        {
+            cdc_acm_rx_stream_reset(p_cdc_acm_ctx);
+        }
+    }
+
+#if (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
+    CRITICAL_REGION_EXIT();
+#endif // (APP_USBD_CONFIG_EVENT_QUEUE_ENABLE == 0)
+
+    return ret;
+}
+
+size_t app_usbd_cdc_acm_rx_stream_get(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                      uint8_t const **           pp_data)
+{
+    ASSERT(pp_data != NULL);
+    app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+    cdc_rx_stream_t *        p_stream      = &p_cdc_acm_ctx->rx_stream;
+    size_t                   length;
+
+    CRITICAL_REGION_ENTER();
+    cdc_acm_rx_stream_normalize(p_stream);
+    *pp_data = p_stream->p_buf + p_stream->rd;
+    length   = (p_stream->wrapped ? p_stream->end : p_stream->wr) - p_stream->rd;
+    CRITICAL_REGION_EXIT();
+
+    return length;
+}
+
+ret_code_t app_usbd_cdc_acm_rx_stream_free(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                           size_t                     length)
+{
+    app_usbd_class_inst_t const * p_inst = app_usbd_cdc_acm_class_inst_get(p_cdc_acm);
+    app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+    cdc_rx_stream_t *        p_stream      = &p_cdc_acm_ctx->rx_stream;
+    ret_code_t               ret           = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+    cdc_acm_rx_stream_normalize(p_stream);
+    if (p_stream->p_buf == NULL)
+    {
+        ret = NRF_ERROR_INVALID_STATE;
+    }
+    else if (length > ((p_stream->wrapped ? p_stream->end : p_stream->wr) - p_stream->rd))
+    {
+        ret = NRF_ERROR_INVALID_LENGTH;
+    }
+    else
+    {
+        p_stream->rd += length;
+        ret = cdc_acm_rx_stream_arm(p_inst);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return ret;
+}
+
 static ret_code_t cdc_acm_serial_state_notify(app_usbd_cdc_acm_t const * p_cdc_acm)
 {
     app_usbd_class_inst_t const * p_inst = app_usbd_cdc_acm_class_inst_get(p_cdc_acm);
@@ -108,6 +108,8 @@ typedef enum app_usbd_cdc_acm_user_event_e {
 
     APP_USBD_CDC_ACM_USER_EVT_PORT_OPEN,   /**< User event PORT_OPEN.  */
     APP_USBD_CDC_ACM_USER_EVT_PORT_CLOSE,  /**< User event PORT_CLOSE. */
+
+    APP_USBD_CDC_ACM_USER_EVT_MEMOBJ_TX_DONE, /**< User event MEMOBJ_TX_DONE, see @ref app_usbd_cdc_acm_write_memobj. */
 } app_usbd_cdc_acm_user_event_t;
 
 /*lint -restore*/
@@ -228,6 +230,33 @@ ret_code_t app_usbd_cdc_acm_write(app_usbd_cdc_acm_t const * p_cdc_acm,
                                   const void *               p_buf,
                                   size_t                     length);
 
+/**
+ * @brief Writes data stored in a memory object to CDC ACM serial port.
+ *
+ * Data is sent directly from the memory object chunks, without copying it to a flat buffer.
+ * Only USB packets that span two chunks are gathered in the USB driver's feeder buffer.
+ * The memory object is referenced (@ref nrf_memobj_get) until the transfer is finished, so
+ * the caller may release it right after this call.
+ *
+ * Transmissions are queued (up to @ref APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE) and started one
+ * after the other. @ref APP_USBD_CDC_ACM_USER_EVT_MEMOBJ_TX_DONE event is generated for each of
+ * them; @ref APP_USBD_CDC_ACM_USER_EVT_TX_DONE is kept for @ref app_usbd_cdc_acm_write.
+ *
+ * @param[in] p_cdc_acm CDC ACM class instance (defined by @ref APP_USBD_CDC_ACM_GLOBAL_DEF).
+ * @param[in] p_obj     Memory object.
+ * @param[in] offset    Offset of the first byte to send.
+ * @param[in] length    Number of bytes to send.
+ *
+ * @retval NRF_SUCCESS             Transmission started or queued.
+ * @retval NRF_ERROR_INVALID_STATE Port is not opened.
+ * @retval NRF_ERROR_NO_MEM        Transmission queue is full.
+ * @retval other                   Standard error code.
+ */
+ret_code_t app_usbd_cdc_acm_write_memobj(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                         nrf_memobj_t *             p_obj,
+                                         size_t                     offset,
+                                         size_t                     length);
+
 /**
  * @brief Returns the amount of data that was read.
  *
@@ -246,6 +275,9 @@ size_t app_usbd_cdc_acm_rx_size(app_usbd_cdc_acm_t const * p_cdc_acm);
  * This function should be used on @ref APP_USBD_CDC_ACM_USER_EVT_RX_DONE event to get
  * information how many bytes are waiting in internal buffer.
  *
+ * When streaming is started (@ref app_usbd_cdc_acm_rx_stream_start), returns the number of
+ * bytes waiting in the ring buffer.
+ *
  * @param[in] p_cdc_acm CDC ACM class instance (defined by @ref APP_USBD_CDC_ACM_GLOBAL_DEF).
  *
  * @return Amount of data waiting.
@@ -274,6 +306,7 @@ size_t app_usbd_cdc_acm_bytes_stored(app_usbd_cdc_acm_t const * p_cdc_acm);
  * @retval NRF_ERROR_IO_PENDING Awaiting transmission, when data is stored into user buffer,
  *                              @ref APP_USBD_CDC_ACM_USER_EVT_RX_DONE event will be raised.
  * @retval NRF_ERROR_BUSY       There are already 2 buffers queued for transfers.
+ * @retval NRF_ERROR_INVALID_STATE Port is not opened or streaming is started.
  * @retval other                Standard error code.
  */
 ret_code_t app_usbd_cdc_acm_read(app_usbd_cdc_acm_t const * p_cdc_acm,
@@ -307,6 +340,68 @@ ret_code_t app_usbd_cdc_acm_read_any(app_usbd_cdc_acm_t const * p_cdc_acm,
                                      void *                     p_buf,
                                      size_t                     length);
 
+/**
+ * @brief Start receiving data from CDC ACM serial port directly into a user ring buffer.
+ *
+ * Each packet is received by DMA into the ring without copying. On every
+ * @ref APP_USBD_CDC_ACM_USER_EVT_RX_DONE event the stored data is available with
+ * @ref app_usbd_cdc_acm_rx_stream_get and must be released with
+ * @ref app_usbd_cdc_acm_rx_stream_free. When there is no room for a full packet, the host
+ * waits until data is freed.
+ *
+ * Data left in the internal buffer by @ref app_usbd_cdc_acm_read is moved into the ring.
+ * Streaming stops when the port is closed. While streaming, @ref app_usbd_cdc_acm_read and
+ * @ref app_usbd_cdc_acm_read_any cannot be used.
+ *
+ * @note Packets are never split, so the ring should be a multiple of the endpoint size
+ *       (@ref NRF_DRV_USBD_EPSIZE) to be used entirely.
+ *
+ * @param[in] p_cdc_acm CDC ACM class instance (defined by @ref APP_USBD_CDC_ACM_GLOBAL_DEF).
+ * @param[in] p_buf     Ring buffer, must stay valid until the port is closed.
+ * @param[in] size      Ring buffer size, at least two endpoint sizes.
+ *
+ * @retval NRF_SUCCESS              Streaming started.
+ * @retval NRF_ERROR_INVALID_STATE  Port is not opened.
+ * @retval NRF_ERROR_INVALID_LENGTH Ring buffer is too small.
+ * @retval NRF_ERROR_BUSY           Streaming is already started or a read is pending.
+ * @retval other                    Standard error code.
+ */
+ret_code_t app_usbd_cdc_acm_rx_stream_start(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                            void *                     p_buf,
+                                            size_t                     size);
+
+/**
+ * @brief Get the received data from the streaming ring buffer.
+ *
+ * The data is not copied. When the stored data wraps around the end of the ring, only the
+ * part up to the end is returned. The rest is returned after the first part is freed.
+ *
+ * @sa app_usbd_cdc_acm_rx_stream_free
+ *
+ * @param[in]  p_cdc_acm CDC ACM class instance (defined by @ref APP_USBD_CDC_ACM_GLOBAL_DEF).
+ * @param[out] pp_data   Start of the contiguous received data.
+ *
+ * @return Length of the contiguous received data, 0 if there is none.
+ */
+size_t app_usbd_cdc_acm_rx_stream_get(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                      uint8_t const **           pp_data);
+
+/**
+ * @brief Release data returned by @ref app_usbd_cdc_acm_rx_stream_get.
+ *
+ * The released space is used for the next packets.
+ *
+ * @param[in] p_cdc_acm CDC ACM class instance (defined by @ref APP_USBD_CDC_ACM_GLOBAL_DEF).
+ * @param[in] length    Number of bytes to release, up to the length of the contiguous data.
+ *
+ * @retval NRF_SUCCESS              Data released.
+ * @retval NRF_ERROR_INVALID_STATE  Streaming is not started.
+ * @retval NRF_ERROR_INVALID_LENGTH Length exceeds the contiguous received data.
+ * @retval other                    Standard error code.
+ */
+ret_code_t app_usbd_cdc_acm_rx_stream_free(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                           size_t                     length);
+
 /**
  * @brief Serial state notifications.
  * */
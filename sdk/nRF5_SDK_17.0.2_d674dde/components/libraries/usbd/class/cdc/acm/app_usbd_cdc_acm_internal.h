@@ -46,6 +46,7 @@ extern "C" {
 
 
 #include "app_util.h"
+#include "nrf_memobj.h"
 
 /**
  * @defgroup app_usbd_cdc_acm_internal USB CDC ACM internals
@@ -126,6 +127,44 @@ typedef struct {
     size_t    read_left;    //!< Bytes left to read into buffer.
 } cdc_rx_buffer_t;
 
+/**
+ * @brief Number of memory object transmissions that can be queued on one CDC ACM instance.
+ *
+ * @sa app_usbd_cdc_acm_write_memobj
+ */
+#ifndef APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE
+#define APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE 4
+#endif
+
+/**
+ * @brief CDC ACM memory object transmission.
+ */
+typedef struct {
+    nrf_memobj_t * p_obj;   //!< Memory object with data to send.
+    size_t         offset;  //!< Offset of the next byte to send.
+    size_t         size;    //!< Bytes left to send.
+    bool           zlp;     //!< Zero length packet must follow the data.
+} cdc_memobj_tx_t;
+
+/**
+ * @brief CDC ACM streaming receive ring.
+ *
+ * Packets are received by DMA directly into the user ring. Data is stored between
+ * @c rd and @c wr. When a packet does not fit at the end of the ring, it is stored at the
+ * beginning and @c end marks where the valid data at the end of the ring stops.
+ *
+ * @sa app_usbd_cdc_acm_rx_stream_start
+ */
+typedef struct {
+    uint8_t * p_buf;        //!< User ring buffer, NULL if streaming is not used.
+    size_t    size;         //!< Size of the ring buffer.
+    size_t    rd;           //!< Offset of the first byte not yet freed by the user.
+    size_t    wr;           //!< Offset of the next received byte.
+    size_t    end;          //!< End of the data before the write position wrapped.
+    bool      wrapped;      //!< Write position wrapped to the beginning of the ring.
+    bool      armed;        //!< Transfer into the ring is set on the endpoint.
+} cdc_rx_stream_t;
+
 /**
  * @brief CDC ACM class context.
  */
@@ -145,6 +184,13 @@ typedef struct {
     size_t  bytes_read;                             //!< Bytes currently written to user buffer.
     size_t  last_read;                              //!< Bytes read in last transfer.
     size_t  cur_read;                               //!< Bytes currently read to internal buffer.
+
+    cdc_memobj_tx_t tx_memobj[APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE]; //!< Queued memory object transmissions.
+    uint8_t         tx_memobj_rd;                   //!< Index of the oldest queued transmission.
+    uint8_t         tx_memobj_cnt;                  //!< Number of queued transmissions.
+    bool            tx_memobj_active;               //!< Oldest queued transmission is on the endpoint.
+
+    cdc_rx_stream_t rx_stream;                      //!< Streaming receive ring.
 } app_usbd_cdc_acm_ctx_t;
 
 /**
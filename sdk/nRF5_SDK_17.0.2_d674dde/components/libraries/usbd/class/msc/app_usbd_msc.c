@@ -900,6 +900,10 @@ static ret_code_t read_transfer_processor(app_usbd_class_inst_t const * p_inst)
                     p_msc_ctx->current.transfer.pending = false;
                 }
             }
+            else
+            {
+                ++(p_msc_ctx->stats.usb_waits);
+            }
         }
         else
         {
@@ -946,6 +950,12 @@ static ret_code_t read_blockmem_processor(app_usbd_class_inst_t const * p_inst)
                 blk_cnt,
                 p_buff);
 
+            ++(p_msc_ctx->stats.blk_reads);
+            if (p_msc_ctx->current.transfer.pending)
+            {
+                ++(p_msc_ctx->stats.overlaps);
+            }
+
             p_msc_ctx->current.process.pending = true;
             ret = nrf_blk_dev_read_req(p_blkd, &req);
 
@@ -956,6 +966,10 @@ static ret_code_t read_blockmem_processor(app_usbd_class_inst_t const * p_inst)
                 NRF_LOG_ERROR("read_blockmem_processor: block req failed: %u", ret);
             }
         }
+        else if (p_msc_ctx->current.process.size_left > 0)
+        {
+            ++(p_msc_ctx->stats.blk_waits);
+        }
     }
     return ret;
 }
@@ -982,6 +996,10 @@ static ret_code_t write_transfer_processor(app_usbd_class_inst_t const * p_inst)
                 p_msc_ctx->current.transfer.pending = false;
             }
         }
+        else if (p_msc_ctx->current.transfer.size_left > 0)
+        {
+            ++(p_msc_ctx->stats.usb_waits);
+        }
     }
     return ret;
 }
@@ -1016,6 +1034,12 @@ static ret_code_t write_blockmem_processor(app_usbd_class_inst_t const * p_inst)
                     blk_cnt,
                     p_buff);
 
+                ++(p_msc_ctx->stats.blk_writes);
+                if (p_msc_ctx->current.transfer.pending)
+                {
+                    ++(p_msc_ctx->stats.overlaps);
+                }
+
                 p_msc_ctx->current.process.pending = true;
                 ret = nrf_blk_dev_write_req(p_blkd, &req);
 
@@ -1025,6 +1049,10 @@ static ret_code_t write_blockmem_processor(app_usbd_class_inst_t const * p_inst)
                     NRF_LOG_ERROR("write_blockmem_processor: block req failed: %u", ret);
                 }
             }
+            else
+            {
+                ++(p_msc_ctx->stats.blk_waits);
+            }
         }
         else
         {
@@ -1867,6 +1895,7 @@ static ret_code_t state_data_in_handle(app_usbd_class_inst_t const * p_inst, siz
     ASSERT(current_size_calc(p_msc, p_msc_ctx->current.transfer.size_left) == size);
     /* Mark the fact the transfer block has been transfered */
     state_data_in_out_process(p_msc_ctx, size);
+    p_msc_ctx->stats.bytes_in += size;
     msc_buff_free(p_msc);
 
     ret = read_transfer_processor(p_inst);
@@ -1978,6 +2007,7 @@ static ret_code_t state_data_out_handle(app_usbd_class_inst_t const * p_inst, si
     }
     /* Mark the fact the transfer block has been transfered */
     state_data_in_out_process(p_msc_ctx, size);
+    p_msc_ctx->stats.bytes_out += size;
     msc_buff_put(p_msc);
 
     ret = write_transfer_processor(p_inst);
@@ -2488,5 +2518,12 @@ bool app_usbd_msc_sync(app_usbd_msc_t const * p_msc)
     return rc;
 }
 
+void app_usbd_msc_stats_get(app_usbd_msc_t const * p_msc, app_usbd_msc_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = msc_ctx_get(p_msc)->stats;
+    CRITICAL_REGION_EXIT();
+}
+
 
 #endif //NRF_MODULE_ENABLED(APP_USBD_MSC)
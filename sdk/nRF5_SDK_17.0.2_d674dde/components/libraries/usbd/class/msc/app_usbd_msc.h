@@ -184,6 +184,14 @@ static inline app_usbd_msc_t const * app_usbd_msc_class_get(app_usbd_class_inst_
  */
 bool app_usbd_msc_sync(app_usbd_msc_t const * p_msc);
 
+/**
+ * @brief Get the data stage statistics.
+ *
+ * @param[in]  p_msc    MSC instance (declared by @ref APP_USBD_MSC_GLOBAL_DEF).
+ * @param[out] p_stats  Statistics, see @ref app_usbd_msc_stats_t.
+ */
+void app_usbd_msc_stats_get(app_usbd_msc_t const * p_msc, app_usbd_msc_stats_t * p_stats);
+
 /** @} */
 
 #ifdef __cplusplus
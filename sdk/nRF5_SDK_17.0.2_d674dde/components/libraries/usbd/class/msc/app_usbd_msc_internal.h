@@ -146,6 +146,23 @@ typedef enum {
                                        *   to send PE error when clearing */
 } app_usbd_msc_state_t;
 
+/**
+ * @brief Data stage statistics.
+ *
+ * The counters are never cleared, the host side computes the throughput from their
+ * changes. Waits show which side limits the pipeline: the USB endpoint waits when both
+ * buffers are held by the block device, the block device waits when both are held by USB.
+ */
+typedef struct {
+    uint32_t bytes_in;          //!< Bytes sent to the host
+    uint32_t bytes_out;         //!< Bytes received from the host
+    uint32_t blk_reads;         //!< Block device read requests
+    uint32_t blk_writes;        //!< Block device write requests
+    uint32_t overlaps;          //!< Block device requests started during a USB transfer
+    uint32_t usb_waits;         //!< USB transfers delayed waiting for the block device
+    uint32_t blk_waits;         //!< Block device requests delayed waiting for USB
+} app_usbd_msc_stats_t;
+
 /**
  * @brief MSC context.
  *
@@ -199,6 +216,8 @@ typedef struct {
     } scsi_resp;
 
     uint16_t blk_dev_init_mask;     //!< Block devices init mask
+
+    app_usbd_msc_stats_t stats;     //!< Data stage statistics
 } app_usbd_msc_ctx_t;
 
 
@@ -90,6 +90,34 @@
 #define LOW_32(v)                               (((1ULL << 32) - 1) & v)
 
 
+/* Internal flag: field width is taken from the argument list ('*'). */
+#define NRF_CLI_FORMAT_FLAG_WIDTH_ARG           (1u << 3)
+
+/* Size of the digit buffer. Longest output: 32 binary digits. */
+#define NRF_CLI_FORMAT_DIGITS_MAX               32
+
+/**
+ * @brief Parsed conversion specification.
+ */
+typedef struct
+{
+    uint32_t flags;     ///< NRF_CLI_FORMAT_FLAG_* flags.
+    uint32_t width;     ///< Minimum field width.
+    uint32_t precision; ///< Minimum number of digits.
+    char     conv;      ///< Conversion specifier.
+} format_spec_t;
+
+static const char m_hex_digits[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+                                      'A', 'B', 'C', 'D', 'E', 'F' };
+
+/* Decimal digit pairs "00" to "99", used to convert two digits per division. */
+static const char m_dec_pairs[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
 static void buffer_add(nrf_fprintf_ctx_t * const p_ctx, char c)
 {
 #if NRF_MODULE_ENABLED(NRF_FPRINTF_FLAG_AUTOMATIC_CR_ON_LF)
@@ -106,49 +134,154 @@ static void buffer_add(nrf_fprintf_ctx_t * const p_ctx, char c)
     }
 }
 
-static void string_print(nrf_fprintf_ctx_t * const p_ctx,
-                         char const *              p_str,
-                         uint32_t                  FieldWidth,
-                         uint32_t                  FormatFlags)
+/**
+ * @brief Function for copying a run of characters to the IO buffer.
+ *
+ * Produces the same output as calling @ref buffer_add for each character, but copies the text
+ * in chunks limited only by the free space in the IO buffer.
+ */
+static void buffer_write(nrf_fprintf_ctx_t * const p_ctx, char const * p_str, size_t length)
 {
-    uint32_t Width = 0;
-    char c;
-
-    if ((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY)
+    while (length > 0)
     {
-        while ((c = *p_str) != '\0')
+        size_t chunk = p_ctx->io_buffer_size - p_ctx->io_buffer_cnt;
+
+        if (chunk > length)
         {
-            p_str++;
-            Width++;
-            buffer_add(p_ctx, c);
+            chunk = length;
+        }
+#if NRF_MODULE_ENABLED(NRF_FPRINTF_FLAG_AUTOMATIC_CR_ON_LF)
+        char const * p_lf = memchr(p_str, '\n', chunk);
+
+        if (p_lf != NULL)
+        {
+            chunk = (size_t)(p_lf - p_str);
         }
+#endif
+        memcpy(&p_ctx->p_io_buffer[p_ctx->io_buffer_cnt], p_str, chunk);
+        p_ctx->io_buffer_cnt += chunk;
+        p_str                += chunk;
+        length               -= chunk;
 
-        while ((FieldWidth > Width) && (FieldWidth > 0))
+        if (p_ctx->io_buffer_cnt >= p_ctx->io_buffer_size)
         {
-            FieldWidth--;
-            buffer_add(p_ctx, ' ');
+            nrf_fprintf_buffer_flush(p_ctx);
         }
+#if NRF_MODULE_ENABLED(NRF_FPRINTF_FLAG_AUTOMATIC_CR_ON_LF)
+        if (p_lf != NULL)
+        {
+            buffer_add(p_ctx, '\n');
+            p_str++;
+            length--;
+        }
+#endif
     }
-    else
+}
+
+static void buffer_fill(nrf_fprintf_ctx_t * const p_ctx, char c, uint32_t count)
+{
+    while (count > 0)
     {
-        if (p_str != 0)
+        size_t chunk = p_ctx->io_buffer_size - p_ctx->io_buffer_cnt;
+
+        if (chunk > count)
         {
-            Width = strlen(p_str);
+            chunk = count;
         }
+        memset(&p_ctx->p_io_buffer[p_ctx->io_buffer_cnt], c, chunk);
+        p_ctx->io_buffer_cnt += chunk;
+        count                -= chunk;
 
-        while ((FieldWidth > Width) && (FieldWidth > 0))
+        if (p_ctx->io_buffer_cnt >= p_ctx->io_buffer_size)
         {
-            FieldWidth--;
-            buffer_add(p_ctx, ' ');
+            nrf_fprintf_buffer_flush(p_ctx);
         }
+    }
+}
 
-        while ((c = *p_str) != '\0')
+/**
+ * @brief Function for converting a value to digits.
+ *
+ * Digits are written backwards, ending just before @p p_end, and left-padded with zeros to
+ * @p NumDigits digits.
+ *
+ * @return Pointer to the first digit.
+ */
+static char * digits_get(char *   p_end,
+                         uint32_t v,
+                         uint32_t Base,
+                         uint32_t NumDigits)
+{
+    char * p_digit = p_end;
+
+    if (Base == 10u)
+    {
+        while (v >= 100u)
         {
-            p_str++;
-            Width++;
-            buffer_add(p_ctx, c);
+            uint32_t pair = v % 100u;
+
+            v       /= 100u;
+            p_digit -= 2;
+            memcpy(p_digit, &m_dec_pairs[2 * pair], 2);
+        }
+        if (v >= 10u)
+        {
+            p_digit -= 2;
+            memcpy(p_digit, &m_dec_pairs[2 * v], 2);
+        }
+        else
+        {
+            *--p_digit = (char)('0' + v);
         }
     }
+    else if (Base == 16u)
+    {
+        do
+        {
+            *--p_digit = m_hex_digits[v & 0xFu];
+            v >>= 4;
+        } while (v);
+    }
+    else
+    {
+        do
+        {
+            *--p_digit = m_hex_digits[v % Base];
+            v /= Base;
+        } while (v);
+    }
+
+    if (NumDigits > NRF_CLI_FORMAT_DIGITS_MAX)
+    {
+        NumDigits = NRF_CLI_FORMAT_DIGITS_MAX;
+    }
+    while ((uint32_t)(p_end - p_digit) < NumDigits)
+    {
+        *--p_digit = '0';
+    }
+
+    return p_digit;
+}
+
+static void string_print(nrf_fprintf_ctx_t * const p_ctx,
+                         char const *              p_str,
+                         uint32_t                  FieldWidth,
+                         uint32_t                  FormatFlags)
+{
+    uint32_t Width = (p_str != NULL) ? strlen(p_str) : 0;
+    uint32_t Pad   = (FieldWidth > Width) ? (FieldWidth - Width) : 0;
+
+    if ((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == 0u)
+    {
+        buffer_fill(p_ctx, ' ', Pad);
+    }
+
+    buffer_write(p_ctx, p_str, Width);
+
+    if ((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY)
+    {
+        buffer_fill(p_ctx, ' ', Pad);
+    }
 }
 
 static void unsigned_print(nrf_fprintf_ctx_t * const p_ctx,
@@ -158,101 +291,36 @@ static void unsigned_print(nrf_fprintf_ctx_t * const p_ctx,
                            uint32_t                  FieldWidth,
                            uint32_t                  FormatFlags)
 {
-    static const char _aV2C[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
-                                   'A', 'B', 'C', 'D', 'E', 'F' };
-    uint32_t Div;
-    uint32_t Value;
-    uint32_t Width;
-    char c;
-
-    Value = v;
-    //
-    // Get actual field width
-    //
-    Width = 1u;
-    while (Value >= Base)
-    {
-        Value = (Value / Base);
-        Width++;
-    }
-    if (NumDigits > Width)
-    {
-        Width = NumDigits;
-    }
+    char     digits[NRF_CLI_FORMAT_DIGITS_MAX];
+    char *   p_end   = &digits[NRF_CLI_FORMAT_DIGITS_MAX];
+    char *   p_digit = digits_get(p_end, v, Base, NumDigits);
+    uint32_t Width   = (uint32_t)(p_end - p_digit);
+    uint32_t Pad     = (FieldWidth > Width) ? (FieldWidth - Width) : 0;
+
     //
     // Print leading chars if necessary
     //
     if ((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == 0u)
     {
-        if (FieldWidth != 0u)
-        {
-            if (((FormatFlags & NRF_CLI_FORMAT_FLAG_PAD_ZERO) == NRF_CLI_FORMAT_FLAG_PAD_ZERO) &&
-                (NumDigits == 0u))
-            {
-                c = '0';
-            }
-            else
-            {
-                c = ' ';
-            }
-            while ((FieldWidth != 0u) && (Width < FieldWidth))
-            {
-                FieldWidth--;
-                buffer_add(p_ctx, c);
-            }
-        }
-    }
-
-    Value = 1;
-    /*
-     * Compute Digit.
-     * Loop until Digit has the value of the highest digit required.
-     * Example: If the output is 345 (Base 10), loop 2 times until Digit is 100.
-     */
-    while (1)
-    {
-        /* User specified a min number of digits to print? => Make sure we loop at least that
-         * often, before checking anything else (> 1 check avoids problems with NumDigits
-         * being signed / unsigned)
-         */
-        if (NumDigits > 1u)
+        if (((FormatFlags & NRF_CLI_FORMAT_FLAG_PAD_ZERO) == NRF_CLI_FORMAT_FLAG_PAD_ZERO) &&
+            (NumDigits == 0u))
         {
-            NumDigits--;
+            buffer_fill(p_ctx, '0', Pad);
         }
         else
         {
-            Div = v / Value;
-            // Is our divider big enough to extract the highest digit from value? => Done
-            if (Div < Base)
-            {
-                break;
-            }
+            buffer_fill(p_ctx, ' ', Pad);
         }
-        Value *= Base;
     }
-    //
-    // Output digits
-    //
-    do
-    {
-        Div = v / Value;
-        v -= Div * Value;
-        buffer_add(p_ctx, _aV2C[Div]);
-        Value /= Base;
-    } while (Value);
+
+    buffer_write(p_ctx, p_digit, Width);
+
     //
     // Print trailing spaces if necessary
     //
     if ((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY)
     {
-        if (FieldWidth != 0u)
-        {
-            while ((FieldWidth != 0u) && (Width < FieldWidth))
-            {
-                FieldWidth--;
-                buffer_add(p_ctx, ' ');
-            }
-        }
+        buffer_fill(p_ctx, ' ', Pad);
     }
 }
 
@@ -263,24 +331,12 @@ static void int_print(nrf_fprintf_ctx_t * const p_ctx,
                       uint32_t                  FieldWidth,
                       uint32_t                  FormatFlags)
 {
-    uint32_t Width;
-    int32_t Number;
-
-    Number = (v < 0) ? -v : v;
+    char     digits[NRF_CLI_FORMAT_DIGITS_MAX];
+    char *   p_end     = &digits[NRF_CLI_FORMAT_DIGITS_MAX];
+    uint32_t magnitude = (v < 0) ? (0u - (uint32_t)v) : (uint32_t)v;
+    char *   p_digit   = digits_get(p_end, magnitude, Base, NumDigits);
+    uint32_t Width     = (uint32_t)(p_end - p_digit);
 
-    //
-    // Get actual field width
-    //
-    Width = 1u;
-    while (Number >= (int32_t)Base)
-    {
-        Number = (Number / (int32_t)Base);
-        Width++;
-    }
-    if (NumDigits > Width)
-    {
-        Width = NumDigits;
-    }
     if ((FieldWidth > 0u) && ((v < 0) ||
         ((FormatFlags & NRF_CLI_FORMAT_FLAG_PRINT_SIGN) == NRF_CLI_FORMAT_FLAG_PRINT_SIGN)))
     {
@@ -290,23 +346,16 @@ static void int_print(nrf_fprintf_ctx_t * const p_ctx,
     // Print leading spaces if necessary
     //
     if ((((FormatFlags & NRF_CLI_FORMAT_FLAG_PAD_ZERO) == 0u) || (NumDigits != 0u)) &&
-        ((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == 0u))
+        ((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == 0u) && (FieldWidth > Width))
     {
-        if (FieldWidth != 0u)
-        {
-            while ((FieldWidth != 0u) && (Width < FieldWidth))
-            {
-                FieldWidth--;
-                buffer_add(p_ctx, ' ');
-            }
-        }
+        buffer_fill(p_ctx, ' ', FieldWidth - Width);
+        FieldWidth = Width;
     }
     //
     // Print sign if necessary
     //
     if (v < 0)
     {
-        v = -v;
         buffer_add(p_ctx, '-');
     }
     else if ((FormatFlags & NRF_CLI_FORMAT_FLAG_PRINT_SIGN) == NRF_CLI_FORMAT_FLAG_PRINT_SIGN)
@@ -321,40 +370,157 @@ static void int_print(nrf_fprintf_ctx_t * const p_ctx,
     // Print leading zeros if necessary
     //
     if (((FormatFlags & NRF_CLI_FORMAT_FLAG_PAD_ZERO) == NRF_CLI_FORMAT_FLAG_PAD_ZERO) &&
-        ((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == 0u) && (NumDigits == 0u))
+        ((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == 0u) && (NumDigits == 0u) &&
+        (FieldWidth > Width))
     {
-        if (FieldWidth != 0u)
-        {
-            while ((FieldWidth != 0u) && (Width < FieldWidth))
-            {
-                FieldWidth--;
-                buffer_add(p_ctx, '0');
-            }
-        }
+        buffer_fill(p_ctx, '0', FieldWidth - Width);
+        FieldWidth = Width;
     }
     //
     // Print number without sign
     //
-    unsigned_print(p_ctx, (uint32_t)v, Base, NumDigits, FieldWidth, FormatFlags);
+    buffer_write(p_ctx, p_digit, Width);
+
+    //
+    // Print trailing spaces if necessary
+    //
+    if (((FormatFlags & NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) == NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY) &&
+        (FieldWidth > Width))
+    {
+        buffer_fill(p_ctx, ' ', FieldWidth - Width);
+    }
 }
 
-#if NRF_MODULE_ENABLED(NRF_FPRINTF_DOUBLE)
+/**
+ * @brief Function for printing a conversion that takes a 32-bit argument (all except
+ *        strings and doubles).
+ */
+static void value_print(nrf_fprintf_ctx_t * const p_ctx,
+                        char                      conv,
+                        uint32_t                  v,
+                        uint32_t                  NumDigits,
+                        uint32_t                  FieldWidth,
+                        uint32_t                  FormatFlags)
+{
+    switch (conv)
+    {
+        case 'c':
+            buffer_add(p_ctx, (char)v);
+            break;
+        case 'd':
+        case 'i':
+            int_print(p_ctx, (int32_t)v, 10u, NumDigits, FieldWidth, FormatFlags);
+            break;
+        case 'u':
+            unsigned_print(p_ctx, v, 10u, NumDigits, FieldWidth, FormatFlags);
+            break;
+        case 'x':
+        case 'X':
+            unsigned_print(p_ctx, v, 16u, NumDigits, FieldWidth, FormatFlags);
+            break;
+        case 'p':
+            buffer_write(p_ctx, "0x", 2);
+            unsigned_print(p_ctx, v, 16u, 8u, 8u, 0);
+            break;
+        default:
+            break;
+    }
+}
 
-static void fill_space(nrf_fprintf_ctx_t * const p_ctx,
-                       uint8_t len,
-                       bool zeros)
+/**
+ * @brief Function for parsing a conversion specification.
+ *
+ * @param[in]  p_fmt  Pointer to the character following '%'.
+ * @param[out] p_spec Parsed specification.
+ *
+ * @return Pointer to the character following the conversion specifier.
+ */
+static char const * spec_parse(char const * p_fmt, format_spec_t * p_spec)
 {
-    for (; len > 0; len--)
+    bool more = true;
+
+    //
+    // Filter out flags
+    //
+    p_spec->flags = 0u;
+    do
     {
-        if (zeros)
+        switch (*p_fmt)
         {
-            buffer_add(p_ctx, '0');
+            case '-':
+                p_spec->flags |= NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY;
+                p_fmt++;
+                break;
+            case '0':
+                p_spec->flags |= NRF_CLI_FORMAT_FLAG_PAD_ZERO;
+                p_fmt++;
+                break;
+            case '+':
+                p_spec->flags |= NRF_CLI_FORMAT_FLAG_PRINT_SIGN;
+                p_fmt++;
+                break;
+            default:
+                more = false;
+                break;
         }
-        else
+    } while (more);
+
+    //
+    // filter out field width
+    //
+    p_spec->width = 0u;
+    if (*p_fmt == '*')
+    {
+        p_spec->flags |= NRF_CLI_FORMAT_FLAG_WIDTH_ARG;
+        p_fmt++;
+    }
+    else
+    {
+        while ((*p_fmt >= '0') && (*p_fmt <= '9'))
+        {
+            p_spec->width = (p_spec->width * 10u) + (uint32_t)(*p_fmt - '0');
+            p_fmt++;
+        }
+    }
+
+    //
+    // Filter out precision (number of digits to display)
+    //
+    p_spec->precision = 0u;
+    if (*p_fmt == '.')
+    {
+        p_fmt++;
+        while ((*p_fmt >= '0') && (*p_fmt <= '9'))
         {
-            buffer_add(p_ctx, ' ');
+            p_spec->precision = (p_spec->precision * 10u) + (uint32_t)(*p_fmt - '0');
+            p_fmt++;
         }
     }
+
+    //
+    // Filter out length modifier
+    //
+    while ((*p_fmt == 'l') || (*p_fmt == 'h'))
+    {
+        p_fmt++;
+    }
+
+    p_spec->conv = *p_fmt;
+    if (p_spec->conv != '\0')
+    {
+        p_fmt++;
+    }
+
+    return p_fmt;
+}
+
+#if NRF_MODULE_ENABLED(NRF_FPRINTF_DOUBLE)
+
+static void fill_space(nrf_fprintf_ctx_t * const p_ctx,
+                       uint8_t len,
+                       bool zeros)
+{
+    buffer_fill(p_ctx, zeros ? '0' : ' ', len);
 }
 
 static void float_print(nrf_fprintf_ctx_t * const p_ctx,
@@ -602,203 +768,236 @@ void nrf_fprintf_fmt(nrf_fprintf_ctx_t * const p_ctx,
         return;
     }
 
-    char c;
-    int32_t v;
-    uint32_t NumDigits;
-    uint32_t FormatFlags;
-    uint32_t FieldWidth;
+    format_spec_t spec;
 
-    do
+    while (*p_fmt != '\0')
     {
-        c = *p_fmt;
-        p_fmt++;
+        //
+        // Copy literal text up to the next conversion in one go
+        //
+        char const * p_literal = p_fmt;
 
-        if (c == 0u)
+        while ((*p_fmt != '\0') && (*p_fmt != '%'))
         {
-            break;
+            p_fmt++;
         }
-        if (c == '%')
+        buffer_write(p_ctx, p_literal, (size_t)(p_fmt - p_literal));
+
+        if (*p_fmt == '\0')
         {
-            //
-            // Filter out flags
-            //
-            FormatFlags = 0u;
-            v = 1;
+            break;
+        }
 
-            do
-            {
-                c = *p_fmt;
-                switch (c)
-                {
-                    case '-':
-                        FormatFlags |= NRF_CLI_FORMAT_FLAG_LEFT_JUSTIFY;
-                        p_fmt++;
-                        break;
-                    case '0':
-                        FormatFlags |= NRF_CLI_FORMAT_FLAG_PAD_ZERO;
-                        p_fmt++;
-                        break;
-                    case '+':
-                        FormatFlags |= NRF_CLI_FORMAT_FLAG_PRINT_SIGN;
-                        p_fmt++;
-                        break;
-                    default:
-                        v = 0;
-                        break;
-                }
-            } while (v);
+        p_fmt = spec_parse(p_fmt + 1, &spec);
 
-            //
-            // filter out field width
-            //
-            FieldWidth = 0u;
-            do
-            {
-                if (c == '*')
-                {
-                    /*lint -save -e64 -e56*/
-                    FieldWidth += va_arg(*p_args, unsigned);
-                    /*lint -restore*/
-                    p_fmt++;
-                    break;
-                }
-                c = *p_fmt;
-                if ((c < '0') || (c > '9'))
-                {
-                    break;
-                }
-                p_fmt++;
-                FieldWidth = (FieldWidth * 10u) + (c - '0');
-            } while (1);
-
-            //
-            // Filter out precision (number of digits to display)
-            //
-            NumDigits = 0u;
-            c = *p_fmt;
-            if (c == '.')
+        if (spec.flags & NRF_CLI_FORMAT_FLAG_WIDTH_ARG)
+        {
+            /*lint -save -e64 -e56*/
+            spec.width = va_arg(*p_args, unsigned);
+            /*lint -restore*/
+        }
+
+        //
+        // Handle specifiers
+        //
+        /*lint -save -e64*/
+        switch (spec.conv)
+        {
+            case 'c':
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'p':
+                value_print(p_ctx,
+                            spec.conv,
+                            va_arg(*p_args, uint32_t),
+                            spec.precision,
+                            spec.width,
+                            spec.flags);
+                break;
+            case 's':
             {
-                p_fmt++;
-                do
-                {
-                    c = *p_fmt;
-                    if ((c < '0') || (c > '9'))
-                    {
-                        break;
-                    }
-                    p_fmt++;
-                    NumDigits = NumDigits * 10u + (c - '0');
-                } while (1);
+                char const * p_s = va_arg(*p_args, const char *);
+                string_print(p_ctx, p_s, spec.width, spec.flags);
+                break;
             }
-            //
-            // Filter out length modifier
-            //
-            c = *p_fmt;
-            do
-            {
-                if ((c == 'l') || (c == 'h'))
-                {
-                    p_fmt++;
-                    c = *p_fmt;
-                }
-                else
-                {
-                    break;
-                }
-            } while (1);
-            //
-            // Handle specifiers
-            //
-            /*lint -save -e64*/
-            switch (c)
-            {
-                case 'c':
-                {
-                    char c0;
-                    v = va_arg(*p_args, int32_t);
-                    c0 = (char)v;
-                    buffer_add(p_ctx, c0);
-                    break;
-                }
-                case 'd':
-                case 'i':
-                    v = va_arg(*p_args, int32_t);
-                    int_print(p_ctx,
-                              v,
-                              10u,
-                              NumDigits,
-                              FieldWidth,
-                              FormatFlags);
-                    break;
-                case 'u':
-                    v = va_arg(*p_args, int32_t);
-                    unsigned_print(p_ctx,
-                                   (uint32_t)v,
-                                   10u,
-                                   NumDigits,
-                                   FieldWidth,
-                                   FormatFlags);
-                    break;
-                case 'x':
-                case 'X':
-                    v = va_arg(*p_args, int32_t);
-                    unsigned_print(p_ctx,
-                                   (uint32_t)v,
-                                   16u,
-                                   NumDigits,
-                                   FieldWidth,
-                                   FormatFlags);
-                    break;
-                case 's':
-                {
-                    char const * p_s = va_arg(*p_args, const char *);
-                    string_print(p_ctx, p_s, FieldWidth, FormatFlags);
-                    break;
-                }
-                case 'p':
-                    v = va_arg(*p_args, int32_t);
-                    buffer_add(p_ctx, '0');
-                    buffer_add(p_ctx, 'x');
-                    unsigned_print(p_ctx, (uint32_t)v, 16u, 8u, 8u, 0);
-                    break;
-                case '%':
-                    buffer_add(p_ctx, '%');
-                    break;
+            case '%':
+                buffer_add(p_ctx, '%');
+                break;
 #if NRF_MODULE_ENABLED(NRF_FPRINTF_DOUBLE)
-                case 'f':
-                {
-                    double dbl = va_arg(*p_args, double);
-                    float_print(p_ctx,
-                                dbl,
-                                NumDigits,
-                                FieldWidth,
-                                FormatFlags,
-                                false);
-                    break;
-                }
-                case 'F':
+            case 'f':
+            case 'F':
+            {
+                double dbl = va_arg(*p_args, double);
+                float_print(p_ctx,
+                            dbl,
+                            spec.precision,
+                            spec.width,
+                            spec.flags,
+                            spec.conv == 'F');
+                break;
+            }
+#endif
+            default:
+                break;
+        }
+        /*lint -restore*/
+    }
+
+    if (p_ctx->auto_flush)
+    {
+        nrf_fprintf_buffer_flush(p_ctx);
+    }
+}
+
+static ret_code_t plan_item_add(nrf_fprintf_plan_t *  p_plan,
+                                char const *          p_literal,
+                                char const *          p_literal_end,
+                                format_spec_t const * p_spec)
+{
+    if (p_plan->item_cnt >= p_plan->max_items)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    size_t offset = (size_t)(p_literal - p_plan->p_fmt);
+    size_t length = (size_t)(p_literal_end - p_literal);
+
+    if ((offset > UINT16_MAX) || (length > UINT16_MAX))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    nrf_fprintf_plan_item_t * p_item = &p_plan->p_items[p_plan->item_cnt++];
+
+    p_item->offset    = (uint16_t)offset;
+    p_item->length    = (uint16_t)length;
+    p_item->conv      = '\0';
+    p_item->flags     = 0;
+    p_item->width     = 0;
+    p_item->precision = 0;
+
+    if (p_spec != NULL)
+    {
+        p_item->conv      = p_spec->conv;
+        p_item->flags     = (uint8_t)p_spec->flags;
+        p_item->width     = (uint8_t)p_spec->width;
+        p_item->precision = (uint8_t)p_spec->precision;
+        p_plan->nargs++;
+    }
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_fprintf_plan_compile(nrf_fprintf_plan_t * p_plan, char const * p_fmt)
+{
+    ASSERT(p_plan != NULL);
+    ASSERT(p_fmt != NULL);
+
+    ret_code_t    err_code  = NRF_SUCCESS;
+    char const *  p_literal = p_fmt;
+    format_spec_t spec;
+
+    p_plan->p_fmt    = p_fmt;
+    p_plan->item_cnt = 0;
+    p_plan->nargs    = 0;
+
+    while ((*p_fmt != '\0') && (err_code == NRF_SUCCESS))
+    {
+        if (*p_fmt != '%')
+        {
+            p_fmt++;
+            continue;
+        }
+
+        char const * p_next = spec_parse(p_fmt + 1, &spec);
+
+        switch (spec.conv)
+        {
+            case 'c':
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'p':
+            case 's':
+                if ((spec.flags & NRF_CLI_FORMAT_FLAG_WIDTH_ARG) ||
+                    (spec.width > UINT8_MAX) ||
+                    (spec.precision > UINT8_MAX))
                 {
-                    double dbl = va_arg(*p_args, double);
-                    float_print(p_ctx,
-                                dbl,
-                                NumDigits,
-                                FieldWidth,
-                                FormatFlags,
-                                true);
+                    err_code = NRF_ERROR_NOT_SUPPORTED;
                     break;
                 }
-#endif
-                default:
-                    break;
-            }
-            /*lint -restore*/
-            p_fmt++;
+                err_code = plan_item_add(p_plan, p_literal, p_fmt, &spec);
+                break;
+            case '%':
+                // Print the '%' as the last character of the literal text.
+                err_code = plan_item_add(p_plan, p_literal, p_fmt + 1, NULL);
+                break;
+            case 'f':
+            case 'F':
+                err_code = NRF_ERROR_NOT_SUPPORTED;
+                break;
+            default:
+                // Unknown conversion is skipped without consuming an argument.
+                err_code = plan_item_add(p_plan, p_literal, p_fmt, NULL);
+                break;
+        }
+
+        p_literal = p_next;
+        p_fmt     = p_next;
+    }
+
+    if ((err_code == NRF_SUCCESS) && (p_fmt != p_literal))
+    {
+        err_code = plan_item_add(p_plan, p_literal, p_fmt, NULL);
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        p_plan->item_cnt = 0;
+        p_plan->nargs    = 0;
+    }
+
+    return err_code;
+}
+
+void nrf_fprintf_plan_render(nrf_fprintf_ctx_t * const  p_ctx,
+                             nrf_fprintf_plan_t const * p_plan,
+                             uint32_t const *           p_args,
+                             uint32_t                   nargs)
+{
+    ASSERT(p_ctx != NULL);
+    ASSERT(p_plan != NULL);
+
+    uint32_t arg_idx = 0;
+
+    for (uint32_t i = 0; i < p_plan->item_cnt; i++)
+    {
+        nrf_fprintf_plan_item_t const * p_item = &p_plan->p_items[i];
+
+        buffer_write(p_ctx, &p_plan->p_fmt[p_item->offset], p_item->length);
+
+        if (p_item->conv == '\0')
+        {
+            continue;
+        }
+
+        uint32_t arg = (arg_idx < nargs) ? p_args[arg_idx] : 0;
+        arg_idx++;
+
+        if (p_item->conv == 's')
+        {
+            string_print(p_ctx, (char const *)(uintptr_t)arg, p_item->width, p_item->flags);
         }
         else
         {
-            buffer_add(p_ctx, c);
+            value_print(p_ctx, p_item->conv, arg, p_item->precision, p_item->width, p_item->flags);
         }
-    } while (*p_fmt != '\0');
+    }
 
     if (p_ctx->auto_flush)
     {
@@ -60,6 +60,8 @@
 #define NRF_FPRINTF_FORMAT_H__
 
 #include <stdarg.h>
+#include <stdint.h>
+#include "sdk_errors.h"
 #include "nrf_fprintf.h"
 
 #ifdef __cplusplus
@@ -77,6 +79,83 @@ void nrf_fprintf_fmt(nrf_fprintf_ctx_t * const p_ctx,
                     char const *               p_fmt,
                     va_list *                  p_args);
 
+/**
+ * @brief Precompiled format plan item.
+ *
+ * An item is a run of literal text followed by an optional conversion.
+ */
+typedef struct
+{
+    uint16_t offset;     ///< Offset of the literal text in the format string.
+    uint16_t length;     ///< Length of the literal text.
+    char     conv;       ///< Conversion specifier following the text or '\0' if there is none.
+    uint8_t  flags;      ///< Conversion flags.
+    uint8_t  width;      ///< Minimum field width.
+    uint8_t  precision;  ///< Minimum number of digits.
+} nrf_fprintf_plan_item_t;
+
+/**
+ * @brief Precompiled format plan.
+ */
+typedef struct
+{
+    char const *              p_fmt;      ///< Format string the plan was compiled from.
+    nrf_fprintf_plan_item_t * p_items;    ///< Item storage.
+    uint8_t                   max_items;  ///< Size of the item storage.
+    uint8_t                   item_cnt;   ///< Number of items in the plan.
+    uint8_t                   nargs;      ///< Number of arguments used by the plan.
+} nrf_fprintf_plan_t;
+
+/**
+ * @brief Macro for defining a format plan.
+ *
+ * A format string needs one item per conversion, plus one for trailing text and one for
+ * each "%%".
+ *
+ * @param name       Plan name.
+ * @param _max_items Maximum number of items in the plan.
+ */
+#define NRF_FPRINTF_PLAN_DEF(name, _max_items)                   \
+    static nrf_fprintf_plan_item_t name##_items[_max_items];      \
+    static nrf_fprintf_plan_t name =                              \
+    {                                                             \
+        .p_items   = name##_items,                                \
+        .max_items = _max_items                                   \
+    }
+
+/**
+ * @brief Function for compiling a format string into a plan.
+ *
+ * The format string is parsed once. Rendering the plan with @ref nrf_fprintf_plan_render
+ * produces the same output as @ref nrf_fprintf_fmt with the same arguments, without parsing
+ * the string again. The format string must remain valid for as long as the plan is used.
+ *
+ * Only conversions that take one 32-bit argument (c, d, i, u, x, X, p, s) are supported.
+ *
+ * @param[in,out] p_plan Plan.
+ * @param[in]     p_fmt  Format string.
+ *
+ * @retval NRF_SUCCESS             Plan compiled.
+ * @retval NRF_ERROR_NO_MEM        Format string needs more items than the plan can hold.
+ * @retval NRF_ERROR_NOT_SUPPORTED Format string uses '*' width, floating point conversions,
+ *                                 a field width or precision above 255, or is longer than
+ *                                 65535 characters.
+ */
+ret_code_t nrf_fprintf_plan_compile(nrf_fprintf_plan_t * p_plan, char const * p_fmt);
+
+/**
+ * @brief Function for rendering a precompiled plan.
+ *
+ * @param p_ctx   Print context.
+ * @param p_plan  Plan compiled with @ref nrf_fprintf_plan_compile.
+ * @param p_args  Arguments. Strings are passed as pointers cast to uint32_t.
+ * @param nargs   Number of arguments. Missing arguments are printed as 0.
+ */
+void nrf_fprintf_plan_render(nrf_fprintf_ctx_t * const  p_ctx,
+                             nrf_fprintf_plan_t const * p_plan,
+                             uint32_t const *           p_args,
+                             uint32_t                   nargs);
+
 
 #ifdef __cplusplus
 }
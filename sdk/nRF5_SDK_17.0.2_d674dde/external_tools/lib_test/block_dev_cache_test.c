@@ -0,0 +1,375 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Tests of the caching block device on top of a recording RAM backend.
+ *
+ * The backend logs every request it gets, so that the tests can check which blocks the
+ * cache reads and writes back, and in which order. Its writes can be made to fail.
+ */
+#include <string.h>
+#include "lib_test.h"
+#include "sdk_common.h"
+#include "nrf_block_dev_cache.h"
+
+#define BLK_SIZE        16
+#define BLK_COUNT       22      // The last line is cut to 2 blocks.
+#define LINE_BLOCKS     4
+#define LINE_COUNT      3
+#define REQ_MAX         32
+
+/* -------------------------------------------------------------------------
+ * Backend
+ */
+
+typedef struct
+{
+    char     op;                // 'R' or 'W'
+    uint32_t blk_id;
+    uint32_t blk_count;
+} req_t;
+
+static uint8_t  m_disk[BLK_COUNT][BLK_SIZE];
+static req_t    m_reqs[REQ_MAX];
+static unsigned m_req_cnt;
+static bool     m_write_fail;           // Write requests fail without writing.
+static bool     m_handler_set;          // The backend was initialized with an event handler.
+static bool     m_out_of_range;         // A request went past the end of the device.
+
+static const nrf_block_dev_geometry_t m_geometry = { BLK_COUNT, BLK_SIZE };
+
+static ret_code_t backend_req(char op, nrf_block_req_t const * p_blk)
+{
+    if ((p_blk->blk_id > BLK_COUNT) || (p_blk->blk_count > BLK_COUNT - p_blk->blk_id))
+    {
+        m_out_of_range = true;
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (m_req_cnt < REQ_MAX)
+    {
+        m_reqs[m_req_cnt] = (req_t){ op, p_blk->blk_id, p_blk->blk_count };
+    }
+    ++m_req_cnt;
+
+    if (op == 'R')
+    {
+        memcpy(p_blk->p_buff, m_disk[p_blk->blk_id], p_blk->blk_count * BLK_SIZE);
+    }
+    else if (m_write_fail)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+    else
+    {
+        memcpy(m_disk[p_blk->blk_id], p_blk->p_buff, p_blk->blk_count * BLK_SIZE);
+    }
+    return NRF_SUCCESS;
+}
+
+static ret_code_t backend_init(nrf_block_dev_t const * p_blk_dev,
+                               nrf_block_dev_ev_handler ev_handler,
+                               void const * p_context)
+{
+    m_handler_set = (ev_handler != NULL);
+    return NRF_SUCCESS;
+}
+
+static ret_code_t backend_uninit(nrf_block_dev_t const * p_blk_dev)
+{
+    return NRF_SUCCESS;
+}
+
+static ret_code_t backend_read_req(nrf_block_dev_t const * p_blk_dev, nrf_block_req_t const * p_blk)
+{
+    return backend_req('R', p_blk);
+}
+
+static ret_code_t backend_write_req(nrf_block_dev_t const * p_blk_dev, nrf_block_req_t const * p_blk)
+{
+    return backend_req('W', p_blk);
+}
+
+static ret_code_t backend_ioctl(nrf_block_dev_t const * p_blk_dev,
+                                nrf_block_dev_ioctl_req_t req,
+                                void * p_data)
+{
+    return (req == NRF_BLOCK_DEV_IOCTL_REQ_CACHE_FLUSH) ? NRF_SUCCESS : NRF_ERROR_NOT_SUPPORTED;
+}
+
+static nrf_block_dev_geometry_t const * backend_geometry(nrf_block_dev_t const * p_blk_dev)
+{
+    return &m_geometry;
+}
+
+static const nrf_block_dev_ops_t m_backend_ops =
+{
+    .init      = backend_init,
+    .uninit    = backend_uninit,
+    .read_req  = backend_read_req,
+    .write_req = backend_write_req,
+    .ioctl     = backend_ioctl,
+    .geometry  = backend_geometry,
+};
+
+static const nrf_block_dev_t m_backend = { .p_ops = &m_backend_ops };
+
+/** @brief Tells whether request @p idx of the backend log is the given one. */
+static bool req_is(unsigned idx, char op, uint32_t blk_id, uint32_t blk_count)
+{
+    return (idx < MIN(m_req_cnt, REQ_MAX)) &&
+           (m_reqs[idx].op == op) &&
+           (m_reqs[idx].blk_id == blk_id) &&
+           (m_reqs[idx].blk_count == blk_count);
+}
+
+/* -------------------------------------------------------------------------
+ * Helpers
+ */
+
+NRF_BLOCK_DEV_CACHE_DEFINE(m_cache, &m_backend, LINE_BLOCKS * BLK_SIZE, LINE_COUNT, 0);
+NRF_BLOCK_DEV_CACHE_DEFINE(m_cache_ahead, &m_backend, LINE_BLOCKS * BLK_SIZE, LINE_COUNT, 2);
+
+/** @brief Block contents before a test writes: every byte holds the block number. */
+static void disk_reset(void)
+{
+    for (uint32_t i = 0; i < BLK_COUNT; ++i)
+    {
+        memset(m_disk[i], (int)i, BLK_SIZE);
+    }
+    m_req_cnt      = 0;
+    m_write_fail   = false;
+    m_handler_set  = false;
+    m_out_of_range = false;
+}
+
+static ret_code_t blk_read(nrf_block_dev_cache_t const * p_cache, uint32_t blk_id, uint32_t blk_count,
+                           uint8_t * p_buff)
+{
+    NRF_BLOCK_DEV_REQUEST(req, blk_id, blk_count, p_buff);
+    return nrf_blk_dev_read_req(nrf_block_dev_cache_ops_get(p_cache), &req);
+}
+
+/** @brief Writes @p blk_count blocks whose bytes all hold @p fill. */
+static ret_code_t blk_write(nrf_block_dev_cache_t const * p_cache, uint32_t blk_id, uint32_t blk_count,
+                            uint8_t fill)
+{
+    static uint8_t buff[BLK_COUNT * BLK_SIZE];
+
+    memset(buff, fill, blk_count * BLK_SIZE);
+    NRF_BLOCK_DEV_REQUEST(req, blk_id, blk_count, buff);
+    return nrf_blk_dev_write_req(nrf_block_dev_cache_ops_get(p_cache), &req);
+}
+
+static bool blk_holds(uint8_t const * p_blk, uint8_t fill)
+{
+    for (uint32_t i = 0; i < BLK_SIZE; ++i)
+    {
+        if (p_blk[i] != fill)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static ret_code_t cache_flush(nrf_block_dev_cache_t const * p_cache)
+{
+    return nrf_blk_dev_ioctl(nrf_block_dev_cache_ops_get(p_cache),
+                             NRF_BLOCK_DEV_IOCTL_REQ_CACHE_FLUSH, NULL);
+}
+
+/* -------------------------------------------------------------------------
+ * Tests
+ */
+
+/** @brief The least recently used line is replaced, a dirty one is written back first. */
+static void lru_test(void)
+{
+    uint8_t buff[BLK_SIZE];
+
+    disk_reset();
+    TEST_CHECK(nrf_blk_dev_init(nrf_block_dev_cache_ops_get(&m_cache), NULL, NULL) == NRF_SUCCESS);
+    TEST_CHECK(!m_handler_set);
+
+    // Lines 0, 4 and 8 fill the cache, then line 0 is used again.
+    TEST_CHECK(blk_read(&m_cache, 0, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_read(&m_cache, 5, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_read(&m_cache, 10, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_holds(buff, 10));
+    TEST_CHECK(blk_read(&m_cache, 3, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_holds(buff, 3));
+    TEST_CHECK(m_req_cnt == 3);
+    TEST_CHECK(req_is(0, 'R', 0, 4) && req_is(1, 'R', 4, 4) && req_is(2, 'R', 8, 4));
+
+    // Line 4 is the least recently used one.
+    TEST_CHECK(blk_write(&m_cache, 13, 1, 0xA5) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 3);
+    TEST_CHECK(blk_read(&m_cache, 1, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_read(&m_cache, 9, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 3);
+
+    // Line 12 is now the least recently used one and is dirty.
+    TEST_CHECK(blk_read(&m_cache, 6, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_holds(buff, 6));
+    TEST_CHECK(m_req_cnt == 5);
+    TEST_CHECK(req_is(3, 'W', 13, 1) && req_is(4, 'R', 4, 4));
+    TEST_CHECK(blk_holds(m_disk[13], 0xA5));
+    TEST_CHECK(blk_holds(m_disk[12], 12) && blk_holds(m_disk[14], 14));
+
+    TEST_CHECK(nrf_blk_dev_uninit(nrf_block_dev_cache_ops_get(&m_cache)) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 5);
+    TEST_CHECK(!m_out_of_range);
+}
+
+/** @brief Dirty blocks are written back in one request, clean blocks between them are read first. */
+static void write_back_test(void)
+{
+    uint8_t buff[BLK_SIZE];
+
+    disk_reset();
+    TEST_CHECK(nrf_blk_dev_init(nrf_block_dev_cache_ops_get(&m_cache), NULL, NULL) == NRF_SUCCESS);
+
+    // Blocks 1 and 3 of line 0 stay in the cache.
+    TEST_CHECK(blk_write(&m_cache, 1, 1, 0xB1) == NRF_SUCCESS);
+    TEST_CHECK(blk_write(&m_cache, 3, 1, 0xB3) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 0);
+    TEST_CHECK(blk_read(&m_cache, 3, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_holds(buff, 0xB3));
+    TEST_CHECK(m_req_cnt == 0);
+
+    // Only the hole between them is read, block 0 is left alone.
+    TEST_CHECK(cache_flush(&m_cache) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 2);
+    TEST_CHECK(req_is(0, 'R', 2, 1) && req_is(1, 'W', 1, 3));
+    TEST_CHECK(blk_holds(m_disk[0], 0) && blk_holds(m_disk[1], 0xB1));
+    TEST_CHECK(blk_holds(m_disk[2], 2) && blk_holds(m_disk[3], 0xB3));
+
+    // Nothing is left to write.
+    TEST_CHECK(cache_flush(&m_cache) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 2);
+
+    // A completely written line goes out at once, without reading. The last line has 2 blocks.
+    TEST_CHECK(blk_write(&m_cache, 4, 4, 0xC4) == NRF_SUCCESS);
+    TEST_CHECK(blk_write(&m_cache, 20, 2, 0xD4) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 4);
+    TEST_CHECK(req_is(2, 'W', 4, 4) && req_is(3, 'W', 20, 2));
+    TEST_CHECK(blk_holds(m_disk[7], 0xC4) && blk_holds(m_disk[21], 0xD4));
+
+    TEST_CHECK(nrf_blk_dev_uninit(nrf_block_dev_cache_ops_get(&m_cache)) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 4);
+    TEST_CHECK(!m_out_of_range);
+}
+
+/** @brief Sequential reads load the following lines, up to the end of the device. */
+static void read_ahead_test(void)
+{
+    uint8_t buff[LINE_BLOCKS * BLK_SIZE];
+
+    disk_reset();
+    TEST_CHECK(nrf_blk_dev_init(nrf_block_dev_cache_ops_get(&m_cache_ahead), NULL, NULL) ==
+               NRF_SUCCESS);
+
+    TEST_CHECK(blk_read(&m_cache_ahead, 8, 4, buff) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 1);
+
+    // Lines 16 and 20 are loaded ahead, the last one is cut to the end of the device.
+    TEST_CHECK(blk_read(&m_cache_ahead, 12, 4, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_holds(&buff[3 * BLK_SIZE], 15));
+    TEST_CHECK(m_req_cnt == 4);
+    TEST_CHECK(req_is(1, 'R', 12, 4) && req_is(2, 'R', 16, 4) && req_is(3, 'R', 20, 2));
+
+    // Reading on to the end comes from the cache and loads nothing past it.
+    TEST_CHECK(blk_read(&m_cache_ahead, 16, 4, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_read(&m_cache_ahead, 20, 2, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_holds(&buff[BLK_SIZE], 21));
+    TEST_CHECK(m_req_cnt == 4);
+
+    // No line was given up for one past the end.
+    TEST_CHECK(blk_read(&m_cache_ahead, 12, 4, buff) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 4);
+    TEST_CHECK(!m_out_of_range);
+
+    // Requests past the end are refused, also when the end block number wraps around.
+    TEST_CHECK(blk_read(&m_cache_ahead, 21, 2, buff) == NRF_ERROR_INVALID_ADDR);
+    TEST_CHECK(blk_read(&m_cache_ahead, 21, UINT32_MAX, buff) == NRF_ERROR_INVALID_ADDR);
+    TEST_CHECK(blk_write(&m_cache_ahead, 20, 3, 0) == NRF_ERROR_INVALID_ADDR);
+    TEST_CHECK(m_req_cnt == 4);
+
+    TEST_CHECK(nrf_blk_dev_uninit(nrf_block_dev_cache_ops_get(&m_cache_ahead)) == NRF_SUCCESS);
+}
+
+/** @brief Dirty blocks survive failed write backs and go out once the backend recovers. */
+static void write_fail_test(void)
+{
+    uint8_t buff[BLK_SIZE];
+
+    disk_reset();
+    TEST_CHECK(nrf_blk_dev_init(nrf_block_dev_cache_ops_get(&m_cache), NULL, NULL) == NRF_SUCCESS);
+
+    TEST_CHECK(blk_write(&m_cache, 1, 1, 0xE1) == NRF_SUCCESS);
+    m_write_fail = true;
+
+    TEST_CHECK(cache_flush(&m_cache) != NRF_SUCCESS);
+    TEST_CHECK(nrf_blk_dev_uninit(nrf_block_dev_cache_ops_get(&m_cache)) != NRF_SUCCESS);
+
+    // Line 0 is the one to replace, the read fails instead of dropping it.
+    TEST_CHECK(blk_read(&m_cache, 4, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_read(&m_cache, 8, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_read(&m_cache, 12, 1, buff) != NRF_SUCCESS);
+    TEST_CHECK(blk_read(&m_cache, 1, 1, buff) == NRF_SUCCESS);
+    TEST_CHECK(blk_holds(buff, 0xE1));
+    TEST_CHECK(blk_holds(m_disk[1], 1));
+
+    m_write_fail = false;
+    m_req_cnt    = 0;
+    TEST_CHECK(nrf_blk_dev_uninit(nrf_block_dev_cache_ops_get(&m_cache)) == NRF_SUCCESS);
+    TEST_CHECK(m_req_cnt == 1);
+    TEST_CHECK(req_is(0, 'W', 1, 1));
+    TEST_CHECK(blk_holds(m_disk[1], 0xE1));
+    TEST_CHECK(!m_out_of_range);
+}
+
+void block_dev_cache_test(void)
+{
+    lru_test();
+    write_back_test();
+    read_ahead_test();
+    write_fail_test();
+}
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Tests and benchmark of the CRC-32 implementations.
+ *
+ * crc32.c is built once per CRC32_CONFIG_ALGORITHM, with crc32_compute() renamed after the
+ * implementation, see the Makefile. The bitwise build is the original code and serves as
+ * the reference for the others.
+ */
+#include <string.h>
+#include "lib_test.h"
+#include "sdk_common.h"
+
+uint32_t crc32_compute_bitwise(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+uint32_t crc32_compute_table(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+uint32_t crc32_compute_slicing_by_4(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+uint32_t crc32_compute_slicing_by_8(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+
+typedef uint32_t (* crc32_fn_t)(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+
+static const struct
+{
+    char const * p_name;
+    crc32_fn_t   compute;
+} m_impls[] =
+{
+    { "bitwise",      crc32_compute_bitwise      },
+    { "table",        crc32_compute_table        },
+    { "slicing_by_4", crc32_compute_slicing_by_4 },
+    { "slicing_by_8", crc32_compute_slicing_by_8 },
+};
+
+#define RANDOM_RUNS     2000
+#define RANDOM_SIZE_MAX 1024
+#define BENCH_SIZE      (64 * 1024)
+#define BENCH_PASSES    64
+
+/* CRC-32 (ISO-HDLC) check value of "123456789". */
+#define CRC32_CHECK     0xCBF43926U
+
+void crc32_test(void)
+{
+    static uint8_t buf[RANDOM_SIZE_MAX + 8];
+    uint32_t       seed = 0x12345678;
+
+    for (size_t i = 0; i < ARRAY_SIZE(m_impls); ++i)
+    {
+        uint32_t crc;
+
+        TEST_CHECK(m_impls[i].compute((uint8_t const *)"123456789", 9, NULL) == CRC32_CHECK);
+
+        // The same check value, computed in two parts.
+        crc = m_impls[i].compute((uint8_t const *)"1234", 4, NULL);
+        TEST_CHECK(m_impls[i].compute((uint8_t const *)"56789", 5, &crc) == CRC32_CHECK);
+
+        TEST_CHECK(m_impls[i].compute(buf, 0, NULL) == 0);
+    }
+
+    // Random sizes, alignments and split points against the bitwise reference.
+    for (unsigned run = 0; run < RANDOM_RUNS; ++run)
+    {
+        uint32_t const size   = lib_test_rand(&seed) % (RANDOM_SIZE_MAX + 1);
+        uint32_t const offset = lib_test_rand(&seed) % 8;
+        uint32_t const split  = lib_test_rand(&seed) % (size + 1);
+        uint8_t const * const p_data = &buf[offset];
+
+        lib_test_rand_fill(&seed, buf, sizeof(buf));
+
+        uint32_t const expected = crc32_compute_bitwise(p_data, size, NULL);
+
+        for (size_t i = 1; i < ARRAY_SIZE(m_impls); ++i)
+        {
+            uint32_t crc = m_impls[i].compute(p_data, size, NULL);
+
+            if (crc != expected)
+            {
+                printf("  %s: size %u offset %u\n", m_impls[i].p_name, size, offset);
+            }
+            TEST_CHECK(crc == expected);
+
+            crc = m_impls[i].compute(p_data, split, NULL);
+            crc = m_impls[i].compute(p_data + split, size - split, &crc);
+            TEST_CHECK(crc == expected);
+        }
+    }
+}
+
+void crc32_bench(void)
+{
+    static uint8_t buf[BENCH_SIZE];
+    uint32_t       seed = 0x87654321;
+
+    lib_test_rand_fill(&seed, buf, sizeof(buf));
+
+    for (size_t i = 0; i < ARRAY_SIZE(m_impls); ++i)
+    {
+        struct timespec   start;
+        volatile uint32_t crc = 0;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (unsigned pass = 0; pass < BENCH_PASSES; ++pass)
+        {
+            crc = m_impls[i].compute(buf, sizeof(buf), NULL);
+        }
+        lib_test_bench_print(m_impls[i].p_name, sizeof(buf) * BENCH_PASSES,
+                             lib_test_ms_since(&start));
+        TEST_CHECK(crc == crc32_compute_bitwise(buf, sizeof(buf), NULL));
+    }
+}
@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Regression tests and benchmarks of SDK libraries, built for the host.
+ *
+ * Exits with a non-zero status if any check fails. The benchmark figures compare
+ * implementations of the same library with each other; they are host CPU speeds,
+ * not device speeds.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lib_test.h"
+#include "sdk_common.h"
+
+unsigned lib_test_failures;
+
+/* -------------------------------------------------------------------------
+ * Platform
+ */
+
+volatile uint32_t lib_test_primask;
+SCB_Type          lib_test_scb;
+NVIC_Type         lib_test_nvic;
+
+void NVIC_SystemReset(void)
+{
+    printf("  FAIL NVIC_SystemReset\n");
+    exit(EXIT_FAILURE);
+}
+
+void app_error_fault_handler(uint32_t id, uint32_t pc, uint32_t info)
+{
+    printf("  FAIL app_error_fault_handler(0x%08x)\n", (unsigned)id);
+    exit(EXIT_FAILURE);
+}
+
+/* -------------------------------------------------------------------------
+ * Helpers
+ */
+
+uint32_t lib_test_rand(uint32_t * p_state)
+{
+    uint32_t x = *p_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *p_state = x;
+    return x;
+}
+
+void lib_test_rand_fill(uint32_t * p_state, uint8_t * p_buf, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        p_buf[i] = (uint8_t)lib_test_rand(p_state);
+    }
+}
+
+double lib_test_ms_since(struct timespec const * p_start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - p_start->tv_sec) * 1e3 + (now.tv_nsec - p_start->tv_nsec) / 1e6;
+}
+
+void lib_test_bench_print(char const * p_name, size_t bytes, double ms)
+{
+    printf("  %-20s %8zu bytes in %8.2f ms, %8.2f MB/s\n",
+           p_name, bytes, ms, (ms > 0) ? (bytes / 1e3 / ms) : 0.0);
+}
+
+/* -------------------------------------------------------------------------
+ * Main
+ */
+
+int main(int argc, char * argv[])
+{
+    static const struct
+    {
+        char const * p_name;
+        void      (* test)(void);
+    } tests[] =
+    {
+        { "block_dev_cache", block_dev_cache_test },
+        { "crc16",       crc16_test  },
+        { "crc16 bench", crc16_bench },
+        { "crc32",       crc32_test  },
+        { "crc32 bench", crc32_bench },
+        { "log",         log_test    },
+        { "sha256",       sha256_test  },
+        { "sha256 bench", sha256_bench },
+    };
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    for (size_t i = 0; i < ARRAY_SIZE(tests); ++i)
+    {
+        unsigned failures = lib_test_failures;
+
+        // An optional argument selects the tests whose name starts with it.
+        if ((argc > 1) && (strncmp(tests[i].p_name, argv[1], strlen(argv[1])) != 0))
+        {
+            continue;
+        }
+        printf("%s\n", tests[i].p_name);
+        tests[i].test();
+        printf("  %s\n", (failures == lib_test_failures) ? "ok" : "FAILED");
+    }
+    printf("%u failure(s)\n", lib_test_failures);
+    return (lib_test_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
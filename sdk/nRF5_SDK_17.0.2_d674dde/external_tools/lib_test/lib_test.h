@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Shared helpers of the library regression tests and benchmarks.
+ */
+#ifndef LIB_TEST_H__
+#define LIB_TEST_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of failed checks so far. */
+extern unsigned lib_test_failures;
+
+/** @brief Reports a failed check and leaves the test function. */
+#define TEST_CHECK(cond)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);           \
+            ++lib_test_failures;                                                \
+            return;                                                             \
+        }                                                                       \
+    } while (0)
+
+/**
+ * @brief Returns the next value of a xorshift32 generator.
+ *
+ * The tests use a fixed seed, so that a failure can be reproduced.
+ *
+ * @param[in,out] p_state  Generator state, must not be zero.
+ */
+uint32_t lib_test_rand(uint32_t * p_state);
+
+/** @brief Fills a buffer from @ref lib_test_rand. */
+void lib_test_rand_fill(uint32_t * p_state, uint8_t * p_buf, size_t size);
+
+/** @brief Returns the milliseconds elapsed since @p p_start. */
+double lib_test_ms_since(struct timespec const * p_start);
+
+/** @brief Prints a benchmark result. */
+void lib_test_bench_print(char const * p_name, size_t bytes, double ms);
+
+void block_dev_cache_test(void);
+void crc16_test(void);
+void crc16_bench(void);
+void crc32_test(void);
+void crc32_bench(void);
+void log_test(void);
+void sha256_test(void);
+void sha256_bench(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIB_TEST_H__
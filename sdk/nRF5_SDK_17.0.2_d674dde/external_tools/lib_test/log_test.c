@@ -0,0 +1,491 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Tests of the logger frontend buffer allocation under preemption.
+ *
+ * nrf_atomic.c is built with the operations used by buf_prealloc() renamed, see the
+ * Makefile. The wrappers below call a preemption point before and after each operation,
+ * where a test can run an "interrupt" that logs, or logs and flushes, in the middle of
+ * another entry. Every preemption point of the outer entry is tried in turn.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "lib_test.h"
+#include "sdk_common.h"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+#include "nrf_log_internal.h"
+#include "nrf_log_backend_interface.h"
+#include "nrf_memobj.h"
+#include "nrf_atomic.h"
+
+#define SEVERITY        NRF_LOG_SEVERITY_INFO
+#define ENTRY_ARGS_MAX  4
+#define ENTRIES_MAX     (NRF_LOG_BUFSIZE / sizeof(uint32_t))
+#define PREEMPT_MAX     64
+
+/* -------------------------------------------------------------------------
+ * Preemption points
+ */
+
+uint32_t nrf_atomic_u32_add_impl(nrf_atomic_u32_t * p_data, uint32_t value);
+uint32_t nrf_atomic_u32_sub_impl(nrf_atomic_u32_t * p_data, uint32_t value);
+bool     nrf_atomic_u32_cmp_exch_impl(nrf_atomic_u32_t * p_data,
+                                      uint32_t         * p_expected,
+                                      uint32_t           desired);
+
+static void  (* m_preempt_handler)(void);   // Interrupt to run, NULL once it has run.
+static unsigned m_preempt_at;               // Preemption point at which it runs, from 1.
+static unsigned m_preempt_cnt;              // Preemption points passed, not counting the interrupt.
+
+static void preempt_point(void)
+{
+    if ((++m_preempt_cnt == m_preempt_at) && (m_preempt_handler != NULL))
+    {
+        void  (* handler)(void) = m_preempt_handler;
+        unsigned preempt_cnt    = m_preempt_cnt;
+
+        // The interrupt does not preempt itself.
+        m_preempt_handler = NULL;
+        handler();
+        m_preempt_cnt = preempt_cnt;
+    }
+}
+
+uint32_t nrf_atomic_u32_add(nrf_atomic_u32_t * p_data, uint32_t value)
+{
+    preempt_point();
+    uint32_t ret = nrf_atomic_u32_add_impl(p_data, value);
+    preempt_point();
+    return ret;
+}
+
+uint32_t nrf_atomic_u32_sub(nrf_atomic_u32_t * p_data, uint32_t value)
+{
+    preempt_point();
+    uint32_t ret = nrf_atomic_u32_sub_impl(p_data, value);
+    preempt_point();
+    return ret;
+}
+
+bool nrf_atomic_u32_cmp_exch(nrf_atomic_u32_t * p_data, uint32_t * p_expected, uint32_t desired)
+{
+    preempt_point();
+    bool ret = nrf_atomic_u32_cmp_exch_impl(p_data, p_expected, desired);
+    preempt_point();
+    return ret;
+}
+
+/* -------------------------------------------------------------------------
+ * Memory objects
+ *
+ * nrf_memobj.c keeps a pointer in a 32-bit chunk header and does not build for a
+ * 64-bit host. The frontend copies each processed entry into a memory object, so the
+ * objects are kept here in one heap block each.
+ */
+
+typedef struct
+{
+    uint32_t user_cnt;
+    size_t   size;
+    uint8_t  data[];
+} memobj_t;
+
+static unsigned m_memobj_cnt;   // Objects not freed yet.
+
+ret_code_t nrf_memobj_pool_init(nrf_memobj_pool_t const * p_pool)
+{
+    UNUSED_PARAMETER(p_pool);
+    return NRF_SUCCESS;
+}
+
+nrf_memobj_t * nrf_memobj_alloc(nrf_memobj_pool_t const * p_pool, size_t size)
+{
+    UNUSED_PARAMETER(p_pool);
+    memobj_t * p_obj = malloc(sizeof(memobj_t) + size);
+
+    if (p_obj != NULL)
+    {
+        p_obj->user_cnt = 0;
+        p_obj->size     = size;
+        m_memobj_cnt++;
+    }
+    return (nrf_memobj_t *)p_obj;
+}
+
+void nrf_memobj_free(nrf_memobj_t * p_obj)
+{
+    m_memobj_cnt--;
+    free(p_obj);
+}
+
+void nrf_memobj_get(nrf_memobj_t const * p_obj)
+{
+    ((memobj_t *)p_obj)->user_cnt++;
+}
+
+void nrf_memobj_put(nrf_memobj_t * p_obj)
+{
+    memobj_t * p_memobj = (memobj_t *)p_obj;
+
+    TEST_CHECK(p_memobj->user_cnt != 0);
+    if (--p_memobj->user_cnt == 0)
+    {
+        nrf_memobj_free(p_obj);
+    }
+}
+
+void nrf_memobj_write(nrf_memobj_t * p_obj, void * p_data, size_t len, size_t offset)
+{
+    memobj_t * p_memobj = (memobj_t *)p_obj;
+
+    TEST_CHECK(offset + len <= p_memobj->size);
+    memcpy(&p_memobj->data[offset], p_data, len);
+}
+
+void nrf_memobj_read(nrf_memobj_t * p_obj, void * p_data, size_t len, size_t offset)
+{
+    memobj_t * p_memobj = (memobj_t *)p_obj;
+
+    TEST_CHECK(offset + len <= p_memobj->size);
+    memcpy(p_data, &p_memobj->data[offset], len);
+}
+
+/* -------------------------------------------------------------------------
+ * Backend recording the processed entries
+ */
+
+#define DUMP_ADDR       (STD_ADDR_MASK + 1)   // Address of hexdump entries, never a string's.
+
+typedef struct
+{
+    uint32_t addr;                  // String address, or DUMP_ADDR.
+    uint32_t nargs;                 // Number of arguments, or of recorded hexdump words.
+    uint32_t args[ENTRY_ARGS_MAX];
+    uint32_t dropped;
+} entry_t;
+
+static entry_t  m_entries[ENTRIES_MAX];
+static unsigned m_entry_cnt;
+static unsigned m_bad_entry_cnt;
+
+static void backend_put(nrf_log_backend_t const * p_backend, nrf_log_entry_t * p_msg)
+{
+    nrf_log_header_t header;
+    entry_t          entry = { 0 };
+
+    nrf_memobj_get(p_msg);
+    nrf_memobj_read(p_msg, &header, HEADER_SIZE * sizeof(uint32_t), 0);
+
+    if ((header.base.generic.type == HEADER_TYPE_STD) &&
+        (header.base.std.nargs <= ENTRY_ARGS_MAX))
+    {
+        entry.addr  = header.base.std.addr;
+        entry.nargs = header.base.std.nargs;
+    }
+    else if ((header.base.generic.type == HEADER_TYPE_HEXDUMP) &&
+             (header.base.hexdump.len >= ENTRY_ARGS_MAX * sizeof(uint32_t)))
+    {
+        entry.addr  = DUMP_ADDR;
+        entry.nargs = ENTRY_ARGS_MAX;
+    }
+    else
+    {
+        m_bad_entry_cnt++;
+    }
+
+    if ((entry.addr != 0) && (m_entry_cnt < ARRAY_SIZE(m_entries)))
+    {
+        entry.dropped = header.dropped;
+        nrf_memobj_read(p_msg, entry.args, entry.nargs * sizeof(uint32_t),
+                        HEADER_SIZE * sizeof(uint32_t));
+        m_entries[m_entry_cnt++] = entry;
+    }
+
+    nrf_memobj_put(p_msg);
+}
+
+static void backend_panic_set(nrf_log_backend_t const * p_backend)
+{
+}
+
+static void backend_flush(nrf_log_backend_t const * p_backend)
+{
+}
+
+static const nrf_log_backend_api_t m_backend_api =
+{
+    .put       = backend_put,
+    .panic_set = backend_panic_set,
+    .flush     = backend_flush,
+};
+
+NRF_LOG_BACKEND_DEF(m_backend, m_backend_api, NULL);
+
+/* -------------------------------------------------------------------------
+ * Tests
+ */
+
+typedef struct
+{
+    void         (* log)(void);
+    uint32_t        addr;
+    uint32_t        nargs;
+    uint32_t const * p_args;
+} outer_t;
+
+static char const m_outer_str[]  = "outer %d %d";
+static char const m_inner_str[]  = "inner %d";
+static char const m_filler_str[] = "filler %d %d %d %d";
+static char const m_tail_str[]   = "tail";
+
+static const uint32_t m_outer_args[]  = { 1, 2 };
+static const uint32_t m_inner_args[]  = { 7 };
+static const uint32_t m_filler_args[] = { 3, 4, 5, 6 };
+
+// Hexdump leaving less room than an inner entry needs.
+static uint32_t m_dump[ENTRIES_MAX - 2 * HEADER_SIZE];
+
+static uint32_t str_addr(char const * p_str)
+{
+    return (uint32_t)(uintptr_t)p_str & STD_ADDR_MASK;
+}
+
+static void flush(void)
+{
+    while (nrf_log_frontend_dequeue())
+    {
+    }
+}
+
+static void outer_std_log(void)
+{
+    nrf_log_frontend_std_2(SEVERITY, m_outer_str, 1, 2);
+}
+
+static void outer_dump_log(void)
+{
+    nrf_log_frontend_hexdump(SEVERITY, m_dump, sizeof(m_dump));
+}
+
+static void inner_log(void)
+{
+    nrf_log_frontend_std_1(SEVERITY, m_inner_str, 7);
+}
+
+static void inner_log_flush(void)
+{
+    inner_log();
+    flush();
+}
+
+static void fault_log(void)
+{
+    nrf_log_panic();
+    inner_log();
+    // A fault handler may not return, the entry must be out by now.
+    TEST_CHECK(m_entry_cnt == 1);
+}
+
+/** @brief Returns the number of entries logged at @p addr, checking their arguments. */
+static unsigned entry_count(uint32_t addr, uint32_t nargs, uint32_t const * p_args,
+                            bool * p_args_ok)
+{
+    unsigned cnt = 0;
+
+    for (unsigned i = 0; i < m_entry_cnt; ++i)
+    {
+        if (m_entries[i].addr == addr)
+        {
+            cnt++;
+            if ((m_entries[i].nargs != nargs) ||
+                ((nargs != 0) && (memcmp(m_entries[i].args, p_args, nargs * sizeof(uint32_t)) != 0)))
+            {
+                *p_args_ok = false;
+            }
+        }
+    }
+    return cnt;
+}
+
+/**
+ * @brief Logs an outer entry after @p filler_cnt filler entries, with an interrupt
+ *        at every preemption point in turn, and checks what the backend receives.
+ *
+ * Filler entries may be skipped to make room. The inner entry must be received or counted
+ * as dropped. The outer entry must be received, unless the interrupt comes after the last
+ * preemption point, when the outer entry is complete and may be skipped to make room for
+ * the inner one. A tail entry, logged after the outer one, carries the drops that happen
+ * after the outer entry has taken the dropped count. No other entry may appear.
+ */
+static void preempt_check(outer_t const * p_outer, void (* handler)(void), uint32_t filler_cnt)
+{
+    uint32_t const inner_addr  = str_addr(m_inner_str);
+    uint32_t const filler_addr = str_addr(m_filler_str);
+    uint32_t const tail_addr   = str_addr(m_tail_str);
+    unsigned       point;
+
+    for (point = 1; point <= PREEMPT_MAX; ++point)
+    {
+        uint32_t dropped = 0;
+        bool     args_ok = true;
+        bool     preempted;
+        bool     outer_done;
+        unsigned outer_cnt;
+        unsigned inner_cnt;
+        unsigned filler_cnt_rx;
+        unsigned tail_cnt;
+
+        flush();
+        m_entry_cnt     = 0;
+        m_bad_entry_cnt = 0;
+
+        for (uint32_t i = 0; i < filler_cnt; ++i)
+        {
+            nrf_log_frontend_std_4(SEVERITY, m_filler_str, 3, 4, 5, 6);
+        }
+
+        m_preempt_cnt     = 0;
+        m_preempt_at      = point;
+        m_preempt_handler = handler;
+        p_outer->log();
+        preempted         = (m_preempt_handler == NULL);
+        outer_done        = (point == m_preempt_cnt);
+        m_preempt_handler = NULL;
+
+        flush();
+        nrf_log_frontend_std_0(SEVERITY, m_tail_str);
+        flush();
+        TEST_CHECK(m_memobj_cnt == 0);
+
+        for (unsigned i = 0; i < m_entry_cnt; ++i)
+        {
+            dropped += m_entries[i].dropped;
+        }
+
+        outer_cnt     = entry_count(p_outer->addr, p_outer->nargs, p_outer->p_args, &args_ok);
+        inner_cnt     = entry_count(inner_addr, 1, m_inner_args, &args_ok);
+        filler_cnt_rx = entry_count(filler_addr, 4, m_filler_args, &args_ok);
+        tail_cnt      = entry_count(tail_addr, 0, NULL, &args_ok);
+        if ((m_bad_entry_cnt != 0) ||
+            ((outer_cnt != 1) && !(outer_done && (outer_cnt == 0) && (dropped != 0))) ||
+            (preempted && (inner_cnt != 1) && (dropped == 0)) ||
+            (tail_cnt != 1) ||
+            (outer_cnt + inner_cnt + filler_cnt_rx + tail_cnt != m_entry_cnt) ||
+            !args_ok)
+        {
+            printf("  preemption point %u, %u fillers\n", point, filler_cnt);
+        }
+        TEST_CHECK(m_bad_entry_cnt == 0);
+        TEST_CHECK((outer_cnt == 1) || (outer_done && (outer_cnt == 0) && (dropped != 0)));
+        TEST_CHECK(!preempted || (inner_cnt == 1) || (dropped != 0));
+        TEST_CHECK(tail_cnt == 1);
+        TEST_CHECK(outer_cnt + inner_cnt + filler_cnt_rx + tail_cnt == m_entry_cnt);
+        TEST_CHECK(args_ok);
+
+        if (!preempted)
+        {
+            break;
+        }
+    }
+    // All preemption points of the outer entry were tried.
+    TEST_CHECK(point < PREEMPT_MAX);
+}
+
+void log_test(void)
+{
+    uint32_t const filler_max = ENTRIES_MAX / (HEADER_SIZE + 4);
+    outer_t  const outer_std  =
+    {
+        .log    = outer_std_log,
+        .addr   = str_addr(m_outer_str),
+        .nargs  = ARRAY_SIZE(m_outer_args),
+        .p_args = m_outer_args,
+    };
+    outer_t  const outer_dump =
+    {
+        .log    = outer_dump_log,
+        .addr   = DUMP_ADDR,
+        .nargs  = ENTRY_ARGS_MAX,
+        .p_args = m_dump,
+    };
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(m_dump); ++i)
+    {
+        m_dump[i] = 0x5A000000 + i;
+    }
+
+    TEST_CHECK(nrf_log_init(NULL, 0) == NRF_SUCCESS);
+    TEST_CHECK(nrf_log_backend_add(&m_backend, NRF_LOG_SEVERITY_DEBUG) >= 0);
+    nrf_log_backend_enable(&m_backend);
+
+    // Plenty of room: both entries are kept whatever the interleaving.
+    preempt_check(&outer_std, inner_log, 0);
+    preempt_check(&outer_std, inner_log_flush, 0);
+
+    // From room for both entries, to the outer entry skipping fillers.
+    for (uint32_t filler_cnt = filler_max - 2; filler_cnt <= filler_max + 1; ++filler_cnt)
+    {
+        preempt_check(&outer_std, inner_log, filler_cnt);
+        preempt_check(&outer_std, inner_log_flush, filler_cnt);
+    }
+
+    // No room for the inner entry once the outer one is claimed, with nothing to skip but
+    // the outer entry.
+    for (uint32_t filler_cnt = 0; filler_cnt <= 2; ++filler_cnt)
+    {
+        preempt_check(&outer_dump, inner_log, filler_cnt);
+        preempt_check(&outer_dump, inner_log_flush, filler_cnt);
+    }
+
+    // A fault handler preempting an entry gets its own entry out. Panic mode is never left,
+    // so this goes last.
+    flush();
+    m_entry_cnt       = 0;
+    m_preempt_cnt     = 0;
+    m_preempt_at      = 2;
+    m_preempt_handler = fault_log;
+    outer_std_log();
+    TEST_CHECK(m_preempt_handler == NULL);
+    TEST_CHECK(m_entry_cnt == 2);
+    TEST_CHECK(m_entries[0].addr == str_addr(m_inner_str));
+    TEST_CHECK(m_entries[1].addr == str_addr(m_outer_str));
+}
@@ -0,0 +1,199 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Tests and benchmark of the SHA-256 library.
+ *
+ * Uses the FIPS 180-4 example messages. Each message is also hashed in pieces split at
+ * every block boundary case, and from unaligned buffers, to cover the buffered and the
+ * direct paths of sha256_update().
+ */
+#include <string.h>
+#include "lib_test.h"
+#include "sdk_common.h"
+#include "sha256.h"
+
+#define MILLION_A_SIZE  1000000
+#define BENCH_SIZE      (64 * 1024)
+#define BENCH_PASSES    16
+
+static const struct
+{
+    char const * p_msg;
+    uint8_t      digest[32];
+} m_vectors[] =
+{
+    {
+        "",
+        { 0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+          0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55 }
+    },
+    {
+        "abc",
+        { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+          0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad }
+    },
+    {
+        // 448 bits: the padding does not fit in the last block.
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        { 0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+          0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1 }
+    },
+    {
+        // 896 bits.
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+        { 0xcf, 0x5b, 0x16, 0xa7, 0x78, 0xaf, 0x83, 0x80, 0x03, 0x6c, 0xe5, 0x9e, 0x7b, 0x04, 0x92, 0x37,
+          0x0b, 0x24, 0x9b, 0x11, 0xe8, 0xf0, 0x7a, 0x51, 0xaf, 0xac, 0x45, 0x03, 0x7a, 0xfe, 0xe9, 0xd1 }
+    },
+};
+
+/* SHA-256 of one million repetitions of 'a'. */
+static const uint8_t m_million_a_digest[32] =
+{
+    0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+    0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+};
+
+/**
+ * @brief Hashes a message in pieces of the given sizes, repeated until the message ends.
+ *
+ * The message is copied to @p offset bytes past a word boundary first.
+ */
+static bool sha256_split_check(uint8_t const * p_msg, size_t size, size_t offset,
+                               size_t const * p_pieces, size_t piece_cnt,
+                               uint8_t const * p_digest)
+{
+    static uint8_t   buf[MILLION_A_SIZE + 8];
+    sha256_context_t ctx;
+    uint8_t          hash[32];
+    size_t           pos = 0;
+
+    memcpy(&buf[offset], p_msg, size);
+    if (sha256_init(&ctx) != NRF_SUCCESS)
+    {
+        return false;
+    }
+    for (size_t i = 0; pos < size; i = (i + 1) % piece_cnt)
+    {
+        size_t const len = MIN(p_pieces[i], size - pos);
+
+        if (sha256_update(&ctx, &buf[offset + pos], len) != NRF_SUCCESS)
+        {
+            return false;
+        }
+        pos += len;
+    }
+    if (sha256_final(&ctx, hash, false) != NRF_SUCCESS)
+    {
+        return false;
+    }
+    return memcmp(hash, p_digest, sizeof(hash)) == 0;
+}
+
+void sha256_test(void)
+{
+    static uint8_t   million_a[MILLION_A_SIZE];
+    static const size_t whole[]  = { SIZE_MAX };
+    static const size_t bytes[]  = { 1 };
+    static const size_t mixed[]  = { 1, 63, 64, 65, 2, 127, 128, 1000, 3 };
+    sha256_context_t ctx;
+    uint8_t          hash[32];
+
+    for (size_t i = 0; i < ARRAY_SIZE(m_vectors); ++i)
+    {
+        uint8_t const * const p_msg = (uint8_t const *)m_vectors[i].p_msg;
+        size_t const          size  = strlen(m_vectors[i].p_msg);
+
+        TEST_CHECK(sha256_split_check(p_msg, size, 0, whole, 1, m_vectors[i].digest));
+        TEST_CHECK(sha256_split_check(p_msg, size, 1, bytes, 1, m_vectors[i].digest));
+
+        // Two pieces, split at every position.
+        for (size_t split = 0; split <= size; ++split)
+        {
+            size_t const pieces[] = { split, size - split };
+
+            for (size_t offset = 0; offset < 4; ++offset)
+            {
+                TEST_CHECK(sha256_split_check(p_msg, size, offset, pieces, 2,
+                                              m_vectors[i].digest));
+            }
+        }
+
+        // Little-endian output is the digest reversed.
+        TEST_CHECK(sha256_init(&ctx) == NRF_SUCCESS);
+        TEST_CHECK(sha256_update(&ctx, p_msg, size) == NRF_SUCCESS);
+        TEST_CHECK(sha256_final(&ctx, hash, true) == NRF_SUCCESS);
+        for (size_t j = 0; j < sizeof(hash); ++j)
+        {
+            TEST_CHECK(hash[j] == m_vectors[i].digest[sizeof(hash) - 1 - j]);
+        }
+    }
+
+    memset(million_a, 'a', sizeof(million_a));
+    TEST_CHECK(sha256_split_check(million_a, sizeof(million_a), 0, whole, 1,
+                                  m_million_a_digest));
+    TEST_CHECK(sha256_split_check(million_a, sizeof(million_a), 3, mixed, ARRAY_SIZE(mixed),
+                                  m_million_a_digest));
+
+    TEST_CHECK(sha256_init(NULL) == NRF_ERROR_NULL);
+    TEST_CHECK(sha256_init(&ctx) == NRF_SUCCESS);
+    TEST_CHECK(sha256_update(&ctx, NULL, 1) == NRF_ERROR_NULL);
+    TEST_CHECK(sha256_update(&ctx, NULL, 0) == NRF_SUCCESS);
+}
+
+void sha256_bench(void)
+{
+    static uint8_t   buf[BENCH_SIZE];
+    uint32_t         seed = 0x0BADCAFE;
+    sha256_context_t ctx;
+    uint8_t          hash[32];
+    struct timespec  start;
+
+    lib_test_rand_fill(&seed, buf, sizeof(buf));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TEST_CHECK(sha256_init(&ctx) == NRF_SUCCESS);
+    for (unsigned pass = 0; pass < BENCH_PASSES; ++pass)
+    {
+        TEST_CHECK(sha256_update(&ctx, buf, sizeof(buf)) == NRF_SUCCESS);
+    }
+    TEST_CHECK(sha256_final(&ctx, hash, false) == NRF_SUCCESS);
+    lib_test_bench_print("sha256", sizeof(buf) * BENCH_PASSES, lib_test_ms_since(&start));
+}
@@ -0,0 +1,260 @@
+#!/usr/bin/env python3
+# Copyright (c) 2016 - 2020, Nordic Semiconductor ASA
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form, except as embedded into a Nordic
+#    Semiconductor ASA integrated circuit in a product or a software update for
+#    such product, must reproduce the above copyright notice, this list of
+#    conditions and the following disclaimer in the documentation and/or other
+#    materials provided with the distribution.
+#
+# 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+#    contributors may be used to endorse or promote products derived from this
+#    software without specific prior written permission.
+#
+# 4. This software, with or without modification, must only be used with a
+#    Nordic Semiconductor ASA integrated circuit.
+#
+# 5. Any software provided in binary form under this license must not be reverse
+#    engineered, decompiled, modified and/or disassembled.
+#
+# THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+# OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+# OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+"""Decoder for binary nrf_log output.
+
+Decodes the binary log stream written by the RTT backend (with NRF_LOG_BACKEND_RTT_BINARY set)
+or by the USB CDC ACM backend. Each entry is a logger header followed by its arguments or
+hexdump data, exactly as stored by nrf_log_frontend. Format strings and module names are
+resolved from the application ELF file.
+
+Usage:
+    nrf_log_decode.py app.elf log.bin
+    nrf_log_decode.py app.elf /dev/ttyACM0      (requires pyserial)
+    JLinkRTTLogger ... -  | nrf_log_decode.py app.elf -
+
+Requires pyelftools.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+HEADER_TYPE_STD = 1
+HEADER_TYPE_HEXDUMP = 2
+
+STD_ADDR_MASK = (1 << 22) - 1
+
+SEVERITY_NAMES = ['', 'error', 'warning', 'info', 'debug']
+
+# printf conversion: flags, width, precision, length modifier, conversion.
+FORMAT_SPEC = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcspn%])')
+
+
+class Image:
+    """Read-only view of the loadable sections of the application ELF file."""
+
+    def __init__(self, path):
+        self._file = open(path, 'rb')
+        self._elf = ELFFile(self._file)
+        self._sections = [s for s in self._elf.iter_sections()
+                          if s['sh_addr'] != 0 or s['sh_flags'] & 0x2]
+        self.modules = self._modules_get()
+
+    def read(self, addr, size):
+        for section in self._sections:
+            start = section['sh_addr']
+            if section['sh_type'] != 'SHT_NOBITS' and start <= addr < start + section['sh_size']:
+                offset = addr - start
+                return section.data()[offset:offset + size]
+        return None
+
+    def string(self, addr):
+        data = self.read(addr, 256)
+        if data is None:
+            return None
+        return data.split(b'\0', 1)[0].decode('utf-8', 'replace')
+
+    def _modules_get(self):
+        """Module names, indexed by module ID.
+
+        The module ID is the index of the module in the log_const_data section, which
+        holds one nrf_log_module_const_data_t per module.
+        """
+        section = next((s for s in self._elf.iter_sections()
+                        if 'log_const_data' in s.name), None)
+        symtab = next((s for s in self._elf.iter_sections()
+                       if isinstance(s, SymbolTableSection)), None)
+        if section is None or symtab is None:
+            return []
+
+        start = section['sh_addr']
+        end = start + section['sh_size']
+        entries = sorted((sym['st_value'], sym['st_size']) for sym in symtab.iter_symbols()
+                         if start <= sym['st_value'] < end and sym['st_size'] > 0)
+        if not entries:
+            return []
+
+        item_size = entries[0][1]
+        data = section.data()
+        names = []
+        for offset in range(0, len(data) - item_size + 1, item_size):
+            (p_name,) = struct.unpack_from('<I', data, offset)
+            names.append(self.string(p_name) or '?')
+        return names
+
+
+def format_message(image, fmt, args):
+    """Format a printf-style string with 32-bit logger arguments."""
+    args = list(args)
+    out = []
+    pos = 0
+    for match in FORMAT_SPEC.finditer(fmt):
+        out.append(fmt[pos:match.start()])
+        pos = match.end()
+        flags, width, precision, _, conv = match.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        value = args.pop(0) if args else 0
+        spec = '%' + flags + width + ('.' + precision if precision else '')
+        if conv in 'di':
+            value = struct.unpack('<i', struct.pack('<I', value))[0]
+            out.append((spec + 'd') % value)
+        elif conv in 'ouxX':
+            out.append((spec + conv) % value)
+        elif conv == 'c':
+            out.append((spec + 'c') % chr(value & 0xFF))
+        elif conv == 'p':
+            out.append('0x%08x' % value)
+        elif conv == 's':
+            # Strings in RAM (for example pushed with NRF_LOG_PUSH) are not available on the host.
+            string = image.string(value)
+            out.append((spec + 's') % (string if string is not None else '<0x%08x>' % value))
+        else:
+            out.append(match.group(0))
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+class Decoder:
+    """Stream decoder for logger entries."""
+
+    def __init__(self, image, timestamp, frequency):
+        self.image = image
+        self.header_words = 3 if timestamp else 2
+        self.timestamp = timestamp
+        self.frequency = frequency
+        self.buffer = b''
+
+    def _prefix(self, module_id, severity, timestamp, dropped):
+        modules = self.image.modules
+        module = modules[module_id] if module_id < len(modules) else 'module%d' % module_id
+        prefix = ''
+        if dropped:
+            prefix += '(%d entries dropped)\n' % dropped
+        if self.timestamp:
+            if self.frequency:
+                prefix += '[%12.6f] ' % (timestamp / self.frequency)
+            else:
+                prefix += '[%08d] ' % timestamp
+        name = SEVERITY_NAMES[severity] if severity < len(SEVERITY_NAMES) else str(severity)
+        return prefix + '<%s> %s: ' % (name, module)
+
+    def feed(self, data):
+        """Decode as many complete entries as possible. Returns a list of lines."""
+        self.buffer += data
+        lines = []
+        header_size = self.header_words * 4
+        while len(self.buffer) >= header_size:
+            words = struct.unpack_from('<%dI' % self.header_words, self.buffer)
+            base = words[0]
+            entry_type = base & 0x3
+            severity = (base >> 3) & 0x7
+            module_id = words[1] & 0xFFFF
+            dropped = words[1] >> 16
+            timestamp = words[2] if self.timestamp else 0
+
+            if entry_type == HEADER_TYPE_STD:
+                nargs = (base >> 6) & 0xF
+                size = header_size + nargs * 4
+                if len(self.buffer) < size:
+                    break
+                args = struct.unpack_from('<%dI' % nargs, self.buffer, header_size)
+                fmt = self.image.string((base >> 10) & STD_ADDR_MASK)
+                if fmt is None:
+                    # Not a valid entry. Resynchronize on the next word.
+                    self.buffer = self.buffer[4:]
+                    continue
+                message = format_message(self.image, fmt, args)
+            elif entry_type == HEADER_TYPE_HEXDUMP:
+                length = base >> 22
+                size = header_size + length
+                if len(self.buffer) < size:
+                    break
+                data = self.buffer[header_size:size]
+                message = ' '.join('%02x' % b for b in data)
+            else:
+                self.buffer = self.buffer[4:]
+                continue
+
+            lines.append(self._prefix(module_id, severity, timestamp, dropped) + message)
+            self.buffer = self.buffer[size:]
+        return lines
+
+
+def source_open(path):
+    if path == '-':
+        return sys.stdin.buffer
+    if path.startswith('/dev/') or path.upper().startswith('COM'):
+        import serial
+        return serial.Serial(path, timeout=0.1)
+    return open(path, 'rb')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode binary nrf_log output.')
+    parser.add_argument('elf', help='application ELF file')
+    parser.add_argument('input', help='binary log file, serial port, or - for stdin')
+    parser.add_argument('--timestamp', action='store_true',
+                        help='entries contain a timestamp (NRF_LOG_USES_TIMESTAMP)')
+    parser.add_argument('--frequency', type=int, default=0,
+                        help='timestamp frequency in Hz; raw ticks are printed if omitted')
+    args = parser.parse_args()
+
+    decoder = Decoder(Image(args.elf), args.timestamp, args.frequency)
+    source = source_open(args.input)
+    try:
+        while True:
+            data = source.read(256)
+            if not data:
+                if hasattr(source, 'in_waiting'):
+                    continue
+                break
+            for line in decoder.feed(data):
+                print(line, flush=True)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
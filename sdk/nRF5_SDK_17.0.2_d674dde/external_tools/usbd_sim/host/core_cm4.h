@@ -0,0 +1,232 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Cortex-M4 core definitions for the host build.
+ *
+ * Stands in for the CMSIS core header included by the device header. Barriers
+ * and interrupt masking map to host equivalents. The NVIC and the core
+ * peripherals are plain variables, so the SDK code that touches them runs
+ * unchanged.
+ */
+#ifndef USBD_SIM_CORE_CM4_H__
+#define USBD_SIM_CORE_CM4_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __CORTEX_M              (4U)
+
+#define __I                     volatile const
+#define __O                     volatile
+#define __IO                    volatile
+#define __IM                    volatile const
+#define __OM                    volatile
+#define __IOM                   volatile
+
+#ifndef __ASM
+#define __ASM                   __asm
+#endif
+#ifndef __INLINE
+#define __INLINE                inline
+#endif
+#define __STATIC_INLINE         static inline
+#define __STATIC_FORCEINLINE    __attribute__((always_inline)) static inline
+#define __NO_RETURN             __attribute__((__noreturn__))
+#define __USED                  __attribute__((used))
+#ifndef __WEAK
+#define __WEAK                  __attribute__((weak))
+#endif
+#ifndef __PACKED
+#define __PACKED                __attribute__((packed, aligned(1)))
+#endif
+#define __PACKED_STRUCT         struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION          union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)            __attribute__((aligned(x)))
+#define __RESTRICT              __restrict
+#define __COMPILER_BARRIER()    __asm volatile("" ::: "memory")
+
+/** @brief Simulated PRIMASK, set while interrupts are masked. */
+extern volatile uint32_t usbd_sim_primask;
+
+/** @brief Exception number of the running "interrupt", 0 in thread mode. */
+extern volatile uint32_t usbd_sim_ipsr;
+
+/** @brief Runs the pending interrupts that are allowed to preempt, see usbd_sim.h. */
+void usbd_sim_irq_dispatch(void);
+
+__STATIC_FORCEINLINE void __ISB(void) { __sync_synchronize(); }
+__STATIC_FORCEINLINE void __DSB(void) { __sync_synchronize(); }
+__STATIC_FORCEINLINE void __DMB(void) { __sync_synchronize(); }
+__STATIC_FORCEINLINE void __NOP(void) { }
+__STATIC_FORCEINLINE void __WFE(void) { }
+__STATIC_FORCEINLINE void __WFI(void) { }
+__STATIC_FORCEINLINE void __SEV(void) { }
+
+__STATIC_FORCEINLINE void     __disable_irq(void)        { usbd_sim_primask = 1; __COMPILER_BARRIER(); }
+__STATIC_FORCEINLINE void     __enable_irq(void)         { __COMPILER_BARRIER(); usbd_sim_primask = 0; usbd_sim_irq_dispatch(); }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)        { return usbd_sim_primask; }
+__STATIC_FORCEINLINE void     __set_PRIMASK(uint32_t pm) { usbd_sim_primask = pm; usbd_sim_irq_dispatch(); }
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void)           { return usbd_sim_ipsr; }
+__STATIC_FORCEINLINE uint32_t __get_CONTROL(void)        { return 0; }
+
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value)      { return __builtin_bswap32(value); }
+__STATIC_FORCEINLINE uint8_t  __CLZ(uint32_t value)      { return (value == 0) ? 32U : (uint8_t)__builtin_clz(value); }
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
+{
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < 32; i++)
+    {
+        result = (result << 1) | (value & 1U);
+        value >>= 1;
+    }
+    return result;
+}
+
+/** @brief System Control Block, only the registers read by the SDK. */
+typedef struct
+{
+    __IM  uint32_t CPUID;
+    __IOM uint32_t ICSR;
+    __IOM uint32_t VTOR;
+    __IOM uint32_t AIRCR;
+    __IOM uint32_t SCR;
+    __IOM uint32_t CCR;
+} SCB_Type;
+
+#define SCB_ICSR_VECTACTIVE_Pos     0U
+#define SCB_ICSR_VECTACTIVE_Msk     (0x1FFUL)
+#define SCB_SCR_SEVONPEND_Msk       (1UL << 4U)
+#define SCB_SCR_SLEEPDEEP_Msk       (1UL << 2U)
+
+/** @brief Data Watchpoint and Trace unit, only the cycle counter. */
+typedef struct
+{
+    __IOM uint32_t CTRL;
+    __IOM uint32_t CYCCNT;
+} DWT_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL)
+
+/** @brief Core debug, only DEMCR. */
+typedef struct
+{
+    __IOM uint32_t DHCSR;
+    __OM  uint32_t DCRSR;
+    __IOM uint32_t DCRDR;
+    __IOM uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24U)
+
+extern SCB_Type       usbd_sim_scb;
+extern DWT_Type       usbd_sim_dwt;
+extern CoreDebug_Type usbd_sim_core_debug;
+
+#define SCB                         (&usbd_sim_scb)
+#define DWT                         (&usbd_sim_dwt)
+#define CoreDebug                   (&usbd_sim_core_debug)
+
+/** @brief Nested Vectored Interrupt Controller. Pending lines are run by usbd_sim_irq_dispatch(). */
+typedef struct
+{
+    __IOM uint32_t ISER[8];
+    __IOM uint32_t ICER[8];
+    __IOM uint32_t ISPR[8];
+    __IOM uint32_t ICPR[8];
+    __IOM uint8_t  IP[240];
+} NVIC_Type;
+
+extern NVIC_Type usbd_sim_nvic;
+
+#define NVIC                        (&usbd_sim_nvic)
+
+__STATIC_INLINE void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    NVIC->ISER[IRQn >> 5] |= (1UL << (IRQn & 0x1F));
+    usbd_sim_irq_dispatch();
+}
+
+__STATIC_INLINE void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    NVIC->ISER[IRQn >> 5] &= ~(1UL << (IRQn & 0x1F));
+}
+
+__STATIC_INLINE uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn)
+{
+    return (NVIC->ISER[IRQn >> 5] >> (IRQn & 0x1F)) & 1UL;
+}
+
+__STATIC_INLINE void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    NVIC->ISPR[IRQn >> 5] |= (1UL << (IRQn & 0x1F));
+    usbd_sim_irq_dispatch();
+}
+
+__STATIC_INLINE void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    NVIC->ISPR[IRQn >> 5] &= ~(1UL << (IRQn & 0x1F));
+}
+
+__STATIC_INLINE uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    return (NVIC->ISPR[IRQn >> 5] >> (IRQn & 0x1F)) & 1UL;
+}
+
+__STATIC_INLINE void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    NVIC->IP[IRQn] = (uint8_t)priority;
+}
+
+__STATIC_INLINE uint32_t NVIC_GetPriority(IRQn_Type IRQn)
+{
+    return NVIC->IP[IRQn];
+}
+
+__NO_RETURN void NVIC_SystemReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // USBD_SIM_CORE_CM4_H__
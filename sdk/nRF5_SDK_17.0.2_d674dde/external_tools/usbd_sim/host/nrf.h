@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Device header for the host build.
+ *
+ * Includes the real nRF52840 device header and moves the peripherals that the
+ * USB stack touches directly into host memory, see @ref usbd_sim.h.
+ */
+#ifndef USBD_SIM_NRF_H__
+#define USBD_SIM_NRF_H__
+
+#include_next <nrf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern NRF_USBD_Type  usbd_sim_usbd_regs;
+extern NRF_POWER_Type usbd_sim_power_regs;
+extern NRF_CLOCK_Type usbd_sim_clock_regs;
+extern NRF_FICR_Type  usbd_sim_ficr_regs;
+
+#undef  NRF_USBD
+#define NRF_USBD  (&usbd_sim_usbd_regs)
+#undef  NRF_POWER
+#define NRF_POWER (&usbd_sim_power_regs)
+#undef  NRF_CLOCK
+#define NRF_CLOCK (&usbd_sim_clock_regs)
+#undef  NRF_FICR
+#define NRF_FICR  (&usbd_sim_ficr_regs)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // USBD_SIM_NRF_H__
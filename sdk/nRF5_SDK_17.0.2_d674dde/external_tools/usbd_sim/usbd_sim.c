@@ -0,0 +1,953 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <string.h>
+#include "usbd_sim.h"
+#include "nrf.h"
+#include "nrf_usbd.h"
+#include "app_util_platform.h"
+
+/**
+ * @brief Number of events that can wait for the USBD interrupt.
+ */
+#define USBD_SIM_EVT_QUEUE_SIZE 32
+
+/**
+ * @brief Number of endpoint slots: IN 0-8 followed by OUT 0-8.
+ */
+#define USBD_SIM_EP_CNT (2 * NRF_USBD_EPIN_CNT)
+
+/**
+ * @brief Mask of the frame counter.
+ */
+#define USBD_SIM_FRAMECNTR_MASK 0x7FFU
+
+/**
+ * @brief Write a register that is read-only for the firmware, as the hardware does.
+ */
+#define USBD_SIM_HW_WRITE(reg, value) (*(volatile uint32_t *)&(reg) = (uint32_t)(value))
+
+/* Register blocks and core peripherals that the SDK headers redirect to host memory. */
+NRF_USBD_Type  usbd_sim_usbd_regs;
+NRF_POWER_Type usbd_sim_power_regs;
+NRF_CLOCK_Type usbd_sim_clock_regs;
+NRF_FICR_Type  usbd_sim_ficr_regs;
+
+NVIC_Type      usbd_sim_nvic;
+SCB_Type       usbd_sim_scb;
+DWT_Type       usbd_sim_dwt;
+CoreDebug_Type usbd_sim_core_debug;
+
+volatile uint32_t usbd_sim_primask;
+volatile uint32_t usbd_sim_ipsr;
+
+/**
+ * @brief Endpoint state.
+ *
+ * IN endpoints hold the packet that the feeder prepared until the host reads it.
+ * OUT endpoints hold the packet written by the host until the consumer takes it.
+ */
+typedef struct
+{
+    nrfx_usbd_handler_t   handler;     //!< Feeder or consumer, NULL when no transfer is armed.
+    void *                p_context;   //!< Context of the handler.
+    nrfx_usbd_transfer_t  transfer;    //!< Storage for transfers set up by @ref nrfx_usbd_ep_transfer.
+    size_t                transfer_cnt;//!< Number of bytes moved by the current transfer.
+    nrfx_usbd_ep_status_t status;      //!< Status of the last transfer.
+    uint16_t              max_size;    //!< Max packet size.
+    bool                  enabled;     //!< Endpoint enabled.
+    bool                  stalled;     //!< Endpoint halted.
+    bool                  buf_full;    //!< Packet in @ref buf.
+    bool                  last;        //!< IN: @ref buf holds the last packet of the transfer.
+    size_t                buf_size;    //!< Size of the packet in @ref buf.
+    uint8_t               buf[NRFX_USBD_ISOSIZE]; //!< Endpoint packet buffer.
+} usbd_sim_ep_t;
+
+static nrfx_usbd_event_handler_t m_event_handler;
+static bool m_initialized;
+static bool m_enabled;
+static bool m_started;
+static bool m_sof_enabled;
+static bool m_bus_suspend;
+static bool m_lowpower;
+
+static usbd_sim_ep_t  m_ep[USBD_SIM_EP_CNT];
+static nrfx_usbd_ep_t m_last_setup_dir = NRFX_USBD_EPOUT0;
+static bool           m_ep0_status;  //!< Status stage allowed by @ref nrfx_usbd_setup_clear.
+static bool           m_ep0_stall;   //!< Request stalled by @ref nrfx_usbd_setup_stall.
+static bool           m_ep0_rcvout;  //!< OUT data allowed by @ref nrfx_usbd_setup_data_clear.
+
+static nrfx_usbd_evt_t m_evt_queue[USBD_SIM_EVT_QUEUE_SIZE];
+static uint8_t         m_evt_rd;
+static uint8_t         m_evt_wr;
+
+static uint8_t m_tx_buffer[NRFX_USBD_FEEDER_BUFFER_SIZE];
+
+static usbd_sim_ep_t * ep_state(nrfx_usbd_ep_t ep)
+{
+    uint8_t idx = NRF_USBD_EP_NR_GET(ep);
+    return &m_ep[NRF_USBD_EPIN_CHECK(ep) ? idx : (NRF_USBD_EPIN_CNT + idx)];
+}
+
+static bool ep_busy(usbd_sim_ep_t const * p_ep)
+{
+    return (p_ep->handler.feeder != NULL) || p_ep->last;
+}
+
+/**
+ * @brief Queue an event for the USBD interrupt and pend it.
+ */
+static void evt_post(nrfx_usbd_evt_t const * p_evt)
+{
+    uint8_t wr = (uint8_t)((m_evt_wr + 1) % USBD_SIM_EVT_QUEUE_SIZE);
+    if (wr == m_evt_rd)
+    {
+        /* The real peripheral would merge events here, dropping one is a bug in the test. */
+        APP_ERROR_CHECK(NRF_ERROR_NO_MEM);
+    }
+    m_evt_queue[m_evt_wr] = *p_evt;
+    m_evt_wr = wr;
+    NVIC_SetPendingIRQ(USBD_IRQn);
+}
+
+static void evt_type_post(nrfx_usbd_event_type_t type)
+{
+    const nrfx_usbd_evt_t evt = { .type = type };
+    evt_post(&evt);
+}
+
+static void evt_transfer_post(nrfx_usbd_ep_t ep, nrfx_usbd_ep_status_t status)
+{
+    const nrfx_usbd_evt_t evt = {
+        .type = NRFX_USBD_EVT_EPTRANSFER,
+        .data = { .eptransfer = { .ep = ep, .status = status } }
+    };
+    evt_post(&evt);
+}
+
+/**
+ * @brief Abort a transfer, see usbd_ep_abort() in nrfx_usbd.c.
+ *
+ * IN endpoints report @ref NRFX_USBD_EP_ABORTED to the handler right away,
+ * OUT endpoints drop the buffered packet.
+ */
+static void ep_abort(nrfx_usbd_ep_t ep)
+{
+    usbd_sim_ep_t * p_ep = ep_state(ep);
+    bool busy;
+
+    CRITICAL_REGION_ENTER();
+    busy = ep_busy(p_ep);
+    p_ep->handler.feeder = NULL;
+    p_ep->buf_full = false;
+    p_ep->last = false;
+    if (busy)
+    {
+        p_ep->status = NRFX_USBD_EP_ABORTED;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (busy && NRF_USBD_EPIN_CHECK(ep))
+    {
+        const nrfx_usbd_evt_t evt = {
+            .type = NRFX_USBD_EVT_EPTRANSFER,
+            .data = { .eptransfer = { .ep = ep, .status = NRFX_USBD_EP_ABORTED } }
+        };
+        m_event_handler(&evt);
+    }
+}
+
+static void ep_abort_all(void)
+{
+    for (uint8_t i = 0; i < NRF_USBD_EPIN_CNT; ++i)
+    {
+        ep_abort(NRFX_USBD_EPIN(i));
+        ep_abort(NRFX_USBD_EPOUT(i));
+    }
+}
+
+/**
+ * @brief Let the consumer of an OUT endpoint take the buffered packet.
+ *
+ * Called from the USBD interrupt.
+ */
+static void ep_out_consume(nrfx_usbd_ep_t ep)
+{
+    usbd_sim_ep_t * p_ep = ep_state(ep);
+    nrfx_usbd_ep_transfer_t next;
+
+    if (!p_ep->buf_full || (p_ep->handler.consumer == NULL))
+    {
+        return;
+    }
+    bool more = p_ep->handler.consumer(&next, p_ep->p_context, p_ep->max_size, p_ep->buf_size);
+    if (next.size < p_ep->buf_size)
+    {
+        /* The packet does not fit - leave it in the endpoint. */
+        p_ep->handler.consumer = NULL;
+        p_ep->status = NRFX_USBD_EP_OVERLOAD;
+        evt_transfer_post(ep, NRFX_USBD_EP_OVERLOAD);
+        return;
+    }
+    if (next.p_data.rx != NULL)
+    {
+        memcpy(next.p_data.rx, p_ep->buf, p_ep->buf_size);
+    }
+    p_ep->transfer_cnt += p_ep->buf_size;
+    p_ep->buf_full = false;
+    if (!more)
+    {
+        p_ep->handler.consumer = NULL;
+        p_ep->status = NRFX_USBD_EP_OK;
+        if (ep == NRFX_USBD_EPOUT0)
+        {
+            m_ep0_rcvout = false;
+        }
+        evt_transfer_post(ep, NRFX_USBD_EP_OK);
+    }
+}
+
+/**
+ * @brief Let the feeder of an IN endpoint prepare the next packet.
+ *
+ * Called from the USBD interrupt, like the DMA start in the real driver.
+ */
+static void ep_in_load(nrfx_usbd_ep_t ep)
+{
+    usbd_sim_ep_t * p_ep = ep_state(ep);
+    nrfx_usbd_ep_transfer_t next;
+
+    if (p_ep->buf_full || (p_ep->handler.feeder == NULL))
+    {
+        return;
+    }
+    bool more = p_ep->handler.feeder(&next, p_ep->p_context, p_ep->max_size);
+    NRFX_ASSERT(next.size <= p_ep->max_size);
+    if (next.size != 0)
+    {
+        memcpy(p_ep->buf, next.p_data.tx, next.size);
+    }
+    p_ep->buf_size = next.size;
+    p_ep->buf_full = true;
+    p_ep->transfer_cnt += next.size;
+    if (!more)
+    {
+        p_ep->handler.feeder = NULL;
+        p_ep->last = true;
+    }
+}
+
+/**
+ * @brief Prepare EP0 for a new request, see ev_setup_handler() in nrfx_usbd.c.
+ */
+static void ep0_setup(void)
+{
+    uint8_t bmRequestType = nrf_usbd_setup_bmrequesttype_get();
+
+    if (ep_busy(ep_state(m_last_setup_dir)))
+    {
+        ep_abort(m_last_setup_dir);
+    }
+    ep_state(NRFX_USBD_EPIN0)->buf_full  = false;
+    ep_state(NRFX_USBD_EPOUT0)->buf_full = false;
+    m_last_setup_dir = (bmRequestType & USBD_BMREQUESTTYPE_DIRECTION_Msk) ?
+        NRFX_USBD_EPIN0 : NRFX_USBD_EPOUT0;
+    m_ep0_stall  = false;
+    m_ep0_rcvout = false;
+    /* SET_ADDRESS is answered by the peripheral itself. */
+    m_ep0_status = (bmRequestType == 0x00) && (nrf_usbd_setup_brequest_get() == 0x05);
+}
+
+/* -------------------------------------------------------------------------
+ * Simulated interrupt controller
+ */
+
+void usbd_sim_irq_dispatch(void)
+{
+    static const struct
+    {
+        IRQn_Type irq;
+        void   (* handler)(void);
+    } vectors[] =
+    {
+        { USBD_IRQn,        nrfx_usbd_irq_handler            },
+        { POWER_CLOCK_IRQn, usbd_sim_power_clock_irq_handler },
+    };
+    bool run;
+
+    do
+    {
+        run = false;
+        if (usbd_sim_primask != 0)
+        {
+            return;
+        }
+        uint32_t current = (usbd_sim_ipsr == 0) ?
+            UINT32_MAX : NVIC_GetPriority((IRQn_Type)((int32_t)usbd_sim_ipsr - 16));
+
+        for (size_t i = 0; i < ARRAY_SIZE(vectors); ++i)
+        {
+            IRQn_Type irq = vectors[i].irq;
+            if (NVIC_GetPendingIRQ(irq) && NVIC_GetEnableIRQ(irq) && (NVIC_GetPriority(irq) < current))
+            {
+                uint32_t ipsr = usbd_sim_ipsr;
+                NVIC->ISPR[irq >> 5] &= ~(1UL << (irq & 0x1F));
+                usbd_sim_ipsr = (uint32_t)irq + 16;
+                vectors[i].handler();
+                usbd_sim_ipsr = ipsr;
+                run = true;
+                break;
+            }
+        }
+    } while (run);
+}
+
+void nrfx_usbd_irq_handler(void)
+{
+    for (uint8_t i = 0; i < NRF_USBD_EPIN_CNT; ++i)
+    {
+        ep_in_load(NRFX_USBD_EPIN(i));
+        ep_out_consume(NRFX_USBD_EPOUT(i));
+    }
+    while (m_evt_rd != m_evt_wr)
+    {
+        nrfx_usbd_evt_t evt = m_evt_queue[m_evt_rd];
+        m_evt_rd = (uint8_t)((m_evt_rd + 1) % USBD_SIM_EVT_QUEUE_SIZE);
+        if (evt.type == NRFX_USBD_EVT_SETUP)
+        {
+            ep0_setup();
+        }
+        m_event_handler(&evt);
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * nrfx_usbd API
+ */
+
+nrfx_err_t nrfx_usbd_init(nrfx_usbd_event_handler_t event_handler)
+{
+    NRFX_ASSERT(event_handler);
+
+    if (m_initialized)
+    {
+        return NRFX_ERROR_INVALID_STATE;
+    }
+    m_event_handler = event_handler;
+    m_initialized = true;
+    memset(m_ep, 0, sizeof(m_ep));
+    for (uint8_t i = 0; i < NRF_USBD_EPIN_CNT; ++i)
+    {
+        uint16_t size = NRF_USBD_EPISO_CHECK(NRFX_USBD_EPIN(i)) ?
+            (NRFX_USBD_ISOSIZE / 2) : NRFX_USBD_EPSIZE;
+        ep_state(NRFX_USBD_EPIN(i))->max_size  = size;
+        ep_state(NRFX_USBD_EPOUT(i))->max_size = size;
+    }
+    NVIC_SetPriority(USBD_IRQn, USBD_CONFIG_IRQ_PRIORITY);
+    return NRFX_SUCCESS;
+}
+
+void nrfx_usbd_uninit(void)
+{
+    m_event_handler = NULL;
+    m_initialized = false;
+}
+
+void nrfx_usbd_enable(void)
+{
+    NRFX_ASSERT(m_initialized);
+
+    NRF_USBD->ENABLE = 1;
+    m_enabled = true;
+    m_evt_rd = m_evt_wr;
+    ep_state(NRFX_USBD_EPIN0)->enabled  = true;
+    ep_state(NRFX_USBD_EPOUT0)->enabled = true;
+    NVIC_EnableIRQ(USBD_IRQn);
+}
+
+void nrfx_usbd_disable(void)
+{
+    nrfx_usbd_stop();
+    NVIC_DisableIRQ(USBD_IRQn);
+    NRF_USBD->ENABLE = 0;
+    m_enabled = false;
+}
+
+void nrfx_usbd_start(bool enable_sof)
+{
+    NRFX_ASSERT(m_enabled);
+
+    m_sof_enabled = enable_sof;
+    m_bus_suspend = false;
+    m_lowpower = false;
+    m_started = true;
+    NRF_USBD->USBPULLUP = 1;
+}
+
+void nrfx_usbd_stop(void)
+{
+    if (m_started)
+    {
+        NRF_USBD->USBPULLUP = 0;
+        m_started = false;
+        ep_abort_all();
+    }
+}
+
+bool nrfx_usbd_is_initialized(void)
+{
+    return m_initialized;
+}
+
+bool nrfx_usbd_is_enabled(void)
+{
+    return m_enabled;
+}
+
+bool nrfx_usbd_is_started(void)
+{
+    return m_started;
+}
+
+bool nrfx_usbd_suspend(void)
+{
+    bool suspended = false;
+
+    CRITICAL_REGION_ENTER();
+    if (m_bus_suspend)
+    {
+        ep_abort_all();
+        m_lowpower = true;
+        suspended = true;
+    }
+    CRITICAL_REGION_EXIT();
+    return suspended;
+}
+
+bool nrfx_usbd_wakeup_req(void)
+{
+    bool started = false;
+
+    CRITICAL_REGION_ENTER();
+    if (m_bus_suspend && m_lowpower)
+    {
+        m_lowpower = false;
+        started = true;
+    }
+    CRITICAL_REGION_EXIT();
+    if (started)
+    {
+        /* The peripheral drives resume signalling and reports it is ready. */
+        m_bus_suspend = false;
+        evt_type_post(NRFX_USBD_EVT_WUREQ);
+    }
+    return started;
+}
+
+bool nrfx_usbd_suspend_check(void)
+{
+    return m_lowpower;
+}
+
+void nrfx_usbd_suspend_irq_config(void)
+{
+}
+
+void nrfx_usbd_active_irq_config(void)
+{
+}
+
+bool nrfx_usbd_bus_suspend_check(void)
+{
+    return m_bus_suspend;
+}
+
+void nrfx_usbd_force_bus_wakeup(void)
+{
+    m_bus_suspend = false;
+}
+
+void nrfx_usbd_ep_max_packet_size_set(nrfx_usbd_ep_t ep, uint16_t size)
+{
+    NRFX_ASSERT(NRF_USBD_EPISO_CHECK(ep) ? (size <= NRFX_USBD_ISOSIZE) : (size <= NRFX_USBD_EPSIZE));
+    ep_state(ep)->max_size = size;
+}
+
+uint16_t nrfx_usbd_ep_max_packet_size_get(nrfx_usbd_ep_t ep)
+{
+    return ep_state(ep)->max_size;
+}
+
+bool nrfx_usbd_ep_enable_check(nrfx_usbd_ep_t ep)
+{
+    return ep_state(ep)->enabled;
+}
+
+void nrfx_usbd_ep_enable(nrfx_usbd_ep_t ep)
+{
+    usbd_sim_ep_t * p_ep = ep_state(ep);
+
+    if (p_ep->enabled)
+    {
+        return;
+    }
+    p_ep->enabled = true;
+    if ((NRF_USBD_EP_NR_GET(ep) != 0) && NRF_USBD_EPOUT_CHECK(ep))
+    {
+        p_ep->handler.consumer = NULL;
+        p_ep->buf_full = false;
+    }
+}
+
+void nrfx_usbd_ep_disable(nrfx_usbd_ep_t ep)
+{
+    ep_abort(ep);
+    ep_state(ep)->enabled = false;
+}
+
+void nrfx_usbd_ep_default_config(void)
+{
+    for (uint8_t i = 1; i < NRF_USBD_EPIN_CNT; ++i)
+    {
+        nrfx_usbd_ep_disable(NRFX_USBD_EPIN(i));
+        nrfx_usbd_ep_disable(NRFX_USBD_EPOUT(i));
+    }
+}
+
+nrfx_err_t nrfx_usbd_ep_handled_transfer(nrfx_usbd_ep_t                   ep,
+                                         nrfx_usbd_handler_desc_t const * p_handler)
+{
+    nrfx_err_t ret;
+    usbd_sim_ep_t * p_ep = ep_state(ep);
+    NRFX_ASSERT(NULL != p_handler);
+
+    CRITICAL_REGION_ENTER();
+    /* Setup data transaction can go only in one direction at a time */
+    if ((NRF_USBD_EP_NR_GET(ep) == 0) && (ep != m_last_setup_dir))
+    {
+        ret = NRFX_ERROR_INVALID_ADDR;
+    }
+    else if (ep_busy(p_ep))
+    {
+        ret = NRFX_ERROR_BUSY;
+    }
+    else
+    {
+        p_ep->transfer_cnt = 0;
+        p_ep->handler      = p_handler->handler;
+        p_ep->p_context    = p_handler->p_context;
+        p_ep->status       = NRFX_USBD_EP_OK;
+        ret = NRFX_SUCCESS;
+        NVIC_SetPendingIRQ(USBD_IRQn);
+    }
+    CRITICAL_REGION_EXIT();
+    return ret;
+}
+
+/**
+ * @brief Feeder for transfers set up by @ref nrfx_usbd_ep_transfer.
+ *
+ * Unlike nrfx_usbd_feeder_ram() it moves the data pointer as a pointer, the
+ * numeric @c addr member is only 32 bits wide.
+ */
+static bool usbd_sim_feeder(nrfx_usbd_ep_transfer_t * p_next, void * p_context, size_t ep_size)
+{
+    nrfx_usbd_transfer_t * p_transfer = p_context;
+    size_t tx_size = MIN(p_transfer->size, ep_size);
+
+    p_next->p_data.tx = (tx_size == 0) ? NULL : p_transfer->p_data.tx;
+    p_next->size = tx_size;
+    p_transfer->size -= tx_size;
+    p_transfer->p_data.tx = (uint8_t const *)p_transfer->p_data.tx + tx_size;
+
+    if (p_transfer->flags & NRFX_USBD_TRANSFER_ZLP_FLAG)
+    {
+        /* Finish with a short packet, a zero-length one if needed. */
+        return (tx_size != 0) && ((p_transfer->size != 0) || (tx_size == ep_size));
+    }
+    return (p_transfer->size != 0);
+}
+
+static bool usbd_sim_consumer(nrfx_usbd_ep_transfer_t * p_next,
+                              void *                    p_context,
+                              size_t                    ep_size,
+                              size_t                    data_size)
+{
+    nrfx_usbd_transfer_t * p_transfer = p_context;
+    size_t size = p_transfer->size;
+
+    p_next->p_data = p_transfer->p_data;
+    if (size < data_size)
+    {
+        /* Buffer size too small */
+        p_next->size = 0;
+    }
+    else
+    {
+        p_next->size = data_size;
+        size -= data_size;
+        p_transfer->size = size;
+        if (p_transfer->p_data.rx != NULL)
+        {
+            p_transfer->p_data.rx = (uint8_t *)p_transfer->p_data.rx + data_size;
+        }
+    }
+    return (ep_size == data_size) && (size != 0);
+}
+
+nrfx_err_t nrfx_usbd_ep_transfer(nrfx_usbd_ep_t               ep,
+                                 nrfx_usbd_transfer_t const * p_transfer)
+{
+    nrfx_usbd_handler_desc_t handler;
+    usbd_sim_ep_t * p_ep = ep_state(ep);
+    nrfx_err_t ret;
+    NRFX_ASSERT(NULL != p_transfer);
+
+    CRITICAL_REGION_ENTER();
+    if (ep_busy(p_ep))
+    {
+        ret = NRFX_ERROR_BUSY;
+    }
+    else
+    {
+        p_ep->transfer = *p_transfer;
+        handler.p_context = &p_ep->transfer;
+        if (NRF_USBD_EPIN_CHECK(ep))
+        {
+            handler.handler.feeder = usbd_sim_feeder;
+        }
+        else
+        {
+            handler.handler.consumer = usbd_sim_consumer;
+        }
+        ret = nrfx_usbd_ep_handled_transfer(ep, &handler);
+    }
+    CRITICAL_REGION_EXIT();
+    return ret;
+}
+
+void * nrfx_usbd_feeder_buffer_get(void)
+{
+    return m_tx_buffer;
+}
+
+nrfx_usbd_ep_status_t nrfx_usbd_ep_status_get(nrfx_usbd_ep_t ep, size_t * p_size)
+{
+    nrfx_usbd_ep_status_t ret;
+    usbd_sim_ep_t const * p_ep = ep_state(ep);
+
+    CRITICAL_REGION_ENTER();
+    *p_size = p_ep->transfer_cnt;
+    ret = (p_ep->handler.consumer == NULL) ? p_ep->status : NRFX_USBD_EP_BUSY;
+    CRITICAL_REGION_EXIT();
+    return ret;
+}
+
+size_t nrfx_usbd_epout_size_get(nrfx_usbd_ep_t ep)
+{
+    usbd_sim_ep_t const * p_ep = ep_state(ep);
+    return p_ep->buf_full ? p_ep->buf_size : 0;
+}
+
+bool nrfx_usbd_ep_is_busy(nrfx_usbd_ep_t ep)
+{
+    return ep_busy(ep_state(ep));
+}
+
+void nrfx_usbd_ep_stall(nrfx_usbd_ep_t ep)
+{
+    ep_state(ep)->stalled = true;
+}
+
+void nrfx_usbd_ep_stall_clear(nrfx_usbd_ep_t ep)
+{
+    usbd_sim_ep_t * p_ep = ep_state(ep);
+
+    if (NRF_USBD_EPOUT_CHECK(ep) && p_ep->stalled)
+    {
+        nrfx_usbd_transfer_out_drop(ep);
+    }
+    p_ep->stalled = false;
+}
+
+bool nrfx_usbd_ep_stall_check(nrfx_usbd_ep_t ep)
+{
+    return ep_state(ep)->stalled;
+}
+
+void nrfx_usbd_ep_dtoggle_clear(nrfx_usbd_ep_t ep)
+{
+    /* Data toggles are not modelled. */
+    UNUSED_PARAMETER(ep);
+}
+
+void nrfx_usbd_setup_get(nrfx_usbd_setup_t * p_setup)
+{
+    memset(p_setup, 0, sizeof(nrfx_usbd_setup_t));
+    p_setup->bmRequestType = nrf_usbd_setup_bmrequesttype_get();
+    p_setup->bRequest      = nrf_usbd_setup_brequest_get();
+    p_setup->wValue        = nrf_usbd_setup_wvalue_get();
+    p_setup->wIndex        = nrf_usbd_setup_windex_get();
+    p_setup->wLength       = nrf_usbd_setup_wlength_get();
+}
+
+void nrfx_usbd_setup_data_clear(void)
+{
+    m_ep0_rcvout = true;
+}
+
+void nrfx_usbd_setup_clear(void)
+{
+    m_ep0_status = true;
+}
+
+void nrfx_usbd_setup_stall(void)
+{
+    m_ep0_stall = true;
+}
+
+void nrfx_usbd_ep_abort(nrfx_usbd_ep_t ep)
+{
+    ep_abort(ep);
+}
+
+nrfx_usbd_ep_t nrfx_usbd_last_setup_dir_get(void)
+{
+    return m_last_setup_dir;
+}
+
+void nrfx_usbd_transfer_out_drop(nrfx_usbd_ep_t ep)
+{
+    NRFX_ASSERT(NRF_USBD_EPOUT_CHECK(ep));
+
+    CRITICAL_REGION_ENTER();
+    ep_state(ep)->buf_full = false;
+    CRITICAL_REGION_EXIT();
+}
+
+/* -------------------------------------------------------------------------
+ * Host side of the bus
+ */
+
+void usbd_sim_vbus_set(bool connected)
+{
+    if (connected)
+    {
+        USBD_SIM_HW_WRITE(NRF_POWER->USBREGSTATUS,
+                          POWER_USBREGSTATUS_VBUSDETECT_Msk | POWER_USBREGSTATUS_OUTPUTRDY_Msk);
+        NRF_POWER->EVENTS_USBDETECTED = 1;
+        NRF_POWER->EVENTS_USBPWRRDY   = 1;
+    }
+    else
+    {
+        USBD_SIM_HW_WRITE(NRF_POWER->USBREGSTATUS, 0);
+        NRF_POWER->EVENTS_USBREMOVED = 1;
+    }
+    NVIC_SetPendingIRQ(POWER_CLOCK_IRQn);
+}
+
+bool usbd_sim_pullup_check(void)
+{
+    return m_started && (NRF_USBD->USBPULLUP != 0);
+}
+
+void usbd_sim_bus_reset(void)
+{
+    if (!usbd_sim_pullup_check())
+    {
+        return;
+    }
+    USBD_SIM_HW_WRITE(NRF_USBD->USBADDR, 0);
+    m_bus_suspend = false;
+    m_lowpower = false;
+    m_last_setup_dir = NRFX_USBD_EPOUT0;
+    m_ep0_status = false;
+    m_ep0_stall = false;
+    m_ep0_rcvout = false;
+    for (uint8_t i = 0; i < USBD_SIM_EP_CNT; ++i)
+    {
+        m_ep[i].buf_full = false;
+        m_ep[i].stalled = false;
+    }
+    evt_type_post(NRFX_USBD_EVT_RESET);
+}
+
+void usbd_sim_sof(void)
+{
+    USBD_SIM_HW_WRITE(NRF_USBD->FRAMECNTR, (NRF_USBD->FRAMECNTR + 1) & USBD_SIM_FRAMECNTR_MASK);
+    if (usbd_sim_pullup_check() && m_sof_enabled && !m_bus_suspend)
+    {
+        const nrfx_usbd_evt_t evt = {
+            .type = NRFX_USBD_EVT_SOF,
+            .data = { .sof = { .framecnt = (uint16_t)NRF_USBD->FRAMECNTR } }
+        };
+        evt_post(&evt);
+    }
+}
+
+void usbd_sim_bus_suspend(void)
+{
+    if (usbd_sim_pullup_check() && !m_bus_suspend)
+    {
+        m_bus_suspend = true;
+        evt_type_post(NRFX_USBD_EVT_SUSPEND);
+    }
+}
+
+void usbd_sim_bus_resume(void)
+{
+    if (usbd_sim_pullup_check() && m_bus_suspend)
+    {
+        m_bus_suspend = false;
+        m_lowpower = false;
+        evt_type_post(NRFX_USBD_EVT_RESUME);
+    }
+}
+
+usbd_sim_handshake_t usbd_sim_setup(nrfx_usbd_setup_t const * p_setup)
+{
+    if (!usbd_sim_pullup_check() || m_bus_suspend)
+    {
+        return USBD_SIM_NAK;
+    }
+
+    USBD_SIM_HW_WRITE(NRF_USBD->BMREQUESTTYPE, p_setup->bmRequestType);
+    USBD_SIM_HW_WRITE(NRF_USBD->BREQUEST, p_setup->bRequest);
+    USBD_SIM_HW_WRITE(NRF_USBD->WVALUEL, (uint8_t)(p_setup->wValue));
+    USBD_SIM_HW_WRITE(NRF_USBD->WVALUEH, (uint8_t)(p_setup->wValue >> 8));
+    USBD_SIM_HW_WRITE(NRF_USBD->WINDEXL, (uint8_t)(p_setup->wIndex));
+    USBD_SIM_HW_WRITE(NRF_USBD->WINDEXH, (uint8_t)(p_setup->wIndex >> 8));
+    USBD_SIM_HW_WRITE(NRF_USBD->WLENGTHL, (uint8_t)(p_setup->wLength));
+    USBD_SIM_HW_WRITE(NRF_USBD->WLENGTHH, (uint8_t)(p_setup->wLength >> 8));
+
+    if ((p_setup->bmRequestType == 0x00) && (p_setup->bRequest == 0x05))
+    {
+        USBD_SIM_HW_WRITE(NRF_USBD->USBADDR, p_setup->wValue & 0x7F);
+    }
+    evt_type_post(NRFX_USBD_EVT_SETUP);
+    return USBD_SIM_ACK;
+}
+
+usbd_sim_handshake_t usbd_sim_status(void)
+{
+    if (m_ep0_stall)
+    {
+        return USBD_SIM_STALL;
+    }
+    if (!m_ep0_status)
+    {
+        return USBD_SIM_NAK;
+    }
+    m_ep0_status = false;
+    return USBD_SIM_ACK;
+}
+
+usbd_sim_handshake_t usbd_sim_in(nrfx_usbd_ep_t ep, void * p_buf, size_t * p_size)
+{
+    usbd_sim_ep_t * p_ep = ep_state(ep);
+    NRFX_ASSERT(NRF_USBD_EPIN_CHECK(ep));
+
+    if (!usbd_sim_pullup_check() || m_bus_suspend)
+    {
+        return USBD_SIM_NAK;
+    }
+    if ((ep == NRFX_USBD_EPIN0) ? m_ep0_stall : (p_ep->stalled || !p_ep->enabled))
+    {
+        return USBD_SIM_STALL;
+    }
+
+    if (!p_ep->buf_full)
+    {
+        return USBD_SIM_NAK;
+    }
+    memcpy(p_buf, p_ep->buf, p_ep->buf_size);
+    *p_size = p_ep->buf_size;
+    p_ep->buf_full = false;
+    if (p_ep->last)
+    {
+        p_ep->last = false;
+        p_ep->status = NRFX_USBD_EP_OK;
+        evt_transfer_post(ep, NRFX_USBD_EP_OK);
+    }
+    else
+    {
+        /* Let the feeder prepare the next packet. */
+        NVIC_SetPendingIRQ(USBD_IRQn);
+    }
+    return USBD_SIM_ACK;
+}
+
+usbd_sim_handshake_t usbd_sim_out(nrfx_usbd_ep_t ep, void const * p_buf, size_t size)
+{
+    usbd_sim_ep_t * p_ep = ep_state(ep);
+    NRFX_ASSERT(NRF_USBD_EPOUT_CHECK(ep));
+    NRFX_ASSERT(size <= p_ep->max_size);
+
+    if (!usbd_sim_pullup_check() || m_bus_suspend)
+    {
+        return USBD_SIM_NAK;
+    }
+    if ((ep == NRFX_USBD_EPOUT0) ? m_ep0_stall : (p_ep->stalled || !p_ep->enabled))
+    {
+        return USBD_SIM_STALL;
+    }
+    if (p_ep->buf_full || ((ep == NRFX_USBD_EPOUT0) && !m_ep0_rcvout))
+    {
+        return USBD_SIM_NAK;
+    }
+
+    memcpy(p_ep->buf, p_buf, size);
+    p_ep->buf_size = size;
+    p_ep->buf_full = true;
+    if (p_ep->handler.consumer == NULL)
+    {
+        /* Nothing armed - the class picks the data up on the WAITING event. */
+        evt_transfer_post(ep, NRFX_USBD_EP_WAITING);
+    }
+    else
+    {
+        NVIC_SetPendingIRQ(USBD_IRQn);
+    }
+    return USBD_SIM_ACK;
+}
+
+uint8_t usbd_sim_address_get(void)
+{
+    return (uint8_t)NRF_USBD->USBADDR;
+}
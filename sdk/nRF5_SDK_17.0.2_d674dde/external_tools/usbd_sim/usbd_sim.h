@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef USBD_SIM_H__
+#define USBD_SIM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "nrfx_usbd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup usbd_sim Simulated USBD peripheral
+ * @{
+ * @ingroup app_usbd
+ *
+ * @brief Host build of the USB device stack against a simulated @c nrfx_usbd driver.
+ *
+ * The module implements the @c nrfx_usbd API on top of an in-memory bus model so that
+ * @ref app_usbd, @ref app_usbd_core and the class drivers can run unmodified on a PC.
+ * The device side behaves like the real driver: transfers are armed with
+ * @ref nrfx_usbd_ep_transfer, data moves through the feeders and consumers one packet
+ * at a time and every event is delivered from the simulated USBD interrupt.
+ *
+ * The host side is driven packet by packet with the functions below. A transaction
+ * that the device cannot serve yet is NAKed, the caller then runs the application
+ * (for example @ref app_usbd_event_queue_process) and retries, as a real host would.
+ */
+
+/** @brief Handshake of a host-side transaction. */
+typedef enum
+{
+    USBD_SIM_ACK,   /**< Transaction accepted. */
+    USBD_SIM_NAK,   /**< Device not ready, retry later. */
+    USBD_SIM_STALL, /**< Endpoint halted or control request rejected. */
+} usbd_sim_handshake_t;
+
+/**
+ * @brief Function for connecting or disconnecting VBUS.
+ *
+ * Updates USBREGSTATUS and generates the USB power events of the POWER peripheral.
+ *
+ * @param connected True to apply VBUS, false to remove it.
+ */
+void usbd_sim_vbus_set(bool connected);
+
+/**
+ * @brief Function for checking if the device has attached to the bus.
+ *
+ * @retval true  The D+ pull-up is enabled, that is the driver was started.
+ * @retval false The device is not visible to the host.
+ */
+bool usbd_sim_pullup_check(void);
+
+/**
+ * @brief Function for signalling a bus reset.
+ *
+ * Clears the device address and the pending endpoint data.
+ */
+void usbd_sim_bus_reset(void);
+
+/**
+ * @brief Function for sending a Start Of Frame.
+ *
+ * The frame counter advances on every call. The SOF event is generated only if the
+ * driver was started with SOF enabled.
+ */
+void usbd_sim_sof(void);
+
+/** @brief Function for suspending the bus. */
+void usbd_sim_bus_suspend(void);
+
+/** @brief Function for resuming the bus after @ref usbd_sim_bus_suspend. */
+void usbd_sim_bus_resume(void);
+
+/**
+ * @brief Function for sending a SETUP packet to endpoint 0.
+ *
+ * Any EP0 transfer in progress is aborted. SET_ADDRESS is handled by the simulated
+ * hardware, as on the real peripheral, and its status stage completes on its own.
+ *
+ * @param[in] p_setup Setup packet.
+ *
+ * @retval USBD_SIM_ACK The device is attached and the setup was accepted.
+ * @retval USBD_SIM_NAK The device is not attached to the bus.
+ */
+usbd_sim_handshake_t usbd_sim_setup(nrfx_usbd_setup_t const * p_setup);
+
+/**
+ * @brief Function for running the status stage of the last control transfer.
+ *
+ * @retval USBD_SIM_ACK   The device has completed the request.
+ * @retval USBD_SIM_NAK   The request is still being processed.
+ * @retval USBD_SIM_STALL The request was rejected.
+ */
+usbd_sim_handshake_t usbd_sim_status(void);
+
+/**
+ * @brief Function for reading one packet from an IN endpoint.
+ *
+ * @param[in]  ep     IN endpoint, EP0 for the data stage of a control read.
+ * @param[out] p_buf  Buffer of at least the endpoint max packet size.
+ * @param[out] p_size Number of bytes received. A short packet ends the transfer.
+ *
+ * @return Handshake of the transaction.
+ */
+usbd_sim_handshake_t usbd_sim_in(nrfx_usbd_ep_t ep, void * p_buf, size_t * p_size);
+
+/**
+ * @brief Function for writing one packet to an OUT endpoint.
+ *
+ * @param[in] ep     OUT endpoint, EP0 for the data stage of a control write.
+ * @param[in] p_buf  Packet data.
+ * @param[in] size   Packet size, at most the endpoint max packet size.
+ *
+ * @return Handshake of the transaction.
+ */
+usbd_sim_handshake_t usbd_sim_out(nrfx_usbd_ep_t ep, void const * p_buf, size_t size);
+
+/**
+ * @brief Function for getting the address assigned by SET_ADDRESS.
+ *
+ * @return Device address, 0 after reset.
+ */
+uint8_t usbd_sim_address_get(void);
+
+/**
+ * @brief Function for dispatching the pending simulated interrupts.
+ *
+ * Called by the NVIC model whenever an interrupt is pended, enabled or unmasked. An
+ * interrupt runs only if its priority is higher than the one currently executing.
+ */
+void usbd_sim_irq_dispatch(void);
+
+/** @brief Interrupt handler of the POWER and CLOCK peripherals, see usbd_sim_platform.c. */
+void usbd_sim_power_clock_irq_handler(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // USBD_SIM_H__
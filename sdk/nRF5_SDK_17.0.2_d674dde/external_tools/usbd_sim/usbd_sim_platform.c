@@ -0,0 +1,346 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Platform services for the host build of the USB stack.
+ *
+ * Stands in for the pieces of the SDK that cannot run on a PC: the POWER and
+ * CLOCK drivers, the error handlers and the assembly based atomic FIFO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "usbd_sim.h"
+#include "nrf.h"
+#include "app_error.h"
+#include "nrf_assert.h"
+#include "nrf_atfifo.h"
+#include "nrf_memobj.h"
+#include "nrf_drv_clock.h"
+#include "nrf_drv_power.h"
+
+static bool                               m_power_initialized;
+static nrf_drv_power_usb_event_handler_t  m_usb_evt_handler;
+
+static bool                               m_clock_initialized;
+static uint32_t                           m_hfclk_requests;
+static nrf_drv_clock_handler_item_t *     m_p_hf_head;
+
+/* -------------------------------------------------------------------------
+ * POWER and CLOCK
+ */
+
+void usbd_sim_power_clock_irq_handler(void)
+{
+    if (NRF_CLOCK->EVENTS_HFCLKSTARTED)
+    {
+        NRF_CLOCK->EVENTS_HFCLKSTARTED = 0;
+        while (m_p_hf_head != NULL)
+        {
+            nrf_drv_clock_handler_item_t * p_item = m_p_hf_head;
+            m_p_hf_head = p_item->p_next;
+            p_item->event_handler(NRF_DRV_CLOCK_EVT_HFCLK_STARTED);
+        }
+    }
+    if (NRF_POWER->EVENTS_USBDETECTED)
+    {
+        NRF_POWER->EVENTS_USBDETECTED = 0;
+        if (m_usb_evt_handler != NULL)
+        {
+            m_usb_evt_handler(NRF_DRV_POWER_USB_EVT_DETECTED);
+        }
+    }
+    if (NRF_POWER->EVENTS_USBPWRRDY)
+    {
+        NRF_POWER->EVENTS_USBPWRRDY = 0;
+        if (m_usb_evt_handler != NULL)
+        {
+            m_usb_evt_handler(NRF_DRV_POWER_USB_EVT_READY);
+        }
+    }
+    if (NRF_POWER->EVENTS_USBREMOVED)
+    {
+        NRF_POWER->EVENTS_USBREMOVED = 0;
+        if (m_usb_evt_handler != NULL)
+        {
+            m_usb_evt_handler(NRF_DRV_POWER_USB_EVT_REMOVED);
+        }
+    }
+}
+
+bool nrf_drv_power_init_check(void)
+{
+    return m_power_initialized;
+}
+
+ret_code_t nrf_drv_power_init(nrf_drv_power_config_t const * p_config)
+{
+    UNUSED_PARAMETER(p_config);
+
+    if (m_power_initialized)
+    {
+        return NRF_ERROR_MODULE_ALREADY_INITIALIZED;
+    }
+    m_power_initialized = true;
+    NVIC_SetPriority(POWER_CLOCK_IRQn, POWER_CONFIG_IRQ_PRIORITY);
+    NVIC_EnableIRQ(POWER_CLOCK_IRQn);
+    return NRF_SUCCESS;
+}
+
+void nrf_drv_power_uninit(void)
+{
+    m_power_initialized = false;
+    m_usb_evt_handler = NULL;
+}
+
+ret_code_t nrf_drv_power_usbevt_init(nrf_drv_power_usbevt_config_t const * p_config)
+{
+    ASSERT(m_power_initialized);
+
+    m_usb_evt_handler = p_config->handler;
+    return NRF_SUCCESS;
+}
+
+void nrf_drv_power_usbevt_uninit(void)
+{
+    m_usb_evt_handler = NULL;
+}
+
+bool nrf_drv_clock_init_check(void)
+{
+    return m_clock_initialized;
+}
+
+ret_code_t nrf_drv_clock_init(void)
+{
+    if (m_clock_initialized)
+    {
+        return NRF_ERROR_MODULE_ALREADY_INITIALIZED;
+    }
+    m_clock_initialized = true;
+    m_hfclk_requests = 0;
+    m_p_hf_head = NULL;
+    NVIC_SetPriority(POWER_CLOCK_IRQn, CLOCK_CONFIG_IRQ_PRIORITY);
+    NVIC_EnableIRQ(POWER_CLOCK_IRQn);
+    return NRF_SUCCESS;
+}
+
+void nrf_drv_clock_uninit(void)
+{
+    m_clock_initialized = false;
+}
+
+void nrf_drv_clock_hfclk_request(nrf_drv_clock_handler_item_t * p_handler_item)
+{
+    ASSERT(m_clock_initialized);
+
+    CRITICAL_REGION_ENTER();
+    if (p_handler_item != NULL)
+    {
+        p_handler_item->p_next = m_p_hf_head;
+        m_p_hf_head = p_handler_item;
+    }
+    ++m_hfclk_requests;
+    /* The crystal starts at once, the handlers run from the clock interrupt. */
+    NRF_CLOCK->EVENTS_HFCLKSTARTED = 1;
+    NVIC_SetPendingIRQ(POWER_CLOCK_IRQn);
+    CRITICAL_REGION_EXIT();
+}
+
+void nrf_drv_clock_hfclk_release(void)
+{
+    ASSERT(m_hfclk_requests > 0);
+
+    --m_hfclk_requests;
+}
+
+bool nrf_drv_clock_hfclk_is_running(void)
+{
+    return m_hfclk_requests > 0;
+}
+
+/* -------------------------------------------------------------------------
+ * Error handling
+ */
+
+void app_error_handler_bare(ret_code_t error_code)
+{
+    fprintf(stderr, "usbd_sim: fatal error 0x%08X\n", (unsigned)error_code);
+    abort();
+}
+
+void app_error_handler(uint32_t error_code, uint32_t line_num, const uint8_t * p_file_name)
+{
+    fprintf(stderr, "usbd_sim: fatal error 0x%08X at %s:%u\n",
+            (unsigned)error_code, (char const *)p_file_name, (unsigned)line_num);
+    abort();
+}
+
+void assert_nrf_callback(uint16_t line_num, const uint8_t * file_name)
+{
+    fprintf(stderr, "usbd_sim: assertion failed at %s:%u\n",
+            (char const *)file_name, (unsigned)line_num);
+    abort();
+}
+
+void NVIC_SystemReset(void)
+{
+    fprintf(stderr, "usbd_sim: system reset requested\n");
+    exit(EXIT_FAILURE);
+}
+
+/* -------------------------------------------------------------------------
+ * Atomic FIFO
+ *
+ * nrf_atfifo.c is written in Cortex-M exclusive access assembly. Interrupts
+ * here only preempt at the NVIC calls, never inside these functions, so a plain
+ * ring with separate reserve and commit positions keeps the same contract:
+ * tail.pos.wr - reserved by alloc, tail.pos.rd - committed by put,
+ * head.pos.rd - taken by get, head.pos.wr - released by free.
+ */
+
+static uint16_t atfifo_next(nrf_atfifo_t const * p_fifo, uint16_t pos)
+{
+    pos += p_fifo->item_size;
+    return (pos >= p_fifo->buf_size) ? 0 : pos;
+}
+
+ret_code_t nrf_atfifo_init(nrf_atfifo_t * const p_fifo, void * p_buf, uint16_t buf_size, uint16_t item_size)
+{
+    if (NULL == p_buf)
+    {
+        p_fifo->p_buf = NULL;
+        return NRF_ERROR_NULL;
+    }
+    if (0 != (buf_size % item_size))
+    {
+        p_fifo->p_buf = NULL;
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_fifo->p_buf     = p_buf;
+    p_fifo->tail.tag  = 0;
+    p_fifo->head.tag  = 0;
+    p_fifo->buf_size  = buf_size;
+    p_fifo->item_size = item_size;
+    return NRF_SUCCESS;
+}
+
+void * nrf_atfifo_item_alloc(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_put_t * p_context)
+{
+    uint16_t next = atfifo_next(p_fifo, p_fifo->tail.pos.wr);
+
+    if (next == p_fifo->head.pos.wr)
+    {
+        return NULL;
+    }
+    p_context->last_tail = p_fifo->tail;
+    p_fifo->tail.pos.wr = next;
+    return ((uint8_t *)(p_fifo->p_buf)) + p_context->last_tail.pos.wr;
+}
+
+bool nrf_atfifo_item_put(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_put_t * p_context)
+{
+    if (p_context->last_tail.pos.wr != p_fifo->tail.pos.rd)
+    {
+        /* An interrupted reservation commits the later items. */
+        return false;
+    }
+    p_fifo->tail.pos.rd = p_fifo->tail.pos.wr;
+    return true;
+}
+
+void * nrf_atfifo_item_get(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_get_t * p_context)
+{
+    if (p_fifo->head.pos.rd == p_fifo->tail.pos.rd)
+    {
+        return NULL;
+    }
+    p_context->last_head = p_fifo->head;
+    p_fifo->head.pos.rd = atfifo_next(p_fifo, p_fifo->head.pos.rd);
+    return ((uint8_t *)(p_fifo->p_buf)) + p_context->last_head.pos.rd;
+}
+
+bool nrf_atfifo_item_free(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_get_t * p_context)
+{
+    if (p_context->last_head.pos.rd != p_fifo->head.pos.wr)
+    {
+        return false;
+    }
+    p_fifo->head.pos.wr = p_fifo->head.pos.rd;
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Memory objects
+ *
+ * nrf_memobj.c keeps a pointer in a 32-bit chunk header and does not build for a
+ * 64-bit host. Only app_usbd_cdc_acm_write_memobj() uses it, which the host
+ * build does not support.
+ */
+
+void nrf_memobj_get(nrf_memobj_t const * p_obj)
+{
+    UNUSED_PARAMETER(p_obj);
+    APP_ERROR_CHECK(NRF_ERROR_NOT_SUPPORTED);
+}
+
+void nrf_memobj_put(nrf_memobj_t * p_obj)
+{
+    UNUSED_PARAMETER(p_obj);
+    APP_ERROR_CHECK(NRF_ERROR_NOT_SUPPORTED);
+}
+
+void nrf_memobj_read(nrf_memobj_t * p_obj, void * p_data, size_t len, size_t offset)
+{
+    UNUSED_PARAMETER(p_obj);
+    UNUSED_PARAMETER(p_data);
+    UNUSED_PARAMETER(len);
+    UNUSED_PARAMETER(offset);
+    APP_ERROR_CHECK(NRF_ERROR_NOT_SUPPORTED);
+}
+
+size_t nrf_memobj_chunk_get(nrf_memobj_t * p_obj, void ** pp_data, size_t offset)
+{
+    UNUSED_PARAMETER(p_obj);
+    UNUSED_PARAMETER(pp_data);
+    UNUSED_PARAMETER(offset);
+    APP_ERROR_CHECK(NRF_ERROR_NOT_SUPPORTED);
+    return 0;
+}
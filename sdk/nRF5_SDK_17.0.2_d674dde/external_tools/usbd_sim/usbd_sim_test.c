@@ -0,0 +1,943 @@
+/**
+ * Copyright (c) 2020, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @file
+ * @brief Regression test and throughput benchmark of the USB device stack.
+ *
+ * Builds a composite CDC ACM + MSC + HID generic device on top of @ref usbd_sim and plays
+ * the host: VBUS, enumeration, a CDC ACM loopback, SCSI reads and writes on a RAM disk
+ * and a HID input report. Exits with a non-zero status if any check fails.
+ *
+ * The throughput figures measure the CPU time the stack spends per byte on the host,
+ * which tracks the per-packet overhead on the device. They are not bus speeds.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "usbd_sim.h"
+#include "app_usbd.h"
+#include "app_usbd_core.h"
+#include "app_usbd_string_desc.h"
+#include "app_usbd_cdc_acm.h"
+#include "app_usbd_msc.h"
+#include "app_usbd_hid_generic.h"
+#include "nrf_block_dev_ram.h"
+#include "nrf_drv_clock.h"
+
+#define CDC_ACM_COMM_INTERFACE  0
+#define CDC_ACM_COMM_EPIN       NRF_DRV_USBD_EPIN2
+
+#define CDC_ACM_DATA_INTERFACE  1
+#define CDC_ACM_DATA_EPIN       NRF_DRV_USBD_EPIN1
+#define CDC_ACM_DATA_EPOUT      NRF_DRV_USBD_EPOUT1
+
+#define MSC_INTERFACE           2
+#define MSC_EPIN                3
+#define MSC_EPOUT               3
+
+#define HID_INTERFACE           3
+#define HID_EPIN                NRF_DRV_USBD_EPIN4
+#define HID_REPORT_SIZE         16
+
+/** @brief Length of APP_USBD_STRING_SERIAL. */
+#define SERIAL_NUM_STRING_SIZE  12
+
+/* The CDC ACM class in this tree describes only its data interface. */
+#define INTERFACE_DSC_CNT       3
+#define ENDPOINT_DSC_CNT        5
+
+#define RAM_DISK_BLOCK_SIZE     512
+#define RAM_DISK_BLOCK_CNT      128
+
+#define CDC_RX_RING_SIZE        (4 * NRF_DRV_USBD_EPSIZE)
+#define CDC_ECHO_SIZE           512
+
+/** @brief Number of NAKed attempts before a transaction is reported as timed out. */
+#define HOST_RETRY_CNT          10000
+
+/** @brief Bytes moved by each throughput run. */
+#define BENCH_CDC_SIZE          (512 * 1024)
+#define BENCH_MSC_PASSES        8
+
+#define REQTYPE(dir, type, rec) (uint8_t)(((dir) << 7) | ((type) << 5) | (rec))
+
+#define STD_IN_DEVICE   REQTYPE(APP_USBD_SETUP_REQDIR_IN,  APP_USBD_SETUP_REQTYPE_STD,    APP_USBD_SETUP_REQREC_DEVICE)
+#define STD_OUT_DEVICE  REQTYPE(APP_USBD_SETUP_REQDIR_OUT, APP_USBD_SETUP_REQTYPE_STD,    APP_USBD_SETUP_REQREC_DEVICE)
+#define STD_IN_IFACE    REQTYPE(APP_USBD_SETUP_REQDIR_IN,  APP_USBD_SETUP_REQTYPE_STD,    APP_USBD_SETUP_REQREC_INTERFACE)
+#define CLASS_IN_IFACE  REQTYPE(APP_USBD_SETUP_REQDIR_IN,  APP_USBD_SETUP_REQTYPE_CLASS,  APP_USBD_SETUP_REQREC_INTERFACE)
+#define CLASS_OUT_IFACE REQTYPE(APP_USBD_SETUP_REQDIR_OUT, APP_USBD_SETUP_REQTYPE_CLASS,  APP_USBD_SETUP_REQREC_INTERFACE)
+#define STD_OUT_EP      REQTYPE(APP_USBD_SETUP_REQDIR_OUT, APP_USBD_SETUP_REQTYPE_STD,    APP_USBD_SETUP_REQREC_ENDPOINT)
+#define VENDOR_IN_DEV   REQTYPE(APP_USBD_SETUP_REQDIR_IN,  APP_USBD_SETUP_REQTYPE_VENDOR, APP_USBD_SETUP_REQREC_DEVICE)
+
+#define MSC_CBW_SIGNATURE       0x43425355UL
+#define MSC_CSW_SIGNATURE       0x53425355UL
+#define MSC_CBW_SIZE            31
+#define MSC_CSW_SIZE            13
+
+#define TEST_CHECK(cond)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);           \
+            ++m_failures;                                                       \
+            return;                                                             \
+        }                                                                       \
+    } while (0)
+
+static void cdc_acm_user_ev_handler(app_usbd_class_inst_t const * p_inst,
+                                    app_usbd_cdc_acm_user_event_t event);
+static void hid_user_ev_handler(app_usbd_class_inst_t const * p_inst,
+                                app_usbd_hid_user_event_t     event);
+
+static unsigned m_failures;
+
+/* -------------------------------------------------------------------------
+ * Device
+ */
+
+APP_USBD_CDC_ACM_GLOBAL_DEF(m_app_cdc_acm,
+                            cdc_acm_user_ev_handler,
+                            CDC_ACM_COMM_INTERFACE,
+                            CDC_ACM_DATA_INTERFACE,
+                            CDC_ACM_COMM_EPIN,
+                            CDC_ACM_DATA_EPIN,
+                            CDC_ACM_DATA_EPOUT,
+                            APP_USBD_CDC_COMM_PROTOCOL_AT_V250);
+
+static uint8_t m_ram_disk[RAM_DISK_BLOCK_SIZE * RAM_DISK_BLOCK_CNT];
+
+NRF_BLOCK_DEV_RAM_DEFINE(m_block_dev_ram,
+                         NRF_BLOCK_DEV_RAM_CONFIG(RAM_DISK_BLOCK_SIZE, m_ram_disk, sizeof(m_ram_disk)),
+                         NFR_BLOCK_DEV_INFO_CONFIG("Nordic", "RAM", "1.00"));
+
+#define BLOCKDEV_LIST() (NRF_BLOCKDEV_BASE_ADDR(m_block_dev_ram, block_dev))
+
+APP_USBD_MSC_GLOBAL_DEF(m_app_msc,
+                        MSC_INTERFACE,
+                        NULL,
+                        APP_USBD_MSC_ENDPOINT_LIST(MSC_EPIN, MSC_EPOUT),
+                        BLOCKDEV_LIST(),
+                        RAM_DISK_BLOCK_SIZE);
+
+APP_USBD_HID_GENERIC_SUBCLASS_REPORT_DESC(m_hid_report_desc,
+{
+    0x06, 0x00, 0xFF,           /* Usage Page (Vendor Defined 0xFF00) */
+    0x09, 0x01,                 /* Usage (0x01) */
+    0xA1, 0x01,                 /* Collection (Application) */
+    0x09, 0x02,                 /*   Usage (0x02) */
+    0x15, 0x00,                 /*   Logical Minimum (0) */
+    0x26, 0xFF, 0x00,           /*   Logical Maximum (255) */
+    0x75, 0x08,                 /*   Report Size (8) */
+    0x95, HID_REPORT_SIZE,      /*   Report Count */
+    0x81, 0x02,                 /*   Input (Data, Variable, Absolute) */
+    0xC0                        /* End Collection */
+});
+
+static const app_usbd_hid_subclass_desc_t * m_hid_reps[] = { &m_hid_report_desc };
+
+APP_USBD_HID_GENERIC_GLOBAL_DEF(m_app_hid,
+                                HID_INTERFACE,
+                                hid_user_ev_handler,
+                                (HID_EPIN),
+                                m_hid_reps,
+                                1,
+                                0,
+                                0,
+                                APP_USBD_HID_SUBCLASS_NONE,
+                                APP_USBD_HID_PROTO_GENERIC);
+
+static uint8_t m_cdc_rx_ring[CDC_RX_RING_SIZE];
+static uint8_t m_cdc_echo[CDC_ECHO_SIZE];
+static size_t  m_cdc_echo_len;
+static bool    m_cdc_tx_busy;
+static bool    m_cdc_open;
+
+static bool    m_hid_tx_done;
+static bool    m_suspended;
+
+/**
+ * @brief Echo received CDC ACM data once the previous write is done.
+ */
+static void cdc_echo_process(void)
+{
+    app_usbd_cdc_acm_t const * p_cdc_acm = &m_app_cdc_acm;
+    uint8_t const * p_data;
+    size_t size;
+
+    if (!m_cdc_open || m_cdc_tx_busy)
+    {
+        return;
+    }
+    while ((size = app_usbd_cdc_acm_rx_stream_get(p_cdc_acm, &p_data)) != 0)
+    {
+        size_t len = MIN(size, CDC_ECHO_SIZE - m_cdc_echo_len);
+        if (len == 0)
+        {
+            break;
+        }
+        memcpy(m_cdc_echo + m_cdc_echo_len, p_data, len);
+        m_cdc_echo_len += len;
+        APP_ERROR_CHECK(app_usbd_cdc_acm_rx_stream_free(p_cdc_acm, len));
+    }
+    if (m_cdc_echo_len != 0)
+    {
+        APP_ERROR_CHECK(app_usbd_cdc_acm_write(p_cdc_acm, m_cdc_echo, m_cdc_echo_len));
+        m_cdc_tx_busy = true;
+    }
+}
+
+static void cdc_acm_user_ev_handler(app_usbd_class_inst_t const * p_inst,
+                                    app_usbd_cdc_acm_user_event_t event)
+{
+    app_usbd_cdc_acm_t const * p_cdc_acm = app_usbd_cdc_acm_class_get(p_inst);
+
+    switch (event)
+    {
+        case APP_USBD_CDC_ACM_USER_EVT_PORT_OPEN:
+            APP_ERROR_CHECK(app_usbd_cdc_acm_rx_stream_start(p_cdc_acm,
+                                                             m_cdc_rx_ring,
+                                                             sizeof(m_cdc_rx_ring)));
+            m_cdc_open = true;
+            break;
+        case APP_USBD_CDC_ACM_USER_EVT_PORT_CLOSE:
+            m_cdc_open = false;
+            m_cdc_tx_busy = false;
+            m_cdc_echo_len = 0;
+            break;
+        case APP_USBD_CDC_ACM_USER_EVT_TX_DONE:
+            m_cdc_tx_busy = false;
+            m_cdc_echo_len = 0;
+            cdc_echo_process();
+            break;
+        case APP_USBD_CDC_ACM_USER_EVT_RX_DONE:
+            cdc_echo_process();
+            break;
+        default:
+            break;
+    }
+}
+
+static void hid_user_ev_handler(app_usbd_class_inst_t const * p_inst,
+                                app_usbd_hid_user_event_t     event)
+{
+    UNUSED_PARAMETER(p_inst);
+
+    if (event == APP_USBD_HID_USER_EVT_IN_REPORT_DONE)
+    {
+        m_hid_tx_done = true;
+    }
+}
+
+static void usbd_user_ev_handler(app_usbd_event_type_t event)
+{
+    switch (event)
+    {
+        case APP_USBD_EVT_DRV_SUSPEND:
+            m_suspended = true;
+            app_usbd_suspend_req();
+            break;
+        case APP_USBD_EVT_DRV_RESUME:
+            m_suspended = false;
+            break;
+        case APP_USBD_EVT_POWER_DETECTED:
+            if (!nrf_drv_usbd_is_enabled())
+            {
+                app_usbd_enable();
+            }
+            break;
+        case APP_USBD_EVT_POWER_REMOVED:
+            app_usbd_stop();
+            break;
+        case APP_USBD_EVT_POWER_READY:
+            app_usbd_start();
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Run the device main loop until it has nothing left to do.
+ */
+static void device_process(void)
+{
+#if APP_USBD_CONFIG_EVENT_QUEUE_ENABLE
+    while (app_usbd_event_queue_process())
+    {
+        /* Nothing to do */
+    }
+#endif
+    cdc_echo_process();
+}
+
+static void device_init(void)
+{
+    static const app_usbd_config_t usbd_config = {
+        .ev_state_proc = usbd_user_ev_handler
+    };
+
+    APP_ERROR_CHECK(nrf_drv_clock_init());
+    APP_ERROR_CHECK(app_usbd_init(&usbd_config));
+    APP_ERROR_CHECK(app_usbd_class_append(app_usbd_cdc_acm_class_inst_get(&m_app_cdc_acm)));
+    APP_ERROR_CHECK(app_usbd_class_append(app_usbd_msc_class_inst_get(&m_app_msc)));
+    APP_ERROR_CHECK(app_usbd_class_append(app_usbd_hid_generic_class_inst_get(&m_app_hid)));
+    APP_ERROR_CHECK(app_usbd_power_events_enable());
+}
+
+/* -------------------------------------------------------------------------
+ * Host
+ */
+
+/**
+ * @brief Repeat a transaction while it is NAKed, running the device in between.
+ *
+ * Each retry also advances the bus by one frame.
+ */
+#define HOST_RETRY(handshake, transaction)                                      \
+    do                                                                          \
+    {                                                                           \
+        for (unsigned retry = 0; retry < HOST_RETRY_CNT; ++retry)               \
+        {                                                                       \
+            (handshake) = (transaction);                                        \
+            if ((handshake) != USBD_SIM_NAK)                                    \
+            {                                                                   \
+                break;                                                          \
+            }                                                                   \
+            device_process();                                                   \
+            usbd_sim_sof();                                                     \
+        }                                                                       \
+    } while (0)
+
+/**
+ * @brief Run a whole control transfer.
+ *
+ * @param[in]     p_setup Setup packet.
+ * @param[in,out] p_data  Data stage buffer of wLength bytes, may be NULL if wLength is 0.
+ * @param[out]    p_size  Bytes moved in the data stage, may be NULL.
+ *
+ * @return Handshake of the first stage that did not ACK, or ACK.
+ */
+static usbd_sim_handshake_t host_control(nrfx_usbd_setup_t const * p_setup,
+                                         void *                    p_data,
+                                         size_t *                  p_size)
+{
+    usbd_sim_handshake_t hs;
+    uint8_t * p_buf = p_data;
+    size_t ep0_size = nrfx_usbd_ep_max_packet_size_get(NRFX_USBD_EPIN0);
+    size_t done = 0;
+
+    HOST_RETRY(hs, usbd_sim_setup(p_setup));
+    if (hs != USBD_SIM_ACK)
+    {
+        return hs;
+    }
+    device_process();
+
+    if (p_setup->bmRequestType & 0x80)
+    {
+        uint8_t packet[NRFX_USBD_EPSIZE];
+        size_t size = ep0_size;
+
+        while ((done < p_setup->wLength) && (size == ep0_size))
+        {
+            HOST_RETRY(hs, usbd_sim_in(NRFX_USBD_EPIN0, packet, &size));
+            if (hs != USBD_SIM_ACK)
+            {
+                return hs;
+            }
+            size = MIN(size, (size_t)(p_setup->wLength - done));
+            memcpy(p_buf + done, packet, size);
+            done += size;
+        }
+    }
+    else
+    {
+        while (done < p_setup->wLength)
+        {
+            size_t size = MIN(ep0_size, (size_t)(p_setup->wLength - done));
+            HOST_RETRY(hs, usbd_sim_out(NRFX_USBD_EPOUT0, p_buf + done, size));
+            if (hs != USBD_SIM_ACK)
+            {
+                return hs;
+            }
+            done += size;
+        }
+    }
+    if (p_size != NULL)
+    {
+        *p_size = done;
+    }
+
+    HOST_RETRY(hs, usbd_sim_status());
+    device_process();
+    return hs;
+}
+
+static usbd_sim_handshake_t host_descriptor_get(uint8_t  type,
+                                                uint8_t  index,
+                                                uint16_t lang,
+                                                void *   p_buf,
+                                                uint16_t length,
+                                                size_t * p_size)
+{
+    const nrfx_usbd_setup_t setup = {
+        .bmRequestType = STD_IN_DEVICE,
+        .bRequest      = APP_USBD_SETUP_STDREQ_GET_DESCRIPTOR,
+        .wValue        = (uint16_t)((type << 8) | index),
+        .wIndex        = lang,
+        .wLength       = length
+    };
+    return host_control(&setup, p_buf, p_size);
+}
+
+static usbd_sim_handshake_t host_clear_halt(nrfx_usbd_ep_t ep)
+{
+    const nrfx_usbd_setup_t setup = {
+        .bmRequestType = STD_OUT_EP,
+        .bRequest      = APP_USBD_SETUP_STDREQ_CLEAR_FEATURE,
+        .wValue        = APP_USBD_SETUP_STDFEATURE_ENDPOINT_HALT,
+        .wIndex        = ep
+    };
+    return host_control(&setup, NULL, NULL);
+}
+
+/**
+ * @brief Write a whole bulk transfer, splitting it into packets.
+ */
+static usbd_sim_handshake_t host_bulk_out(nrfx_usbd_ep_t ep, void const * p_data, size_t size)
+{
+    usbd_sim_handshake_t hs = USBD_SIM_ACK;
+    uint8_t const * p_buf = p_data;
+    size_t ep_size = nrfx_usbd_ep_max_packet_size_get(ep);
+
+    for (size_t done = 0; done < size; )
+    {
+        size_t len = MIN(ep_size, size - done);
+        HOST_RETRY(hs, usbd_sim_out(ep, p_buf + done, len));
+        if (hs != USBD_SIM_ACK)
+        {
+            break;
+        }
+        done += len;
+    }
+    device_process();
+    return hs;
+}
+
+/**
+ * @brief Read a bulk transfer until a short packet or @p size bytes.
+ */
+static usbd_sim_handshake_t host_bulk_in(nrfx_usbd_ep_t ep, void * p_data, size_t size, size_t * p_size)
+{
+    usbd_sim_handshake_t hs = USBD_SIM_ACK;
+    uint8_t * p_buf = p_data;
+    size_t ep_size = nrfx_usbd_ep_max_packet_size_get(ep);
+    size_t done = 0;
+    size_t len = ep_size;
+
+    while ((done < size) && (len == ep_size))
+    {
+        HOST_RETRY(hs, usbd_sim_in(ep, p_buf + done, &len));
+        if (hs != USBD_SIM_ACK)
+        {
+            break;
+        }
+        done += len;
+    }
+    *p_size = done;
+    device_process();
+    return hs;
+}
+
+static double time_ms(struct timespec const * p_start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - p_start->tv_sec) * 1e3 + (now.tv_nsec - p_start->tv_nsec) / 1e6;
+}
+
+static void bench_print(char const * p_name, size_t bytes, double ms)
+{
+    printf("  %-14s %8zu bytes in %8.2f ms, %8.2f MB/s\n",
+           p_name, bytes, ms, (ms > 0) ? (bytes / 1e3 / ms) : 0.0);
+}
+
+/* -------------------------------------------------------------------------
+ * Tests
+ */
+
+static void test_attach(void)
+{
+    TEST_CHECK(!usbd_sim_pullup_check());
+
+    usbd_sim_vbus_set(true);
+    device_process();
+    TEST_CHECK(usbd_sim_pullup_check());
+
+    usbd_sim_bus_reset();
+    device_process();
+    TEST_CHECK(usbd_sim_address_get() == 0);
+    TEST_CHECK(app_usbd_core_state_get() == APP_USBD_STATE_Default);
+}
+
+static void test_enumeration(void)
+{
+    uint8_t buf[256];
+    size_t size;
+
+    /* Device descriptor */
+    TEST_CHECK(host_descriptor_get(APP_USBD_DESCRIPTOR_DEVICE, 0, 0, buf, 64, &size) == USBD_SIM_ACK);
+    TEST_CHECK(size == 18);
+    TEST_CHECK((buf[0] == 18) && (buf[1] == APP_USBD_DESCRIPTOR_DEVICE));
+    TEST_CHECK(buf[7] == NRF_DRV_USBD_EPSIZE);
+    TEST_CHECK(uint16_decode(&buf[8])  == APP_USBD_VID);
+    TEST_CHECK(uint16_decode(&buf[10]) == APP_USBD_PID);
+    TEST_CHECK(buf[17] == 1);
+
+    /* Address, answered by the peripheral */
+    const nrfx_usbd_setup_t set_address = {
+        .bmRequestType = STD_OUT_DEVICE,
+        .bRequest      = APP_USBD_SETUP_STDREQ_SET_ADDRESS,
+        .wValue        = 5
+    };
+    TEST_CHECK(host_control(&set_address, NULL, NULL) == USBD_SIM_ACK);
+    TEST_CHECK(usbd_sim_address_get() == 5);
+    TEST_CHECK(app_usbd_core_state_get() == APP_USBD_STATE_Addressed);
+
+    /* Configuration descriptor, header first like a real host */
+    TEST_CHECK(host_descriptor_get(APP_USBD_DESCRIPTOR_CONFIGURATION, 0, 0, buf, 9, &size) == USBD_SIM_ACK);
+    TEST_CHECK(size == 9);
+    uint16_t total = uint16_decode(&buf[2]);
+    TEST_CHECK((total > 9) && (total <= sizeof(buf)));
+
+    TEST_CHECK(host_descriptor_get(APP_USBD_DESCRIPTOR_CONFIGURATION, 0, 0, buf, total, &size) == USBD_SIM_ACK);
+    TEST_CHECK(size == total);
+
+    unsigned ifaces = 0;
+    unsigned eps = 0;
+    for (size_t pos = 0; pos < total; pos += buf[pos])
+    {
+        TEST_CHECK((buf[pos] >= 2) && (pos + buf[pos] <= total));
+        ifaces += (buf[pos + 1] == APP_USBD_DESCRIPTOR_INTERFACE);
+        eps    += (buf[pos + 1] == APP_USBD_DESCRIPTOR_ENDPOINT);
+    }
+    TEST_CHECK(ifaces == INTERFACE_DSC_CNT);
+    TEST_CHECK(eps == ENDPOINT_DSC_CNT);
+
+    /* Strings */
+    TEST_CHECK(host_descriptor_get(APP_USBD_DESCRIPTOR_STRING, 0, 0, buf, 255, &size) == USBD_SIM_ACK);
+    TEST_CHECK((size == 4) && (uint16_decode(&buf[2]) == 0x0409));
+
+    static const char product[] = "usbd_sim";
+    TEST_CHECK(host_descriptor_get(APP_USBD_DESCRIPTOR_STRING, APP_USBD_STRING_ID_PRODUCT, 0x0409,
+                                   buf, 255, &size) == USBD_SIM_ACK);
+    TEST_CHECK(size == 2 + 2 * (sizeof(product) - 1));
+    for (size_t i = 0; i < sizeof(product) - 1; ++i)
+    {
+        TEST_CHECK(uint16_decode(&buf[2 + 2 * i]) == (uint16_t)product[i]);
+    }
+
+    TEST_CHECK(host_descriptor_get(APP_USBD_DESCRIPTOR_STRING, APP_USBD_STRING_ID_SERIAL, 0x0409,
+                                   buf, 255, &size) == USBD_SIM_ACK);
+    TEST_CHECK(size == 2 + 2 * SERIAL_NUM_STRING_SIZE);
+
+    /* Unknown requests are stalled and do not break the next one */
+    const nrfx_usbd_setup_t vendor = {
+        .bmRequestType = VENDOR_IN_DEV,
+        .bRequest      = 0x77,
+        .wLength       = 8
+    };
+    TEST_CHECK(host_control(&vendor, buf, NULL) == USBD_SIM_STALL);
+
+    const nrfx_usbd_setup_t set_config = {
+        .bmRequestType = STD_OUT_DEVICE,
+        .bRequest      = APP_USBD_SETUP_STDREQ_SET_CONFIGURATION,
+        .wValue        = 1
+    };
+    TEST_CHECK(host_control(&set_config, NULL, NULL) == USBD_SIM_ACK);
+    TEST_CHECK(app_usbd_core_state_get() == APP_USBD_STATE_Configured);
+
+    const nrfx_usbd_setup_t get_config = {
+        .bmRequestType = STD_IN_DEVICE,
+        .bRequest      = APP_USBD_SETUP_STDREQ_GET_CONFIGURATION,
+        .wLength       = 1
+    };
+    TEST_CHECK(host_control(&get_config, buf, &size) == USBD_SIM_ACK);
+    TEST_CHECK((size == 1) && (buf[0] == 1));
+}
+
+static void test_cdc_acm(void)
+{
+    static const app_usbd_cdc_line_coding_t coding = {
+        .dwDTERate   = { 0x00, 0xC2, 0x01, 0x00 },  /* 115200 */
+        .bCharFormat = 0,
+        .bParityType = 0,
+        .bDataBits   = 8
+    };
+    app_usbd_cdc_line_coding_t readback;
+    size_t size;
+
+    const nrfx_usbd_setup_t set_line_coding = {
+        .bmRequestType = CLASS_OUT_IFACE,
+        .bRequest      = APP_USBD_CDC_REQ_SET_LINE_CODING,
+        .wIndex        = CDC_ACM_COMM_INTERFACE,
+        .wLength       = sizeof(coding)
+    };
+    TEST_CHECK(host_control(&set_line_coding, (void *)&coding, NULL) == USBD_SIM_ACK);
+
+    const nrfx_usbd_setup_t get_line_coding = {
+        .bmRequestType = CLASS_IN_IFACE,
+        .bRequest      = APP_USBD_CDC_REQ_GET_LINE_CODING,
+        .wIndex        = CDC_ACM_COMM_INTERFACE,
+        .wLength       = sizeof(readback)
+    };
+    TEST_CHECK(host_control(&get_line_coding, &readback, &size) == USBD_SIM_ACK);
+    TEST_CHECK((size == sizeof(readback)) && (memcmp(&readback, &coding, sizeof(coding)) == 0));
+
+    /* DTR opens the port */
+    const nrfx_usbd_setup_t set_dtr = {
+        .bmRequestType = CLASS_OUT_IFACE,
+        .bRequest      = APP_USBD_CDC_REQ_SET_CONTROL_LINE_STATE,
+        .wValue        = 0x0001,
+        .wIndex        = CDC_ACM_COMM_INTERFACE
+    };
+    TEST_CHECK(host_control(&set_dtr, NULL, NULL) == USBD_SIM_ACK);
+    TEST_CHECK(m_cdc_open);
+
+    /* Loopback, the device echoes every byte */
+    static uint8_t tx[BENCH_CDC_SIZE];
+    static uint8_t rx[BENCH_CDC_SIZE];
+    size_t ep_size = nrfx_usbd_ep_max_packet_size_get(CDC_ACM_DATA_EPOUT);
+    size_t sent = 0;
+    size_t received = 0;
+    unsigned idle = 0;
+    struct timespec start;
+
+    for (size_t i = 0; i < sizeof(tx); ++i)
+    {
+        tx[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while ((received < sizeof(tx)) && (idle < HOST_RETRY_CNT))
+    {
+        bool progress = false;
+        if (sent < sizeof(tx))
+        {
+            size_t len = MIN(ep_size, sizeof(tx) - sent);
+            usbd_sim_handshake_t hs = usbd_sim_out(CDC_ACM_DATA_EPOUT, &tx[sent], len);
+            TEST_CHECK(hs != USBD_SIM_STALL);
+            if (hs == USBD_SIM_ACK)
+            {
+                sent += len;
+                progress = true;
+            }
+        }
+        size_t len;
+        usbd_sim_handshake_t hs = usbd_sim_in(CDC_ACM_DATA_EPIN, &rx[received], &len);
+        TEST_CHECK(hs != USBD_SIM_STALL);
+        if (hs == USBD_SIM_ACK)
+        {
+            TEST_CHECK(received + len <= sizeof(rx));
+            received += len;
+            progress = true;
+        }
+        idle = progress ? 0 : (idle + 1);
+        device_process();
+    }
+    double ms = time_ms(&start);
+    TEST_CHECK(received == sizeof(tx));
+    TEST_CHECK(memcmp(tx, rx, sizeof(tx)) == 0);
+    bench_print("cdc_acm echo", received, ms);
+
+    /* Dropping DTR closes the port */
+    const nrfx_usbd_setup_t clear_dtr = {
+        .bmRequestType = CLASS_OUT_IFACE,
+        .bRequest      = APP_USBD_CDC_REQ_SET_CONTROL_LINE_STATE,
+        .wIndex        = CDC_ACM_COMM_INTERFACE
+    };
+    TEST_CHECK(host_control(&clear_dtr, NULL, NULL) == USBD_SIM_ACK);
+    TEST_CHECK(!m_cdc_open);
+}
+
+/**
+ * @brief Run one Bulk-Only Transport command.
+ *
+ * @return SCSI status from the CSW, -1 on a transport failure.
+ */
+static int msc_command(uint8_t const * p_cb,
+                       uint8_t         cb_len,
+                       bool            data_in,
+                       void *          p_data,
+                       uint32_t        data_len)
+{
+    static uint32_t tag;
+    uint8_t cbw[MSC_CBW_SIZE] = { 0 };
+    uint8_t csw[MSC_CSW_SIZE];
+    size_t size;
+
+    ++tag;
+    UNUSED_RETURN_VALUE(uint32_encode(MSC_CBW_SIGNATURE, &cbw[0]));
+    UNUSED_RETURN_VALUE(uint32_encode(tag, &cbw[4]));
+    UNUSED_RETURN_VALUE(uint32_encode(data_len, &cbw[8]));
+    cbw[12] = data_in ? 0x80 : 0x00;
+    cbw[14] = cb_len;
+    memcpy(&cbw[15], p_cb, cb_len);
+
+    if (host_bulk_out(NRF_DRV_USBD_EPOUT3, cbw, sizeof(cbw)) != USBD_SIM_ACK)
+    {
+        return -1;
+    }
+    if (data_len != 0)
+    {
+        usbd_sim_handshake_t hs = data_in ?
+            host_bulk_in(NRF_DRV_USBD_EPIN3, p_data, data_len, &size) :
+            host_bulk_out(NRF_DRV_USBD_EPOUT3, p_data, data_len);
+
+        if (hs == USBD_SIM_STALL)
+        {
+            /* Failed command: clearing the IN halt makes the device send the CSW */
+            if ((!data_in && (host_clear_halt(NRF_DRV_USBD_EPOUT3) != USBD_SIM_ACK)) ||
+                (host_clear_halt(NRF_DRV_USBD_EPIN3) != USBD_SIM_ACK))
+            {
+                return -1;
+            }
+        }
+        else if ((hs != USBD_SIM_ACK) || (data_in && (size != data_len)))
+        {
+            return -1;
+        }
+    }
+    if ((host_bulk_in(NRF_DRV_USBD_EPIN3, csw, sizeof(csw), &size) != USBD_SIM_ACK) ||
+        (size != sizeof(csw))                                                         ||
+        (uint32_decode(&csw[0]) != MSC_CSW_SIGNATURE)                                 ||
+        (uint32_decode(&csw[4]) != tag))
+    {
+        return -1;
+    }
+    return csw[12];
+}
+
+static int msc_rw10(bool read, uint32_t lba, uint16_t blocks, void * p_data)
+{
+    uint8_t cb[10] = { read ? 0x28 : 0x2A };
+
+    cb[2] = (uint8_t)(lba >> 24);
+    cb[3] = (uint8_t)(lba >> 16);
+    cb[4] = (uint8_t)(lba >> 8);
+    cb[5] = (uint8_t)(lba);
+    cb[7] = (uint8_t)(blocks >> 8);
+    cb[8] = (uint8_t)(blocks);
+    return msc_command(cb, sizeof(cb), read, p_data, (uint32_t)blocks * RAM_DISK_BLOCK_SIZE);
+}
+
+static void test_msc(void)
+{
+    uint8_t buf[64];
+    size_t size;
+
+    const nrfx_usbd_setup_t get_max_lun = {
+        .bmRequestType = CLASS_IN_IFACE,
+        .bRequest      = APP_USBD_MSC_REQ_GET_MAX_LUN,
+        .wIndex        = MSC_INTERFACE,
+        .wLength       = 1
+    };
+    TEST_CHECK(host_control(&get_max_lun, buf, &size) == USBD_SIM_ACK);
+    TEST_CHECK((size == 1) && (buf[0] == 0));
+
+    static const uint8_t inquiry[6] = { 0x12, 0, 0, 0, 36, 0 };
+    TEST_CHECK(msc_command(inquiry, sizeof(inquiry), true, buf, 36) == 0);
+    TEST_CHECK(memcmp(&buf[8], "Nordic", 6) == 0);
+
+    static const uint8_t test_unit_ready[6] = { 0x00 };
+    TEST_CHECK(msc_command(test_unit_ready, sizeof(test_unit_ready), false, NULL, 0) == 0);
+
+    static const uint8_t read_capacity[10] = { 0x25 };
+    TEST_CHECK(msc_command(read_capacity, sizeof(read_capacity), true, buf, 8) == 0);
+    TEST_CHECK(uint32_big_decode(&buf[0]) == RAM_DISK_BLOCK_CNT - 1);
+    TEST_CHECK(uint32_big_decode(&buf[4]) == RAM_DISK_BLOCK_SIZE);
+
+    /* Write, check the RAM disk, read back */
+    static uint8_t wr[RAM_DISK_BLOCK_SIZE * 8];
+    static uint8_t rd[sizeof(wr)];
+    for (size_t i = 0; i < sizeof(wr); ++i)
+    {
+        wr[i] = (uint8_t)(i ^ (i >> 9) ^ 0x5A);
+    }
+    TEST_CHECK(msc_rw10(false, 4, 8, wr) == 0);
+    TEST_CHECK(app_usbd_msc_sync(&m_app_msc));
+    TEST_CHECK(memcmp(&m_ram_disk[4 * RAM_DISK_BLOCK_SIZE], wr, sizeof(wr)) == 0);
+    TEST_CHECK(msc_rw10(true, 4, 8, rd) == 0);
+    TEST_CHECK(memcmp(rd, wr, sizeof(wr)) == 0);
+
+    /* Out of range access fails with CHECK CONDITION */
+    TEST_CHECK(msc_rw10(true, RAM_DISK_BLOCK_CNT, 1, rd) == 1);
+
+    /* Throughput over the whole disk */
+    static uint8_t disk[sizeof(m_ram_disk)];
+    struct timespec start;
+    double ms;
+    uint16_t chunk = sizeof(wr) / RAM_DISK_BLOCK_SIZE;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned pass = 0; pass < BENCH_MSC_PASSES; ++pass)
+    {
+        for (uint32_t lba = 0; lba < RAM_DISK_BLOCK_CNT; lba += chunk)
+        {
+            wr[0] = (uint8_t)pass;
+            wr[1] = (uint8_t)lba;
+            TEST_CHECK(msc_rw10(false, lba, chunk, wr) == 0);
+        }
+    }
+    ms = time_ms(&start);
+    bench_print("msc write10", (size_t)BENCH_MSC_PASSES * sizeof(m_ram_disk), ms);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned pass = 0; pass < BENCH_MSC_PASSES; ++pass)
+    {
+        for (uint32_t lba = 0; lba < RAM_DISK_BLOCK_CNT; lba += chunk)
+        {
+            TEST_CHECK(msc_rw10(true, lba, chunk, &disk[lba * RAM_DISK_BLOCK_SIZE]) == 0);
+        }
+    }
+    ms = time_ms(&start);
+    bench_print("msc read10", (size_t)BENCH_MSC_PASSES * sizeof(m_ram_disk), ms);
+    TEST_CHECK(memcmp(disk, m_ram_disk, sizeof(disk)) == 0);
+}
+
+static void test_hid(void)
+{
+    uint8_t buf[64];
+    size_t size;
+
+    const nrfx_usbd_setup_t get_report_desc = {
+        .bmRequestType = STD_IN_IFACE,
+        .bRequest      = APP_USBD_SETUP_STDREQ_GET_DESCRIPTOR,
+        .wValue        = APP_USBD_DESCRIPTOR_REPORT << 8,
+        .wIndex        = HID_INTERFACE,
+        .wLength       = sizeof(buf)
+    };
+    TEST_CHECK(host_control(&get_report_desc, buf, &size) == USBD_SIM_ACK);
+    TEST_CHECK((size == m_hid_report_desc.size) &&
+               (memcmp(buf, m_hid_report_desc.p_data, size) == 0));
+
+    /* Nothing to send yet */
+    TEST_CHECK(usbd_sim_in(HID_EPIN, buf, &size) == USBD_SIM_NAK);
+
+    uint8_t report[HID_REPORT_SIZE];
+    unsigned reports = 0;
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        usbd_sim_handshake_t hs;
+
+        memset(report, (int)i, sizeof(report));
+        m_hid_tx_done = false;
+        TEST_CHECK(app_usbd_hid_generic_in_report_set(&m_app_hid, report, sizeof(report)) == NRF_SUCCESS);
+        HOST_RETRY(hs, usbd_sim_in(HID_EPIN, buf, &size));
+        TEST_CHECK(hs == USBD_SIM_ACK);
+        TEST_CHECK((size == sizeof(report)) && (memcmp(buf, report, size) == 0));
+        device_process();
+        TEST_CHECK(m_hid_tx_done);
+        ++reports;
+    }
+    bench_print("hid in report", reports * sizeof(report), time_ms(&start));
+}
+
+static void test_suspend(void)
+{
+    usbd_sim_bus_suspend();
+    device_process();
+    TEST_CHECK(m_suspended);
+    TEST_CHECK(nrfx_usbd_suspend_check());
+
+    usbd_sim_bus_resume();
+    device_process();
+    TEST_CHECK(!m_suspended);
+    TEST_CHECK(app_usbd_core_state_get() == APP_USBD_STATE_Configured);
+}
+
+static void test_detach(void)
+{
+    usbd_sim_vbus_set(false);
+    device_process();
+    TEST_CHECK(!usbd_sim_pullup_check());
+
+    /* Plug in again and enumerate from scratch */
+    usbd_sim_vbus_set(true);
+    device_process();
+    TEST_CHECK(usbd_sim_pullup_check());
+    usbd_sim_bus_reset();
+    device_process();
+    TEST_CHECK(app_usbd_core_state_get() == APP_USBD_STATE_Default);
+}
+
+int main(void)
+{
+    static const struct
+    {
+        char const * p_name;
+        void      (* test)(void);
+    } tests[] =
+    {
+        { "attach",      test_attach      },
+        { "enumeration", test_enumeration },
+        { "cdc_acm",     test_cdc_acm     },
+        { "msc",         test_msc         },
+        { "hid",         test_hid         },
+        { "suspend",     test_suspend     },
+        { "detach",      test_detach      },
+    };
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    device_init();
+    for (size_t i = 0; i < ARRAY_SIZE(tests); ++i)
+    {
+        unsigned failures = m_failures;
+        printf("%s\n", tests[i].p_name);
+        tests[i].test();
+        printf("  %s\n", (failures == m_failures) ? "ok" : "FAILED");
+    }
+    printf("%u failure(s)\n", m_failures);
+    return (m_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
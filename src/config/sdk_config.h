@@ -652,6 +652,48 @@
 
 // </e>
 
+// <e> ANT_COMMON_PAGE_70_ENABLED - ant_common_page_70 - ANT+ common page 70
+//==========================================================
+#ifndef ANT_COMMON_PAGE_70_ENABLED
+#define ANT_COMMON_PAGE_70_ENABLED 1
+#endif
+// <e> ANT_COMMON_PAGE_70_LOG_ENABLED - Enables logging of common page 70 in the module.
+//==========================================================
+#ifndef ANT_COMMON_PAGE_70_LOG_ENABLED
+#define ANT_COMMON_PAGE_70_LOG_ENABLED 0
+#endif
+// <o> ANT_COMMON_PAGE_70_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef ANT_COMMON_PAGE_70_LOG_LEVEL
+#define ANT_COMMON_PAGE_70_LOG_LEVEL 3
+#endif
+
+// <o> ANT_COMMON_PAGE_70_INFO_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef ANT_COMMON_PAGE_70_INFO_COLOR
+#define ANT_COMMON_PAGE_70_INFO_COLOR 0
+#endif
+
+// </e>
+
+// </e>
+
 // <e> ANT_COMMON_PAGE_80_ENABLED - ant_common_page_80 - ANT+ common page 80
 //==========================================================
 #ifndef ANT_COMMON_PAGE_80_ENABLED
@@ -3319,7 +3361,7 @@
 // <e> NRFX_PPI_ENABLED - nrfx_ppi - PPI peripheral allocator
 //==========================================================
 #ifndef NRFX_PPI_ENABLED
-#define NRFX_PPI_ENABLED 0
+#define NRFX_PPI_ENABLED 1
 #endif
 // <e> NRFX_PPI_CONFIG_LOG_ENABLED - Enables logging in the module.
 //==========================================================
@@ -5710,7 +5752,7 @@
  
 
 #ifndef PPI_ENABLED
-#define PPI_ENABLED 0
+#define PPI_ENABLED 1
 #endif
 
 // <e> PWM_ENABLED - nrf_drv_pwm - PWM peripheral driver - legacy layer
@@ -7348,7 +7390,7 @@
 // <e> APP_USBD_HID_ENABLED - app_usbd_hid - USB HID class
 //==========================================================
 #ifndef APP_USBD_HID_ENABLED
-#define APP_USBD_HID_ENABLED 0
+#define APP_USBD_HID_ENABLED 1
 #endif
 // <o> APP_USBD_HID_DEFAULT_IDLE_RATE - Default idle rate for HID class.   <0-255> 
 
@@ -7374,7 +7416,7 @@
  
 
 #ifndef APP_USBD_HID_GENERIC_ENABLED
-#define APP_USBD_HID_GENERIC_ENABLED 0
+#define APP_USBD_HID_GENERIC_ENABLED 1
 #endif
 
 // <q> APP_USBD_HID_KBD_ENABLED  - app_usbd_hid_kbd - USB HID keyboard
@@ -7395,22 +7437,45 @@
  
 
 #ifndef APP_USBD_MSC_ENABLED
-#define APP_USBD_MSC_ENABLED 0
+#define APP_USBD_MSC_ENABLED 1
 #endif
 
-// <q> CRC16_ENABLED  - crc16 - CRC16 calculation routines
- 
-
+// <e> CRC16_ENABLED - crc16 - CRC16 calculation routines
+//==========================================================
 #ifndef CRC16_ENABLED
 #define CRC16_ENABLED 0
 #endif
-
-// <q> CRC32_ENABLED  - crc32 - CRC32 calculation routines
+// <o> CRC16_CONFIG_ALGORITHM  - Implementation
  
+// <i> Table-driven implementations are faster but need a lookup table in flash.
+// <0=> Shift 
+// <1=> Table (512 B) 
+// <2=> Word (2 kB) 
+
+#ifndef CRC16_CONFIG_ALGORITHM
+#define CRC16_CONFIG_ALGORITHM 1
+#endif
+
+// </e>
 
+// <e> CRC32_ENABLED - crc32 - CRC32 calculation routines
+//==========================================================
 #ifndef CRC32_ENABLED
 #define CRC32_ENABLED 0
 #endif
+// <o> CRC32_CONFIG_ALGORITHM  - Implementation
+ 
+// <i> Table-driven implementations are faster but need a lookup table in flash.
+// <0=> Bitwise 
+// <1=> Table (1 kB) 
+// <2=> Slicing-by-4 (4 kB) 
+// <3=> Slicing-by-8 (8 kB) 
+
+#ifndef CRC32_CONFIG_ALGORITHM
+#define CRC32_CONFIG_ALGORITHM 1
+#endif
+
+// </e>
 
 // <q> ECC_ENABLED  - ecc - Elliptic Curve Cryptography Library
  
@@ -7494,6 +7559,53 @@
 // </h> 
 //==========================================================
 
+// <h> Index - Record index settings
+
+//==========================================================
+// <o> FDS_INDEX_SIZE  - Number of entries in the RAM record index.
+ 
+
+// <i> Records are indexed in RAM by file ID and record key, so that searching for records does not scan flash.
+// <i> Each entry takes 8 bytes and is stored twice, so that the index can be rebuilt with interrupts enabled. The index holds up to 3/4 of its size in records; if there are more, searches scan flash until the next garbage collection.
+// <i> Searches by file ID or record key alone walk the whole index, 16 entries per critical section. Garbage collection drops the records of the collected page in one critical section that walks all entries.
+// <0=> Disabled 
+// <16=> 16 
+// <32=> 32 
+// <64=> 64 
+// <128=> 128 
+// <256=> 256 
+
+#ifndef FDS_INDEX_SIZE
+#define FDS_INDEX_SIZE 32
+#endif
+
+// </h> 
+//==========================================================
+
+// <h> GC - Garbage collection settings
+
+//==========================================================
+// <q> FDS_GC_INCREMENTAL  - Garbage collect one virtual page at a time.
+ 
+
+// <i> Garbage collection yields after each virtual page, so that operations queued in the meantime run before the next page is collected.
+// <i> An FDS_EVT_GC_STEP event reports each page and the time spent on it, in app_timer ticks.
+
+#ifndef FDS_GC_INCREMENTAL
+#define FDS_GC_INCREMENTAL 1
+#endif
+
+// <o> FDS_GC_DIRTY_THRESHOLD - Words of deleted records on a page that start garbage collection automatically. 
+// <i> When deleting or updating a record brings a page to this many words of deleted records, garbage collection of such pages is started.
+// <i> Set to 0 to only run garbage collection when fds_gc() is called.
+
+#ifndef FDS_GC_DIRTY_THRESHOLD
+#define FDS_GC_DIRTY_THRESHOLD 256
+#endif
+
+// </h> 
+//==========================================================
+
 // <h> CRC - CRC functionality
 
 //==========================================================
@@ -7553,6 +7665,13 @@
 #define HCI_TX_BUF_SIZE 600
 #endif
 
+// <o> HCI_TX_BUF_COUNT - Number of TX buffers. 
+// <i> Packets written to hci_transport while another packet waits for acknowledgement
+// <i> are queued, so the next packet is sent as soon as the previous one is acknowledged.
+#ifndef HCI_TX_BUF_COUNT
+#define HCI_TX_BUF_COUNT 1
+#endif
+
 // <o> HCI_RX_BUF_SIZE - RX buffer size in bytes. 
 #ifndef HCI_RX_BUF_SIZE
 #define HCI_RX_BUF_SIZE 600
@@ -7869,6 +7988,20 @@
 
 // </e>
 
+// <q> NRF_BLOCK_DEV_CACHE_ENABLED  - nrf_block_dev_cache - Caching block device
+ 
+
+#ifndef NRF_BLOCK_DEV_CACHE_ENABLED
+#define NRF_BLOCK_DEV_CACHE_ENABLED 0
+#endif
+
+// <q> NRF_BLOCK_DEV_RAM_ENABLED  - nrf_block_dev_ram - RAM block device
+ 
+
+#ifndef NRF_BLOCK_DEV_RAM_ENABLED
+#define NRF_BLOCK_DEV_RAM_ENABLED 1
+#endif
+
 // <e> NRF_CSENSE_ENABLED - nrf_csense - Capacitive sensor module
 //==========================================================
 #ifndef NRF_CSENSE_ENABLED
@@ -8140,7 +8273,7 @@
 // <e> NRF_QUEUE_ENABLED - nrf_queue - Queue module
 //==========================================================
 #ifndef NRF_QUEUE_ENABLED
-#define NRF_QUEUE_ENABLED 0
+#define NRF_QUEUE_ENABLED 1
 #endif
 // <q> NRF_QUEUE_CLI_CMDS  - Enable CLI commands specific to the module
  
@@ -8284,6 +8417,57 @@
 #define APP_USBD_CDC_ACM_ZLP_ON_EPSIZE_WRITE 1
 #endif
 
+// <o> APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE - Number of memory object writes that can be queued  <1-255> 
+
+
+// <i> Memory objects written with app_usbd_cdc_acm_write_memobj are sent without copying.
+// <i> Each queued write holds a reference to its memory object until it is sent.
+
+#ifndef APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE
+#define APP_USBD_CDC_ACM_MEMOBJ_TX_QUEUE_SIZE 4
+#endif
+
+// </h> 
+//==========================================================
+
+// <h> app_usbd_vendor - USB vendor-specific bulk class
+
+//==========================================================
+// <q> APP_USBD_VENDOR_ENABLED  - Enabling USBD vendor-specific bulk class library
+ 
+
+#ifndef APP_USBD_VENDOR_ENABLED
+#define APP_USBD_VENDOR_ENABLED 1
+#endif
+
+// <q> APP_USBD_VENDOR_ZLP_ON_EPSIZE_WRITE  - Send ZLP on write with same size as endpoint
+ 
+
+// <i> If enabled, a write with a length that is a multiple of the endpoint size is terminated with a zero length packet.
+// <i> Disable it if the host always reads the exact number of bytes it expects.
+
+#ifndef APP_USBD_VENDOR_ZLP_ON_EPSIZE_WRITE
+#define APP_USBD_VENDOR_ZLP_ON_EPSIZE_WRITE 1
+#endif
+
+// <o> APP_USBD_VENDOR_TX_QUEUE_SIZE - Number of writes that can be queued  <1-255> 
+
+
+// <i> Each queued write holds its buffer until APP_USBD_VENDOR_USER_EVT_TX_DONE is reported for it.
+
+#ifndef APP_USBD_VENDOR_TX_QUEUE_SIZE
+#define APP_USBD_VENDOR_TX_QUEUE_SIZE 8
+#endif
+
+// <o> APP_USBD_VENDOR_RX_QUEUE_SIZE - Number of receive buffers that can be queued  <1-255> 
+
+
+// <i> With two or more buffers the next read is armed before the previous one is handled.
+
+#ifndef APP_USBD_VENDOR_RX_QUEUE_SIZE
+#define APP_USBD_VENDOR_RX_QUEUE_SIZE 2
+#endif
+
 // </h> 
 //==========================================================
 
@@ -8421,6 +8605,15 @@
 // <h> nRF_Log 
 
 //==========================================================
+// <q> NRF_LOG_BACKEND_CDC_ACM_ENABLED  - nrf_log_backend_cdc_acm - Log USB CDC ACM backend
+ 
+
+// <i> Forwards log entries in binary form over a USB CDC ACM port without copying them.
+
+#ifndef NRF_LOG_BACKEND_CDC_ACM_ENABLED
+#define NRF_LOG_BACKEND_CDC_ACM_ENABLED 0
+#endif
+
 // <e> NRF_LOG_BACKEND_RTT_ENABLED - nrf_log_backend_rtt - Log RTT backend
 //==========================================================
 #ifndef NRF_LOG_BACKEND_RTT_ENABLED
@@ -8452,6 +8645,17 @@
 #define NRF_LOG_BACKEND_RTT_TX_RETRY_CNT 3
 #endif
 
+// <q> NRF_LOG_BACKEND_RTT_BINARY  - Write entries in binary form
+ 
+
+// <i> Entries are not formatted on the device. They are decoded on the host
+// <i> using the application ELF file (external_tools/nrf_log_decoder).
+// <i> The temporary buffer must fit the largest entry.
+
+#ifndef NRF_LOG_BACKEND_RTT_BINARY
+#define NRF_LOG_BACKEND_RTT_BINARY 0
+#endif
+
 // </e>
 
 // <e> NRF_LOG_BACKEND_UART_ENABLED - nrf_log_backend_uart - Log UART backend
@@ -8593,6 +8797,16 @@
 #define NRF_LOG_FILTERS_ENABLED 0
 #endif
 
+// <q> NRF_LOG_RATE_LIMIT_ENABLED  - Enable per-module rate limiting and sampling of logs.
+ 
+
+// <i> Requires NRF_LOG_FILTERS_ENABLED. Limits are configured at runtime
+// <i> with nrf_log_module_rate_limit_set or the CLI, and stored with the filters.
+
+#ifndef NRF_LOG_RATE_LIMIT_ENABLED
+#define NRF_LOG_RATE_LIMIT_ENABLED 0
+#endif
+
 // <q> NRF_LOG_NON_DEFFERED_CRITICAL_REGION_ENABLED  - Enable use of critical region for non deffered mode when flushing logs.
  
 
@@ -10339,6 +10553,57 @@
 
 // </e>
 
+// <e> APP_USBD_VENDOR_CONFIG_LOG_ENABLED - Enables logging in the module.
+//==========================================================
+#ifndef APP_USBD_VENDOR_CONFIG_LOG_ENABLED
+#define APP_USBD_VENDOR_CONFIG_LOG_ENABLED 0
+#endif
+// <o> APP_USBD_VENDOR_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef APP_USBD_VENDOR_CONFIG_LOG_LEVEL
+#define APP_USBD_VENDOR_CONFIG_LOG_LEVEL 3
+#endif
+
+// <o> APP_USBD_VENDOR_CONFIG_INFO_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef APP_USBD_VENDOR_CONFIG_INFO_COLOR
+#define APP_USBD_VENDOR_CONFIG_INFO_COLOR 0
+#endif
+
+// <o> APP_USBD_VENDOR_CONFIG_DEBUG_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef APP_USBD_VENDOR_CONFIG_DEBUG_COLOR
+#define APP_USBD_VENDOR_CONFIG_DEBUG_COLOR 0
+#endif
+
+// </e>
+
 // <e> NRF_ATFIFO_CONFIG_LOG_ENABLED - Enables logging in the module.
 //==========================================================
 #ifndef NRF_ATFIFO_CONFIG_LOG_ENABLED
@@ -10469,6 +10734,69 @@
 
 // </e>
 
+// <e> NRF_BLOCK_DEV_CACHE_CONFIG_LOG_ENABLED - Enables logging in the module.
+//==========================================================
+#ifndef NRF_BLOCK_DEV_CACHE_CONFIG_LOG_ENABLED
+#define NRF_BLOCK_DEV_CACHE_CONFIG_LOG_ENABLED 0
+#endif
+// <o> NRF_BLOCK_DEV_CACHE_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef NRF_BLOCK_DEV_CACHE_CONFIG_LOG_LEVEL
+#define NRF_BLOCK_DEV_CACHE_CONFIG_LOG_LEVEL 3
+#endif
+
+// <o> NRF_BLOCK_DEV_CACHE_CONFIG_LOG_INIT_FILTER_LEVEL  - Initial severity level if dynamic filtering is enabled
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef NRF_BLOCK_DEV_CACHE_CONFIG_LOG_INIT_FILTER_LEVEL
+#define NRF_BLOCK_DEV_CACHE_CONFIG_LOG_INIT_FILTER_LEVEL 3
+#endif
+
+// <o> NRF_BLOCK_DEV_CACHE_CONFIG_INFO_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRF_BLOCK_DEV_CACHE_CONFIG_INFO_COLOR
+#define NRF_BLOCK_DEV_CACHE_CONFIG_INFO_COLOR 0
+#endif
+
+// <o> NRF_BLOCK_DEV_CACHE_CONFIG_DEBUG_COLOR  - ANSI escape code prefix.
+ 
+// <0=> Default 
+// <1=> Black 
+// <2=> Red 
+// <3=> Green 
+// <4=> Yellow 
+// <5=> Blue 
+// <6=> Magenta 
+// <7=> Cyan 
+// <8=> White 
+
+#ifndef NRF_BLOCK_DEV_CACHE_CONFIG_DEBUG_COLOR
+#define NRF_BLOCK_DEV_CACHE_CONFIG_DEBUG_COLOR 0
+#endif
+
+// </e>
+
 // <e> NRF_BLOCK_DEV_EMPTY_CONFIG_LOG_ENABLED - Enables logging in the module.
 //==========================================================
 #ifndef NRF_BLOCK_DEV_EMPTY_CONFIG_LOG_ENABLED
@@ -11456,6 +11784,15 @@
 #define NRF_LOG_STR_FORMATTER_TIMESTAMP_FORMAT_ENABLED 1
 #endif
 
+// <o> NRF_LOG_STR_FORMATTER_PLAN_CACHE_SIZE - Number of precompiled log format strings. 
+// <i> The string formatter compiles format strings into format plans (see nrf_fprintf_plan_compile)
+// <i> and keeps them in a direct-mapped cache, so that frequent log entries are not parsed
+// <i> every time. Each entry takes about 70 bytes of RAM. 0 disables the cache.
+
+#ifndef NRF_LOG_STR_FORMATTER_PLAN_CACHE_SIZE
+#define NRF_LOG_STR_FORMATTER_PLAN_CACHE_SIZE 8
+#endif
+
 // </h> 
 //==========================================================
 
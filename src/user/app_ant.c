@@ -9,8 +9,10 @@
 */
 
 /* Includes ----------------------------------------------------------- */
+#include <string.h>
 #include "nrf_sdh.h"
 #include "nrf_sdh_ant.h"
+#include "ant_interface.h"
 #include "nrf_log.h"
 #include "app_error.h"
 #include "app_ant.h"
@@ -20,8 +22,12 @@
 #include "ant_hrm.h"
 #include "ant_bpwr.h"
 #include "ant_bsc.h"
+#include "ant_common_page_70.h"
 
 #include "app_usb.h"
+#include "app_cmd.h"
+#include "app_capture.h"
+#include "app_util_platform.h"
 
 /* Private defines ---------------------------------------------------- */
 #define WHEEL_CIRCUMFERENCE         2070                                         /**< Bike wheel circumference [mm] */
@@ -34,6 +40,9 @@
                                      / BSC_MS_TO_KPH_DEN / BSC_MM_TO_M_FACTOR)   /**< Coefficient for speed value calculation */
 #define CADENCE_COEFFICIENT         (BSC_EVT_TIME_FACTOR * BSC_RPM_TIME_FACTOR)  /**< Coefficient for cadence value calculation */
 
+#define APP_ANT_RECORD_OBSERVER_PRIO  0    /**< Stamp ANT events before the profiles handle them */
+#define APP_ANT_RECORD_QUEUE_SIZE     16   /**< Number of stamped messages waiting for the host, power of 2 */
+
 /* Private macros ----------------------------------------------------- */
 /* Private enumerate/structure ---------------------------------------- */
 typedef struct
@@ -47,12 +56,22 @@ typedef struct
 } 
 bsc_disp_calc_data_t;
 
+typedef struct
+{
+  app_usb_timestamp_t ts;
+  uint8_t             channel;
+  uint8_t             mesg_id;
+  uint8_t             payload[ANT_STANDARD_DATA_PAYLOAD_SIZE];
+}
+ant_record_t;
+
 /* Public variables --------------------------------------------------- */
 /* Private function prototypes ---------------------------------------- */
 /*! EVT functions */
 static void m_ant_hrm_evt_handler(ant_hrm_profile_t *p_profile, ant_hrm_evt_t event);
 static void m_ant_bpwr_evt_handler(ant_bpwr_profile_t *p_profile, ant_bpwr_evt_t event);
 static void m_ant_bsc_evt_handler(ant_bsc_profile_t *p_profile, ant_bsc_evt_t event);
+static void m_ant_record_evt_handler(ant_evt_t *p_ant_evt, void *p_context);
 
 /*! Support functions */
 static uint32_t m_calculate_speed(int32_t rev_cnt, int32_t evt_time);
@@ -63,6 +82,16 @@ static char m_tx_buff[256] = { 0 };
 static bsc_disp_calc_data_t m_speed_calc_data = {0};
 static bsc_disp_calc_data_t m_cadence_calc_data = {0};
 
+/*! Stamped ANT messages, written by the SoftDevice event handler and read by app_ant_process */
+static ant_record_t      m_records[APP_ANT_RECORD_QUEUE_SIZE];
+static volatile uint32_t m_records_wr;
+static volatile uint32_t m_records_rd;
+static uint32_t          m_records_dropped;
+
+NRF_SDH_ANT_OBSERVER(m_ant_record_observer, APP_ANT_RECORD_OBSERVER_PRIO, m_ant_record_evt_handler, NULL);
+
+STATIC_ASSERT(IS_POWER_OF_TWO(APP_ANT_RECORD_QUEUE_SIZE));
+
 /*! HRM profile */
 static ant_hrm_profile_t m_ant_hrm;
 
@@ -102,6 +131,12 @@ BSC_DISP_PROFILE_CONFIG_DEF(m_ant_bsc,
 /* Function definitions ----------------------------------------------- */
 int app_ant_init(void)
 {
+  // Called on every USB start, the device is re-enumerated to export the capture
+  if (nrf_sdh_is_enabled())
+  {
+    return NRF_SUCCESS;
+  }
+
   ret_code_t err_code = nrf_sdh_enable_request();
   APP_ERROR_CHECK(err_code);
 
@@ -149,7 +184,112 @@ int app_ant_init(void)
   return NRF_SUCCESS;
 }
 
+int app_ant_channel_open(uint8_t channel)
+{
+  return sd_ant_channel_open(channel);
+}
+
+int app_ant_channel_close(uint8_t channel)
+{
+  return sd_ant_channel_close(channel);
+}
+
+int app_ant_channel_id_set(uint8_t channel, uint16_t dev_num, uint8_t trans_type)
+{
+  uint16_t cur_dev_num;
+  uint8_t  dev_type;
+  uint8_t  cur_trans_type;
+
+  // Keep the device type of the profile
+  ret_code_t err_code = sd_ant_channel_id_get(channel, &cur_dev_num, &dev_type, &cur_trans_type);
+  if (err_code != NRF_SUCCESS)
+  {
+    return err_code;
+  }
+
+  return sd_ant_channel_id_set(channel, dev_num, dev_type, trans_type);
+}
+
+int app_ant_channel_period_set(uint8_t channel, uint16_t period)
+{
+  return sd_ant_channel_period_set(channel, period);
+}
+
+int app_ant_page_request(uint8_t channel, uint8_t page)
+{
+  uint8_t payload[ANT_STANDARD_DATA_PAYLOAD_SIZE];
+  ant_common_page70_data_t page70 = ANT_COMMON_PAGE_DATA_REQUEST(page);
+
+  payload[0] = ANT_COMMON_PAGE_70;
+  ant_common_page_70_encode(&payload[1], &page70);
+
+  return sd_ant_acknowledge_message_tx(channel, sizeof(payload), payload);
+}
+
+bool app_ant_process(void)
+{
+  bool sent = false;
+
+  while (m_records_rd != m_records_wr)
+  {
+    const ant_record_t* p_record = &m_records[m_records_rd & (APP_ANT_RECORD_QUEUE_SIZE - 1)];
+    uint8_t buf[6 + ANT_STANDARD_DATA_PAYLOAD_SIZE];
+    uint8_t len = 0;
+
+    len += uint16_encode(p_record->ts.frame, &buf[len]);
+    len += uint16_encode(p_record->ts.offset, &buf[len]);
+    buf[len++] = p_record->channel;
+    buf[len++] = p_record->mesg_id;
+    memcpy(&buf[len], p_record->payload, ANT_STANDARD_DATA_PAYLOAD_SIZE);
+    len += ANT_STANDARD_DATA_PAYLOAD_SIZE;
+
+    // The capture keeps every message, the live stream is then best effort
+    bool captured = (app_capture_write(buf, len) == NRF_SUCCESS);
+
+    if (!app_cmd_event_send(APP_CMD_EVT_ANT_MESSAGE, buf, len) && !captured)
+    {
+      // Retried on the next pass, the USB transfer completion wakes up the main loop
+      break;
+    }
+    m_records_rd++;
+    sent = true;
+  }
+
+  return sent;
+}
+
 /* Private function definitions --------------------------------------- */
+/**@brief Function for stamping received ANT messages with the USB frame time
+ *
+ * @details Runs in the SoftDevice event interrupt, ahead of the profile handlers, so the stamp
+ *          is taken as close to the reception as possible. The records are sent by app_ant_process.
+ */
+static void m_ant_record_evt_handler(ant_evt_t *p_ant_evt, void *p_context)
+{
+  ant_record_t* p_record;
+
+  UNUSED_PARAMETER(p_context);
+
+  if (p_ant_evt->event != EVENT_RX)
+  {
+    return;
+  }
+
+  if ((m_records_wr - m_records_rd) >= APP_ANT_RECORD_QUEUE_SIZE)
+  {
+    m_records_dropped++;
+    NRF_LOG_WARNING("ANT record queue full, %u dropped", m_records_dropped);
+    return;
+  }
+
+  p_record = &m_records[m_records_wr & (APP_ANT_RECORD_QUEUE_SIZE - 1)];
+  app_usb_timestamp_get(&p_record->ts);
+  p_record->channel = p_ant_evt->channel;
+  p_record->mesg_id = p_ant_evt->message.ANT_MESSAGE_ucMesgID;
+  memcpy(p_record->payload, p_ant_evt->message.ANT_MESSAGE_aucPayload, ANT_STANDARD_DATA_PAYLOAD_SIZE);
+  m_records_wr++;
+}
+
 /**@brief Function for handling HRM profile's events
  *
  */
@@ -159,6 +299,9 @@ static void m_ant_hrm_evt_handler(ant_hrm_profile_t *p_profile, ant_hrm_evt_t ev
   {
   case ANT_HRM_PAGE_0_UPDATED:
   {
+    UNUSED_RETURN_VALUE(app_usb_metric_write(APP_USB_METRIC_HEART_RATE, p_profile->channel_number,
+                                             p_profile->HRM_PROFILE_computed_heart_rate));
+
     sprintf(m_tx_buff, "=== HRM page 0 ===\nBeat count: %u\nHeart rate: %u\nBeat time: %u\r\n", 
     p_profile->HRM_PROFILE_beat_count, p_profile->HRM_PROFILE_computed_heart_rate, p_profile->HRM_PROFILE_beat_time);
     app_usb_send(m_tx_buff);
@@ -220,6 +363,9 @@ static void m_ant_bpwr_evt_handler(ant_bpwr_profile_t *p_profile, ant_bpwr_evt_t
 
   case ANT_BPWR_PAGE_16_UPDATED:
   {
+    UNUSED_RETURN_VALUE(app_usb_metric_write(APP_USB_METRIC_POWER, p_profile->channel_number,
+                                             p_profile->BPWR_PROFILE_instantaneous_power));
+
     sprintf(m_tx_buff, "=== BPWR page 16 ===\nPower_evt_cnt: %u\nAccumulate power: %u W\nInstantaneous: %u rpm\r\n",
             p_profile->BPWR_PROFILE_power_update_event_count, p_profile->BPWR_PROFILE_accumulated_power, 
             p_profile->BPWR_PROFILE_instantaneous_power);
@@ -344,15 +490,19 @@ static void m_ant_bsc_evt_handler(ant_bsc_profile_t *p_profile, ant_bsc_evt_t ev
 
     if (DISPLAY_TYPE == BSC_SPEED_DEVICE_TYPE)
     {
-      NRF_LOG_INFO("Computed speed value:                 %u kph",
-                   (unsigned int)m_calculate_speed(p_profile->BSC_PROFILE_rev_count,
-                                                   p_profile->BSC_PROFILE_event_time));
+      uint32_t speed = m_calculate_speed(p_profile->BSC_PROFILE_rev_count,
+                                         p_profile->BSC_PROFILE_event_time);
+
+      NRF_LOG_INFO("Computed speed value:                 %u kph", (unsigned int)speed);
+      UNUSED_RETURN_VALUE(app_usb_metric_write(APP_USB_METRIC_SPEED, p_profile->channel_number, speed));
     }
     else if (DISPLAY_TYPE == BSC_CADENCE_DEVICE_TYPE)
     {
-      NRF_LOG_INFO("Computed cadence value:               %u rpm",
-                   (unsigned int)m_calculate_cadence(p_profile->BSC_PROFILE_rev_count,
-                                                     p_profile->BSC_PROFILE_event_time));
+      uint32_t cadence = m_calculate_cadence(p_profile->BSC_PROFILE_rev_count,
+                                             p_profile->BSC_PROFILE_event_time);
+
+      NRF_LOG_INFO("Computed cadence value:               %u rpm", (unsigned int)cadence);
+      UNUSED_RETURN_VALUE(app_usb_metric_write(APP_USB_METRIC_CADENCE, p_profile->channel_number, cadence));
     }
     break;
 
@@ -366,6 +516,8 @@ static void m_ant_bsc_evt_handler(ant_bsc_profile_t *p_profile, ant_bsc_evt_t ev
 
     NRF_LOG_INFO("Computed speed value:                         %u kph", speed);
     NRF_LOG_INFO("Computed cadence value:                       %u rpms",cadence);
+    UNUSED_RETURN_VALUE(app_usb_metric_write(APP_USB_METRIC_SPEED, p_profile->channel_number, speed));
+    UNUSED_RETURN_VALUE(app_usb_metric_write(APP_USB_METRIC_CADENCE, p_profile->channel_number, cadence));
 
     sprintf(m_tx_buff, "=== BSC page 0 ===\nSpeed: %u kph\nCandence: %u rpm\r\n", speed, cadence);
     app_usb_send(m_tx_buff);
@@ -14,6 +14,9 @@
 #define __APP_ANT_H
 
 /* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+
 /* Public defines ----------------------------------------------------- */
 /* Public macros ------------------------------------------------------ */
 /* Public enumerate/structure ----------------------------------------- */
@@ -21,5 +24,64 @@
 /* Public function prototypes ----------------------------------------- */
 int app_ant_init(void);
 
+/**
+ * @brief Open the channel of one of the profiles
+ *
+ * @param[in] channel  ANT channel number
+ *
+ * @return NRF_SUCCESS or the SoftDevice error code
+ */
+int app_ant_channel_open(uint8_t channel);
+
+/**
+ * @brief Close the channel of one of the profiles
+ *
+ * @param[in] channel  ANT channel number
+ *
+ * @return NRF_SUCCESS or the SoftDevice error code
+ */
+int app_ant_channel_close(uint8_t channel);
+
+/**
+ * @brief Set the device number and transmission type to search for, applied on the next open
+ *
+ * @param[in] channel     ANT channel number
+ * @param[in] dev_num     Device number, 0 for wildcard
+ * @param[in] trans_type  Transmission type, 0 for wildcard
+ *
+ * @return NRF_SUCCESS or the SoftDevice error code
+ */
+int app_ant_channel_id_set(uint8_t channel, uint16_t dev_num, uint8_t trans_type);
+
+/**
+ * @brief Set the channel message period
+ *
+ * @param[in] channel  ANT channel number
+ * @param[in] period   Message period in 1/32768 s units
+ *
+ * @return NRF_SUCCESS or the SoftDevice error code
+ */
+int app_ant_channel_period_set(uint8_t channel, uint16_t period);
+
+/**
+ * @brief Request a data page from the sensor (common page 70)
+ *
+ * @param[in] channel  ANT channel number
+ * @param[in] page     Requested page number
+ *
+ * @return NRF_SUCCESS or the SoftDevice error code
+ */
+int app_ant_page_request(uint8_t channel, uint8_t page);
+
+/**
+ * @brief Send the received ANT messages to the host, called from the main loop
+ *
+ * @details Each message is stamped with @ref app_usb_timestamp_get on reception and sent as an
+ *          APP_CMD_EVT_ANT_MESSAGE event frame.
+ *
+ * @return true if any message was sent
+ */
+bool app_ant_process(void);
+
 #endif // __APP_ANT_H
 /* End of file -------------------------------------------------------- */
@@ -0,0 +1,268 @@
+/**
+* @file       app_capture.c
+* @copyright  Copyright (C) 2020 Fiot Co., Ltd. All rights reserved.
+* @license    This project is released under the Fiot License.
+* @version    1.0.0
+* @date       2021-07-08
+* @author     Hieu Doan
+* @brief      Capture of ANT messages to a FAT volume, exported over USB mass storage
+*/
+
+/* Includes ----------------------------------------------------------- */
+#include "app_capture.h"
+#include "app_util.h"
+#include "nrf_error.h"
+#include "nrf_log.h"
+#include "nrf_block_dev_ram.h"
+#include "diskio_blkdev.h"
+#include "ff.h"
+#include "app_usbd_msc.h"
+#include "app_usb.h"
+
+/* Private defines ---------------------------------------------------- */
+#define CAPTURE_BLOCK_SIZE      512
+#define CAPTURE_BLOCK_CNT       128    /**< 64 kB, about 3400 messages */
+#define CAPTURE_DRIVE           0
+
+/*! Next free interface and endpoint after the classes enabled in app_usb.h */
+#define MSC_INTERFACE           APP_USB_MSC_INTERFACE
+#define MSC_ENDPOINT_LIST()     (NRF_DRV_USBD_EPIN(APP_USB_MSC_EP), NRF_DRV_USBD_EPOUT(APP_USB_MSC_EP))
+/*! Size of each of the two MSC buffers, one is read from the volume while the other is sent */
+#define MSC_WORKBUFFER_SIZE     (4 * CAPTURE_BLOCK_SIZE)
+
+/* Private macros ----------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+typedef enum
+{
+  CAPTURE_STATE_IDLE,       /**< Volume mounted, file closed */
+  CAPTURE_STATE_RECORDING,  /**< Volume mounted, file open for appending */
+  CAPTURE_STATE_EXPORTED,   /**< Volume owned by the mass storage interface */
+  CAPTURE_STATE_RESUMING    /**< Mass storage interface being removed, recording starts next */
+}
+capture_state_t;
+
+/* Public variables --------------------------------------------------- */
+/* Private function prototypes ---------------------------------------- */
+static void m_msc_user_ev_handler(app_usbd_class_inst_t const *p_inst,
+                                  app_usbd_msc_user_event_t event);
+static int m_volume_mount(void);
+static void m_volume_unmount(void);
+static int m_file_open(void);
+static void m_file_close(void);
+
+/* Private variables -------------------------------------------------- */
+static uint8_t m_block_dev_ram_buff[CAPTURE_BLOCK_CNT * CAPTURE_BLOCK_SIZE];
+
+/** @brief RAM block device, shared by FatFS and the mass storage interface, never both at once */
+NRF_BLOCK_DEV_RAM_DEFINE(m_block_dev_ram,
+                         NRF_BLOCK_DEV_RAM_CONFIG(CAPTURE_BLOCK_SIZE,
+                                                  m_block_dev_ram_buff,
+                                                  sizeof(m_block_dev_ram_buff)),
+                         NFR_BLOCK_DEV_INFO_CONFIG("Fiot", "ANT capture", "1.00"));
+
+#define BLOCKDEV_LIST()         (NRF_BLOCKDEV_BASE_ADDR(m_block_dev_ram, block_dev))
+
+/** @brief Mass storage class instance, only attached while the volume is exported */
+APP_USBD_MSC_GLOBAL_DEF(m_app_msc,
+                        MSC_INTERFACE,
+                        m_msc_user_ev_handler,
+                        MSC_ENDPOINT_LIST(),
+                        BLOCKDEV_LIST(),
+                        MSC_WORKBUFFER_SIZE);
+
+static diskio_blkdev_t m_drives[] =
+{
+  DISKIO_BLOCKDEV_CONFIG(NRF_BLOCKDEV_BASE_ADDR(m_block_dev_ram, block_dev), NULL)
+};
+
+static FATFS           m_filesystem;
+static FIL             m_file;
+static capture_state_t m_state = CAPTURE_STATE_IDLE;
+
+/* Function definitions ----------------------------------------------- */
+int app_capture_init(void)
+{
+  diskio_blockdev_register(m_drives, ARRAY_SIZE(m_drives));
+
+  return m_volume_mount();
+}
+
+int app_capture_start(void)
+{
+  int err_code;
+
+  switch (m_state)
+  {
+  case CAPTURE_STATE_IDLE:
+    err_code = m_file_open();
+    if (err_code == NRF_SUCCESS)
+    {
+      m_state = CAPTURE_STATE_RECORDING;
+    }
+    return err_code;
+
+  case CAPTURE_STATE_EXPORTED:
+    err_code = app_usb_class_detach(app_usbd_msc_class_inst_get(&m_app_msc));
+    if (err_code == NRF_SUCCESS)
+    {
+      m_state = CAPTURE_STATE_RESUMING;
+    }
+    return err_code;
+
+  default:
+    return NRF_SUCCESS;
+  }
+}
+
+int app_capture_stop(void)
+{
+  switch (m_state)
+  {
+  case CAPTURE_STATE_RECORDING:
+    m_file_close();
+    m_state = CAPTURE_STATE_IDLE;
+    return NRF_SUCCESS;
+
+  case CAPTURE_STATE_IDLE:
+    return NRF_SUCCESS;
+
+  default:
+    return NRF_ERROR_INVALID_STATE;
+  }
+}
+
+int app_capture_export(void)
+{
+  int err_code;
+
+  if ((m_state == CAPTURE_STATE_EXPORTED) || (m_state == CAPTURE_STATE_RESUMING))
+  {
+    return (m_state == CAPTURE_STATE_EXPORTED) ? NRF_SUCCESS : NRF_ERROR_BUSY;
+  }
+
+  err_code = app_usb_class_attach(app_usbd_msc_class_inst_get(&m_app_msc));
+  if (err_code != NRF_SUCCESS)
+  {
+    return err_code;
+  }
+
+  /* The host must see a consistent volume, nothing is written from here on */
+  if (m_state == CAPTURE_STATE_RECORDING)
+  {
+    m_file_close();
+  }
+  m_volume_unmount();
+  m_state = CAPTURE_STATE_EXPORTED;
+
+  NRF_LOG_INFO("Capture volume exported");
+  return NRF_SUCCESS;
+}
+
+int app_capture_write(const void* p_data, size_t size)
+{
+  FRESULT ff_result;
+  UINT    written;
+
+  if (m_state != CAPTURE_STATE_RECORDING)
+  {
+    return NRF_ERROR_INVALID_STATE;
+  }
+
+  ff_result = f_write(&m_file, p_data, size, &written);
+  if ((ff_result != FR_OK) || (written != size))
+  {
+    NRF_LOG_WARNING("Capture stopped, volume full (%u)", ff_result);
+    m_file_close();
+    m_state = CAPTURE_STATE_IDLE;
+    return NRF_ERROR_NO_MEM;
+  }
+
+  return NRF_SUCCESS;
+}
+
+void app_capture_process(void)
+{
+  if ((m_state != CAPTURE_STATE_RESUMING) || app_usb_class_change_pending())
+  {
+    return;
+  }
+
+  /* The mass storage interface is gone, the volume belongs to FatFS again */
+  m_state = CAPTURE_STATE_IDLE;
+  if (m_volume_mount() == NRF_SUCCESS)
+  {
+    UNUSED_RETURN_VALUE(app_capture_start());
+  }
+}
+
+void app_capture_msc_stats_get(app_usbd_msc_stats_t* p_stats)
+{
+  app_usbd_msc_stats_get(&m_app_msc, p_stats);
+}
+
+/* Private function definitions --------------------------------------- */
+static void m_msc_user_ev_handler(app_usbd_class_inst_t const *p_inst,
+                                  app_usbd_msc_user_event_t event)
+{
+  UNUSED_PARAMETER(p_inst);
+  UNUSED_PARAMETER(event);
+}
+
+static int m_volume_mount(void)
+{
+  static uint8_t mkfs_buf[CAPTURE_BLOCK_SIZE];
+  FRESULT ff_result;
+
+  if (disk_initialize(CAPTURE_DRIVE) & STA_NOINIT)
+  {
+    NRF_LOG_ERROR("Capture disk initialization failed");
+    return NRF_ERROR_INTERNAL;
+  }
+
+  ff_result = f_mount(&m_filesystem, "", 1);
+  if (ff_result == FR_NO_FILESYSTEM)
+  {
+    NRF_LOG_INFO("Creating the capture volume");
+    /* No partition table, it would not leave enough sectors for FAT on this volume */
+    ff_result = f_mkfs("", FM_FAT | FM_SFD, 0, mkfs_buf, sizeof(mkfs_buf));
+    if (ff_result == FR_OK)
+    {
+      ff_result = f_mount(&m_filesystem, "", 1);
+    }
+  }
+
+  if (ff_result != FR_OK)
+  {
+    NRF_LOG_ERROR("Capture volume mount failed (%u)", ff_result);
+    return NRF_ERROR_INTERNAL;
+  }
+
+  return NRF_SUCCESS;
+}
+
+static void m_volume_unmount(void)
+{
+  UNUSED_RETURN_VALUE(f_mount(NULL, "", 0));
+  UNUSED_RETURN_VALUE(disk_uninitialize(CAPTURE_DRIVE));
+}
+
+static int m_file_open(void)
+{
+  FRESULT ff_result = f_open(&m_file, APP_CAPTURE_FILE_NAME, FA_WRITE | FA_OPEN_APPEND);
+
+  if (ff_result != FR_OK)
+  {
+    NRF_LOG_ERROR("Capture file open failed (%u)", ff_result);
+    return NRF_ERROR_INTERNAL;
+  }
+
+  NRF_LOG_INFO("Capture started at %u bytes", f_size(&m_file));
+  return NRF_SUCCESS;
+}
+
+static void m_file_close(void)
+{
+  UNUSED_RETURN_VALUE(f_close(&m_file));
+  NRF_LOG_INFO("Capture stopped");
+}
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,89 @@
+/**
+* @file       app_capture.h
+* @copyright  Copyright (C) 2020 Fiot Co., Ltd. All rights reserved.
+* @license    This project is released under the Fiot License.
+* @version    1.0.0
+* @date       2021-07-08
+* @author     Hieu Doan
+*
+* @brief      Capture of ANT messages to a FAT volume, exported over USB mass storage
+*
+* @details    While recording, the received ANT messages are appended to APP_CAPTURE_FILE_NAME
+*             in the same format as the APP_CMD_EVT_ANT_MESSAGE event data, 14 bytes each.
+*             On export the volume is unmounted and the device re-enumerates with a mass
+*             storage interface, the host then copies the file with the OS file manager.
+*/
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __APP_CAPTURE_H
+#define __APP_CAPTURE_H
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "app_usbd_msc.h"
+
+/* Public defines ----------------------------------------------------- */
+#define APP_CAPTURE_FILE_NAME     "ANT.BIN"  /**< Capture file in the root directory of the volume */
+
+/* Public macros ------------------------------------------------------ */
+/* Public enumerate/structure ----------------------------------------- */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief Mount the capture volume, formatting it if needed
+ *
+ * @return NRF_SUCCESS or NRF_ERROR_INTERNAL if the volume cannot be mounted
+ */
+int app_capture_init(void);
+
+/**
+ * @brief Start appending the received ANT messages to the capture file
+ *
+ * @details When the volume is exported, the mass storage interface is removed first and the
+ *          recording starts from @ref app_capture_process once the device is re-enumerated.
+ *
+ * @return NRF_SUCCESS or NRF_ERROR_INTERNAL if the file cannot be opened
+ */
+int app_capture_start(void);
+
+/**
+ * @brief Stop recording and close the capture file
+ *
+ * @return NRF_SUCCESS or NRF_ERROR_INVALID_STATE if the volume is exported
+ */
+int app_capture_stop(void);
+
+/**
+ * @brief Stop recording, unmount the volume and export it over USB mass storage
+ *
+ * @return NRF_SUCCESS or NRF_ERROR_BUSY if a USB interface change is in progress
+ */
+int app_capture_export(void);
+
+/**
+ * @brief Append data to the capture file
+ *
+ * @param[in] p_data  Data
+ * @param[in] size    Number of bytes
+ *
+ * @return NRF_SUCCESS, NRF_ERROR_INVALID_STATE if not recording or NRF_ERROR_NO_MEM if the
+ *         volume is full, the recording is stopped then
+ */
+int app_capture_write(const void* p_data, size_t size);
+
+/**
+ * @brief Resume recording after the export is ended, called from the main loop
+ */
+void app_capture_process(void);
+
+/**
+ * @brief Get the mass storage data stage statistics, kept across exports
+ *
+ * @param[out] p_stats  Statistics
+ */
+void app_capture_msc_stats_get(app_usbd_msc_stats_t* p_stats);
+
+#endif // __APP_CAPTURE_H
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,452 @@
+/**
+* @file       app_cmd.c
+* @copyright  Copyright (C) 2020 Fiot Co., Ltd. All rights reserved.
+* @license    This project is released under the Fiot License.
+* @version    1.0.0
+* @date       2021-07-08
+* @author     Hieu Doan
+* @brief      Host command processor
+*/
+
+/* Includes ----------------------------------------------------------- */
+#include "app_cmd.h"
+#include "app_util.h"
+#include "nrf_error.h"
+#include "nrf_log.h"
+#include "app_ant.h"
+#include "app_usb.h"
+#include "app_capture.h"
+
+/* Private defines ---------------------------------------------------- */
+#define APP_CMD_FRAME_OVERHEAD    (4)    /**< SYNC, LEN, CMD and CHK */
+
+/* Private macros ----------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+typedef enum
+{
+  PARSER_STATE_SYNC,
+  PARSER_STATE_LEN,
+  PARSER_STATE_CMD,
+  PARSER_STATE_DATA,
+  PARSER_STATE_CHK
+}
+parser_state_t;
+
+typedef struct
+{
+  uint8_t port;
+  uint8_t cmd;
+  uint8_t len;
+  uint8_t data[APP_CMD_DATA_MAX];
+}
+cmd_frame_t;
+
+/*! Frame parser, one per USB interface so that bytes from both are never mixed */
+typedef struct
+{
+  parser_state_t state;
+  uint8_t        chk;
+  uint8_t        data_cnt;
+  cmd_frame_t    frame;
+}
+cmd_parser_t;
+
+/*! Responses and events must stay valid until their USB transfers are done. Frames are built
+    at wr, handed to USB at sent and are free again once USB has sent them */
+typedef struct
+{
+  uint8_t  frame[APP_CMD_TX_FRAME_CNT][APP_CMD_DATA_MAX + APP_CMD_FRAME_OVERHEAD];
+  uint8_t  size[APP_CMD_TX_FRAME_CNT];
+  uint32_t wr;
+  uint32_t sent;
+}
+cmd_tx_t;
+
+/* Public variables --------------------------------------------------- */
+/* Private function prototypes ---------------------------------------- */
+static void m_cmd_execute(const cmd_frame_t* p_frame);
+static void m_cmd_respond(const cmd_frame_t* p_frame, app_cmd_status_t status,
+                          const uint8_t* p_data, uint8_t len);
+static void m_cmd_respond_err(const cmd_frame_t* p_frame, int err_code);
+static void m_frame_send(app_usb_port_t port, uint8_t id, const uint8_t* p_data, uint8_t len);
+static bool m_frame_free(app_usb_port_t port);
+static void m_frame_flush(app_usb_port_t port);
+
+/* Private variables -------------------------------------------------- */
+static cmd_parser_t m_parser[APP_USB_PORT_CNT];
+
+/*! Frames waiting for execution, written by app_cmd_rx and read by app_cmd_process */
+static cmd_frame_t       m_queue[APP_CMD_QUEUE_SIZE];
+static volatile uint32_t m_queue_wr;
+static volatile uint32_t m_queue_rd;
+
+static app_cmd_stats_t m_stats;
+
+/*! Frames being sent, per USB interface */
+static cmd_tx_t m_tx[APP_USB_PORT_CNT];
+
+STATIC_ASSERT(IS_POWER_OF_TWO(APP_CMD_QUEUE_SIZE));
+STATIC_ASSERT(IS_POWER_OF_TWO(APP_CMD_TX_FRAME_CNT));
+STATIC_ASSERT(sizeof(app_cmd_stats_t) + 1 <= APP_CMD_DATA_MAX);
+STATIC_ASSERT(sizeof(app_usbd_msc_stats_t) + 1 <= APP_CMD_DATA_MAX);
+
+/* Function definitions ----------------------------------------------- */
+void app_cmd_rx(app_usb_port_t port, const uint8_t* p_data, size_t size)
+{
+  cmd_parser_t* p_parser;
+
+  ASSERT(port < APP_USB_PORT_CNT);
+  p_parser = &m_parser[port];
+
+  m_stats.rx_bytes += size;
+
+  for (size_t i = 0; i < size; i++)
+  {
+    uint8_t byte = p_data[i];
+
+    switch (p_parser->state)
+    {
+    case PARSER_STATE_SYNC:
+      if (byte == APP_CMD_SYNC)
+      {
+        p_parser->chk   = byte;
+        p_parser->state = PARSER_STATE_LEN;
+      }
+      break;
+
+    case PARSER_STATE_LEN:
+      if (byte > APP_CMD_DATA_MAX)
+      {
+        m_stats.len_errors++;
+        p_parser->state = PARSER_STATE_SYNC;
+        break;
+      }
+      p_parser->frame.len = byte;
+      p_parser->chk      ^= byte;
+      p_parser->state     = PARSER_STATE_CMD;
+      break;
+
+    case PARSER_STATE_CMD:
+      p_parser->frame.cmd = byte;
+      p_parser->chk      ^= byte;
+      p_parser->data_cnt  = 0;
+      p_parser->state     = (p_parser->frame.len != 0) ? PARSER_STATE_DATA : PARSER_STATE_CHK;
+      break;
+
+    case PARSER_STATE_DATA:
+      p_parser->frame.data[p_parser->data_cnt++] = byte;
+      p_parser->chk ^= byte;
+      if (p_parser->data_cnt == p_parser->frame.len)
+      {
+        p_parser->state = PARSER_STATE_CHK;
+      }
+      break;
+
+    case PARSER_STATE_CHK:
+      p_parser->state = PARSER_STATE_SYNC;
+      if (byte != p_parser->chk)
+      {
+        m_stats.chk_errors++;
+        break;
+      }
+
+      m_stats.frames++;
+      if ((m_queue_wr - m_queue_rd) >= APP_CMD_QUEUE_SIZE)
+      {
+        m_stats.overflows++;
+        break;
+      }
+      /* The response goes back to the interface the command came from */
+      p_parser->frame.port = (uint8_t)port;
+      m_queue[m_queue_wr & (APP_CMD_QUEUE_SIZE - 1)] = p_parser->frame;
+      m_queue_wr++;
+      break;
+
+    default:
+      p_parser->state = PARSER_STATE_SYNC;
+      break;
+    }
+  }
+}
+
+bool app_cmd_process(void)
+{
+  bool executed = false;
+
+  /* Frames the USB interfaces could not take yet */
+  for (uint8_t port = 0; port < APP_USB_PORT_CNT; port++)
+  {
+    m_frame_flush((app_usb_port_t)port);
+  }
+
+  /* Each pending response holds one of the frames of its interface, commands run in order */
+  while (m_queue_rd != m_queue_wr)
+  {
+    const cmd_frame_t* p_frame = &m_queue[m_queue_rd & (APP_CMD_QUEUE_SIZE - 1)];
+
+    if (!m_frame_free((app_usb_port_t)p_frame->port))
+    {
+      break;
+    }
+    m_cmd_execute(p_frame);
+    m_queue_rd++;
+    m_stats.executed++;
+    executed = true;
+  }
+
+  return executed;
+}
+
+bool app_cmd_event_send(app_cmd_evt_id_t evt, const uint8_t* p_data, uint8_t len)
+{
+  ASSERT(len <= APP_CMD_DATA_MAX);
+
+  if (!m_frame_free(APP_USB_PORT_DEFAULT))
+  {
+    return false;
+  }
+  m_frame_send(APP_USB_PORT_DEFAULT, (uint8_t)evt, p_data, len);
+  return true;
+}
+
+void app_cmd_stats_get(app_cmd_stats_t* p_stats)
+{
+  *p_stats = m_stats;
+}
+
+/* Private function definitions --------------------------------------- */
+static void m_cmd_execute(const cmd_frame_t* p_frame)
+{
+  const uint8_t* p_data = p_frame->data;
+  int err_code;
+
+  NRF_LOG_DEBUG("Command 0x%02x, length %u", p_frame->cmd, p_frame->len);
+
+  switch (p_frame->cmd)
+  {
+  case APP_CMD_CHANNEL_OPEN:
+    if (p_frame->len != 1)
+    {
+      break;
+    }
+    err_code = app_ant_channel_open(p_data[0]);
+    m_cmd_respond_err(p_frame, err_code);
+    return;
+
+  case APP_CMD_CHANNEL_CLOSE:
+    if (p_frame->len != 1)
+    {
+      break;
+    }
+    err_code = app_ant_channel_close(p_data[0]);
+    m_cmd_respond_err(p_frame, err_code);
+    return;
+
+  case APP_CMD_DEVICE_ID_SET:
+    if (p_frame->len != 4)
+    {
+      break;
+    }
+    err_code = app_ant_channel_id_set(p_data[0], uint16_decode(&p_data[1]), p_data[3]);
+    m_cmd_respond_err(p_frame, err_code);
+    return;
+
+  case APP_CMD_PERIOD_SET:
+    if (p_frame->len != 3)
+    {
+      break;
+    }
+    err_code = app_ant_channel_period_set(p_data[0], uint16_decode(&p_data[1]));
+    m_cmd_respond_err(p_frame, err_code);
+    return;
+
+  case APP_CMD_PAGE_REQUEST:
+    if (p_frame->len != 2)
+    {
+      break;
+    }
+    err_code = app_ant_page_request(p_data[0], p_data[1]);
+    m_cmd_respond_err(p_frame, err_code);
+    return;
+
+  case APP_CMD_STATS_GET:
+  {
+    uint8_t buf[sizeof(app_cmd_stats_t)];
+    uint8_t len = 0;
+
+    if (p_frame->len != 0)
+    {
+      break;
+    }
+    len += uint32_encode(m_stats.rx_bytes, &buf[len]);
+    len += uint32_encode(m_stats.frames, &buf[len]);
+    len += uint32_encode(m_stats.chk_errors, &buf[len]);
+    len += uint32_encode(m_stats.len_errors, &buf[len]);
+    len += uint32_encode(m_stats.overflows, &buf[len]);
+    len += uint32_encode(m_stats.executed, &buf[len]);
+    len += uint32_encode(m_stats.tx_dropped, &buf[len]);
+    m_cmd_respond(p_frame, APP_CMD_STATUS_OK, buf, len);
+    return;
+  }
+
+  case APP_CMD_USB_LATENCY_GET:
+  {
+    app_usb_latency_t latency;
+    uint8_t buf[4 * sizeof(uint32_t)];
+    uint8_t len = 0;
+
+    if (p_frame->len != 0)
+    {
+      break;
+    }
+    app_usb_latency_get(&latency);
+    len += uint32_encode(latency.samples, &buf[len]);
+    len += uint32_encode(latency.last, &buf[len]);
+    len += uint32_encode(latency.max, &buf[len]);
+    len += uint32_encode((latency.samples != 0) ? (uint32_t)(latency.total / latency.samples) : 0,
+                         &buf[len]);
+    m_cmd_respond(p_frame, APP_CMD_STATUS_OK, buf, len);
+    return;
+  }
+
+  case APP_CMD_CAPTURE_START:
+    if (p_frame->len != 0)
+    {
+      break;
+    }
+    err_code = app_capture_start();
+    m_cmd_respond_err(p_frame, err_code);
+    return;
+
+  case APP_CMD_CAPTURE_STOP:
+    if (p_frame->len != 0)
+    {
+      break;
+    }
+    err_code = app_capture_stop();
+    m_cmd_respond_err(p_frame, err_code);
+    return;
+
+  case APP_CMD_CAPTURE_EXPORT:
+    if (p_frame->len != 0)
+    {
+      break;
+    }
+    err_code = app_capture_export();
+    m_cmd_respond_err(p_frame, err_code);
+    return;
+
+  case APP_CMD_MSC_STATS_GET:
+  {
+    app_usbd_msc_stats_t stats;
+    uint8_t buf[sizeof(app_usbd_msc_stats_t)];
+    uint8_t len = 0;
+
+    if (p_frame->len != 0)
+    {
+      break;
+    }
+    app_capture_msc_stats_get(&stats);
+    len += uint32_encode(stats.bytes_in, &buf[len]);
+    len += uint32_encode(stats.bytes_out, &buf[len]);
+    len += uint32_encode(stats.blk_reads, &buf[len]);
+    len += uint32_encode(stats.blk_writes, &buf[len]);
+    len += uint32_encode(stats.overlaps, &buf[len]);
+    len += uint32_encode(stats.usb_waits, &buf[len]);
+    len += uint32_encode(stats.blk_waits, &buf[len]);
+    m_cmd_respond(p_frame, APP_CMD_STATUS_OK, buf, len);
+    return;
+  }
+
+  default:
+    m_cmd_respond(p_frame, APP_CMD_STATUS_UNKNOWN, NULL, 0);
+    return;
+  }
+
+  m_cmd_respond(p_frame, APP_CMD_STATUS_INVALID_LEN, NULL, 0);
+}
+
+static void m_cmd_respond_err(const cmd_frame_t* p_frame, int err_code)
+{
+  uint8_t buf[sizeof(uint32_t)];
+
+  if (err_code == NRF_SUCCESS)
+  {
+    m_cmd_respond(p_frame, APP_CMD_STATUS_OK, NULL, 0);
+  }
+  else
+  {
+    NRF_LOG_WARNING("Command 0x%02x failed: 0x%x", p_frame->cmd, err_code);
+    m_cmd_respond(p_frame, APP_CMD_STATUS_FAILED, buf, uint32_encode((uint32_t)err_code, buf));
+  }
+}
+
+static void m_cmd_respond(const cmd_frame_t* p_frame, app_cmd_status_t status,
+                          const uint8_t* p_data, uint8_t len)
+{
+  uint8_t buf[APP_CMD_DATA_MAX];
+
+  buf[0] = (uint8_t)status;
+  for (uint8_t i = 0; i < len; i++)
+  {
+    buf[i + 1] = p_data[i];
+  }
+  m_frame_send((app_usb_port_t)p_frame->port, p_frame->cmd | APP_CMD_RESPONSE, buf, len + 1);
+}
+
+static void m_frame_send(app_usb_port_t port, uint8_t id, const uint8_t* p_data, uint8_t len)
+{
+  cmd_tx_t* p_tx    = &m_tx[port];
+  uint32_t  idx     = p_tx->wr & (APP_CMD_TX_FRAME_CNT - 1);
+  uint8_t*  p_frame = p_tx->frame[idx];
+  uint8_t  size    = 0;
+  uint8_t  chk     = 0;
+
+  p_frame[size++] = APP_CMD_SYNC;
+  p_frame[size++] = len;
+  p_frame[size++] = id;
+  for (uint8_t i = 0; i < len; i++)
+  {
+    p_frame[size++] = p_data[i];
+  }
+  for (uint8_t i = 0; i < size; i++)
+  {
+    chk ^= p_frame[i];
+  }
+  p_frame[size++] = chk;
+
+  p_tx->size[idx] = size;
+  p_tx->wr++;
+  m_frame_flush(port);
+}
+
+static bool m_frame_free(app_usb_port_t port)
+{
+  /* Frames not handed to USB yet and the ones being sent */
+  return ((m_tx[port].wr - m_tx[port].sent) + app_usb_tx_pending(port)) < APP_CMD_TX_FRAME_CNT;
+}
+
+static void m_frame_flush(app_usb_port_t port)
+{
+  cmd_tx_t* p_tx = &m_tx[port];
+  int       err_code;
+
+  while (p_tx->sent != p_tx->wr)
+  {
+    uint32_t idx = p_tx->sent & (APP_CMD_TX_FRAME_CNT - 1);
+
+    err_code = app_usb_write(port, p_tx->frame[idx], p_tx->size[idx]);
+    if ((err_code == NRF_ERROR_BUSY) || (err_code == NRF_ERROR_NO_MEM))
+    {
+      /* Retried by app_cmd_process, the transfer completion wakes up the main loop */
+      break;
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+      /* No host on the interface, the frame is dropped */
+      m_stats.tx_dropped++;
+    }
+    p_tx->sent++;
+  }
+}
+/* End of file -------------------------------------------------------- */
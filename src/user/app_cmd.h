@@ -0,0 +1,144 @@
+/**
+* @file       app_cmd.h
+* @copyright  Copyright (C) 2020 Fiot Co., Ltd. All rights reserved.
+* @license    This project is released under the Fiot License.
+* @version    1.0.0
+* @date       2021-07-08
+* @author     Hieu Doan
+*
+* @brief      Host command processor
+*
+* @details    Commands are received from the host over USB in frames:
+*
+*             | SYNC (0xA4) | LEN | CMD | DATA (LEN bytes) | CHK |
+*
+*             CHK is the XOR of all the preceding bytes of the frame, as in the ANT serial
+*             protocol. Each command is answered with a frame with CMD set to the command
+*             ID | APP_CMD_RESPONSE and DATA starting with an @ref app_cmd_status_t byte.
+*
+*             Frames are collected by @ref app_cmd_rx and executed by @ref app_cmd_process
+*             in the main loop. CDC ACM and the vendor-specific interface each have their own
+*             parser, the response is sent on the interface the command came from.
+*
+*             The device also sends unsolicited event frames in the same format, with CMD set
+*             to an @ref app_cmd_evt_id_t, see @ref app_cmd_event_send. Events go to
+*             APP_USB_PORT_DEFAULT.
+*/
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __APP_CMD_H
+#define __APP_CMD_H
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "app_usb.h"
+
+/* Public defines ----------------------------------------------------- */
+#define APP_CMD_SYNC              (0xA4) /**< First byte of each frame */
+#define APP_CMD_RESPONSE          (0x80) /**< Flag set in the command ID of responses */
+#define APP_CMD_DATA_MAX          (32)   /**< Maximum length of the frame data */
+#define APP_CMD_QUEUE_SIZE        (4)    /**< Number of frames waiting for execution, power of 2 */
+#define APP_CMD_TX_FRAME_CNT      (8)    /**< Number of frames being sent to the host per interface, power of 2 */
+
+/* Public macros ------------------------------------------------------ */
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Command IDs
+ */
+typedef enum
+{
+  APP_CMD_CHANNEL_OPEN    = 0x01, /**< DATA: channel */
+  APP_CMD_CHANNEL_CLOSE   = 0x02, /**< DATA: channel */
+  APP_CMD_DEVICE_ID_SET   = 0x03, /**< DATA: channel, device number (LE16), transmission type */
+  APP_CMD_PERIOD_SET      = 0x04, /**< DATA: channel, period in 1/32768 s (LE16) */
+  APP_CMD_PAGE_REQUEST    = 0x05, /**< DATA: channel, page number */
+  APP_CMD_STATS_GET       = 0x06, /**< No DATA, response holds @ref app_cmd_stats_t (LE32 fields) */
+  APP_CMD_USB_LATENCY_GET = 0x07, /**< No DATA, response holds the USB event latency samples, last,
+                                        max and average in CPU cycles (LE32 fields) */
+  APP_CMD_CAPTURE_START   = 0x08, /**< No DATA, append the ANT messages to the capture file */
+  APP_CMD_CAPTURE_STOP    = 0x09, /**< No DATA, close the capture file */
+  APP_CMD_CAPTURE_EXPORT  = 0x0A, /**< No DATA, re-enumerate with the capture volume as mass storage */
+  APP_CMD_MSC_STATS_GET   = 0x0B  /**< No DATA, response holds the mass storage counters, bytes in,
+                                        bytes out, block reads, block writes, overlaps, USB waits
+                                        and block device waits (LE32 fields) */
+}
+app_cmd_id_t;
+
+/**
+ * @brief Event IDs, sent by the device without a request
+ */
+typedef enum
+{
+  APP_CMD_EVT_ANT_MESSAGE = 0x40  /**< DATA: USB frame (LE16), offset into the frame in us
+                                        (LE16, 0xFFFF if unknown), channel, message ID, 8 byte
+                                        payload */
+}
+app_cmd_evt_id_t;
+
+/**
+ * @brief Status returned in the first DATA byte of the response
+ */
+typedef enum
+{
+  APP_CMD_STATUS_OK          = 0x00, /**< Command executed */
+  APP_CMD_STATUS_UNKNOWN     = 0x01, /**< Unknown command ID */
+  APP_CMD_STATUS_INVALID_LEN = 0x02, /**< Wrong DATA length for the command */
+  APP_CMD_STATUS_FAILED      = 0x03  /**< Command failed, followed by the error code (LE32) */
+}
+app_cmd_status_t;
+
+/**
+ * @brief Command processor statistics
+ */
+typedef struct
+{
+  uint32_t rx_bytes;    /**< Bytes received from the host */
+  uint32_t frames;      /**< Valid frames received */
+  uint32_t chk_errors;  /**< Frames dropped due to wrong checksum */
+  uint32_t len_errors;  /**< Frames dropped due to LEN above APP_CMD_DATA_MAX */
+  uint32_t overflows;   /**< Frames dropped because the command queue was full */
+  uint32_t executed;    /**< Commands executed */
+  uint32_t tx_dropped;  /**< Responses and events dropped because no host was listening */
+}
+app_cmd_stats_t;
+
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief Feed data received from the host into the frame parser of its interface
+ *
+ * @param[in] port    Interface the data was received on
+ * @param[in] p_data  Received data
+ * @param[in] size    Number of received bytes
+ */
+void app_cmd_rx(app_usb_port_t port, const uint8_t* p_data, size_t size);
+
+/**
+ * @brief Execute the received commands, called from the main loop
+ *
+ * @return true if any command was executed
+ */
+bool app_cmd_process(void);
+
+/**
+ * @brief Send an event frame to the host, called from the main loop
+ *
+ * @param[in] evt     Event ID
+ * @param[in] p_data  Event data, copied into the frame
+ * @param[in] len     Length of the event data, up to APP_CMD_DATA_MAX
+ *
+ * @return false if all the frames are still being sent, try again later
+ */
+bool app_cmd_event_send(app_cmd_evt_id_t evt, const uint8_t* p_data, uint8_t len);
+
+/**
+ * @brief Get the command processor statistics
+ *
+ * @param[out] p_stats  Statistics
+ */
+void app_cmd_stats_get(app_cmd_stats_t* p_stats);
+
+#endif // __APP_CMD_H
+/* End of file -------------------------------------------------------- */
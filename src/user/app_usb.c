@@ -9,6 +9,7 @@
 */
 
 /* Includes ----------------------------------------------------------- */
+#include <string.h>
 #include "app_usb.h"
 #include "app_error.h"
 #include "app_util.h"
@@ -16,8 +17,13 @@
 #include "app_usbd.h"
 #include "app_usbd_string_desc.h"
 #include "app_usbd_serial_num.h"
+#include "app_util_platform.h"
+#include "nrf_drv_power.h"
+#include "nrf_drv_ppi.h"
+#include "nrf_timer.h"
 #include "nrf_log.h"
 #include "app_ant.h"
+#include "app_cmd.h"
 
 /* Private defines ---------------------------------------------------- */
 #define CDC_ACM_COMM_INTERFACE  0
@@ -27,25 +33,80 @@
 #define CDC_ACM_DATA_EPIN       NRF_DRV_USBD_EPIN1
 #define CDC_ACM_DATA_EPOUT      NRF_DRV_USBD_EPOUT1
 
+#define VENDOR_INTERFACE        APP_USB_VENDOR_INTERFACE
+#define VENDOR_EPIN             NRF_DRV_USBD_EPIN(APP_USB_VENDOR_EP)
+#define VENDOR_EPOUT            NRF_DRV_USBD_EPOUT(APP_USB_VENDOR_EP)
+
+/*! bInterval is left at APP_USBD_HID_GENERIC_DEFAULT_INTERVAL, 1 ms */
+#define HID_INTERFACE           APP_USB_HID_INTERFACE
+#define HID_EPIN                NRF_DRV_USBD_EPIN(APP_USB_HID_EP)
+#define HID_ENDPOINT_LIST()     (HID_EPIN)
+#define HID_REPORT_IN_QUEUE     1
+#define HID_METRIC_SIZE         8
+#define HID_METRIC_CNT          ((APP_USB_HID_REPORT_SIZE - 1) / HID_METRIC_SIZE)
+
 #define TX_BUFFER               256
 
+#define RX_BUFFER               NRF_DRV_USBD_EPSIZE
+
+/*! CDC ACM packets are received into the ring and parsed in place, the host waits when it is full */
+#define RX_RING_SIZE            (4 * NRF_DRV_USBD_EPSIZE)
+
 /* Private macros ----------------------------------------------------- */
 /* Private enumerate/structure ---------------------------------------- */
+typedef enum
+{
+  CLASS_CHANGE_NONE,
+  CLASS_CHANGE_ATTACH,
+  CLASS_CHANGE_DETACH
+}
+class_change_t;
+
 /* Public variables --------------------------------------------------- */
 /* Private function prototypes ---------------------------------------- */
+#if APP_USBD_CONFIG_EVENT_QUEUE_ENABLE
+static void m_usbd_isr_handler(app_usbd_internal_evt_t const * const p_event, bool queued);
+#else
+static void m_usbd_event_handler(app_usbd_internal_evt_t const * const p_event);
+#endif
+
+static void m_latency_start(app_usbd_internal_evt_t const * const p_event);
+static void m_latency_stop(void);
+
 static void m_cdc_acm_user_ev_handler(app_usbd_class_inst_t const *p_inst,
                                     app_usbd_cdc_acm_user_event_t event);
 
 static void m_usbd_user_ev_handler(app_usbd_event_type_t event);
 
+#if NRF_MODULE_ENABLED(APP_USBD_VENDOR)
+static void m_vendor_user_ev_handler(app_usbd_class_inst_t const *p_inst,
+                                     app_usbd_vendor_user_event_t event);
+#endif
+
+#if NRF_MODULE_ENABLED(APP_USBD_HID_GENERIC)
+static void m_hid_user_ev_handler(app_usbd_class_inst_t const *p_inst,
+                                  app_usbd_hid_user_event_t event);
+static void m_hid_flush(void);
+static void m_hid_reset(void);
+#endif
+
+static int m_class_change_request(class_change_t change, app_usbd_class_inst_t const* p_inst);
+
 static void m_usb_init(const app_usbd_config_t* usb_cfg, const app_usbd_cdc_acm_t* cdc_cfg);
 
+#if APP_USB_SOF_TIMESTAMP_ENABLED
+static void m_sof_timestamp_init(void);
+#endif
+
 static void cdc_acm_user_ev_handler(app_usbd_class_inst_t const * p_inst,
                                     app_usbd_cdc_acm_user_event_t event);
 /* Private variables -------------------------------------------------- */
 static char m_tx_buffer[TX_BUFFER];
 static const app_usbd_cdc_acm_t* m_cdc_cfg;
 
+/*! Raw write in flight on CDC ACM, the class takes one transfer at a time */
+static volatile bool m_cdc_tx_busy;
+
 /** @brief CDC_ACM class instance */
 APP_USBD_CDC_ACM_GLOBAL_DEF(m_app_cdc_acm,
                             cdc_acm_user_ev_handler,
@@ -56,9 +117,66 @@ APP_USBD_CDC_ACM_GLOBAL_DEF(m_app_cdc_acm,
                             CDC_ACM_DATA_EPOUT,
                             APP_USBD_CDC_COMM_PROTOCOL_AT_V250);
 
-#define READ_SIZE 1
+static uint8_t m_rx_ring[RX_RING_SIZE];
+
+/*! DWT cycle count when the last OUT transfer event was raised, consumed by its RX_DONE handler */
+static volatile uint32_t m_rx_event_cycles;
+static volatile bool     m_rx_event_pending;
+static app_usb_latency_t m_latency;
+
+/*! Class list change requested from the main loop, applied while USBD is disabled */
+static class_change_t                m_class_change;
+static app_usbd_class_inst_t const*  m_class_change_inst;
+static bool                          m_class_change_stopped;
 
-static char m_rx_buffer[READ_SIZE];
+#if NRF_MODULE_ENABLED(APP_USBD_VENDOR)
+/** @brief Vendor-specific bulk class instance, carries the binary host protocol */
+APP_USBD_VENDOR_GLOBAL_DEF(m_app_vendor,
+                           m_vendor_user_ev_handler,
+                           VENDOR_INTERFACE,
+                           VENDOR_EPIN,
+                           VENDOR_EPOUT);
+
+static uint8_t m_vendor_rx_buffer[APP_USBD_VENDOR_RX_QUEUE_SIZE][RX_BUFFER];
+#endif
+
+#if NRF_MODULE_ENABLED(APP_USBD_HID_GENERIC)
+/** @brief Vendor-defined input report, read with the OS HID driver */
+APP_USBD_HID_GENERIC_SUBCLASS_REPORT_DESC(m_hid_report_desc,
+{
+  0x06, 0x00, 0xFF,                 /* Usage Page (Vendor Defined 0xFF00) */
+  0x09, 0x01,                       /* Usage (0x01) */
+  0xA1, 0x01,                       /* Collection (Application) */
+  0x09, 0x02,                       /*   Usage (0x02) */
+  0x15, 0x00,                       /*   Logical Minimum (0) */
+  0x26, 0xFF, 0x00,                 /*   Logical Maximum (255) */
+  0x75, 0x08,                       /*   Report Size (8) */
+  0x95, APP_USB_HID_REPORT_SIZE,    /*   Report Count */
+  0x81, 0x02,                       /*   Input (Data, Variable, Absolute) */
+  0xC0                              /* End Collection */
+});
+
+static const app_usbd_hid_subclass_desc_t* m_hid_reps[] = { &m_hid_report_desc };
+
+/** @brief HID generic class instance, carries the decoded metrics */
+APP_USBD_HID_GENERIC_GLOBAL_DEF(m_app_hid,
+                                HID_INTERFACE,
+                                m_hid_user_ev_handler,
+                                HID_ENDPOINT_LIST(),
+                                m_hid_reps,
+                                HID_REPORT_IN_QUEUE,
+                                0,
+                                0,
+                                APP_USBD_HID_SUBCLASS_NONE,
+                                APP_USBD_HID_PROTO_GENERIC);
+
+/*! One report is filled by app_usb_metric_write while the other one is being sent */
+static uint8_t m_hid_report[2][APP_USB_HID_REPORT_SIZE];
+static uint8_t m_hid_fill;
+static bool    m_hid_busy;
+
+STATIC_ASSERT(HID_METRIC_CNT <= UINT8_MAX);
+#endif
 
 
 /* Function definitions ----------------------------------------------- */
@@ -67,8 +185,23 @@ int app_usb_init(void)
   // ret_code_t ret;
   static const app_usbd_config_t usbd_config =
   {
-    .ev_state_proc = m_usbd_user_ev_handler
+#if APP_USBD_CONFIG_EVENT_QUEUE_ENABLE
+    .ev_isr_handler = m_usbd_isr_handler,
+#else
+    .ev_handler     = m_usbd_event_handler,
+#endif
+    .ev_state_proc  = m_usbd_user_ev_handler
   };
+
+  /* Cycle counter for the event latency, keeps running while the CPU is awake */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT       = 0;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+#if APP_USB_SOF_TIMESTAMP_ENABLED
+  m_sof_timestamp_init();
+#endif
+
   m_usb_init(&usbd_config, &m_app_cdc_acm);
   // app_usbd_serial_num_generate();
   
@@ -94,6 +227,198 @@ int app_usb_send(const char* data)
   return NRF_SUCCESS;
 }
 
+int app_usb_write(app_usb_port_t port, const void* data, size_t size)
+{
+  int err_code;
+
+  if (port == APP_USB_PORT_VENDOR)
+  {
+#if NRF_MODULE_ENABLED(APP_USBD_VENDOR)
+    return app_usbd_vendor_write(&m_app_vendor, data, size);
+#else
+    return NRF_ERROR_NOT_SUPPORTED;
+#endif
+  }
+
+  /* The transfer may complete in the USBD interrupt before the flag would be set */
+  CRITICAL_REGION_ENTER();
+  err_code = app_usbd_cdc_acm_write(m_cdc_cfg, data, size);
+  if (err_code == NRF_SUCCESS)
+  {
+    m_cdc_tx_busy = true;
+  }
+  CRITICAL_REGION_EXIT();
+
+  return err_code;
+}
+
+void app_usb_latency_get(app_usb_latency_t* p_latency)
+{
+  CRITICAL_REGION_ENTER();
+  *p_latency = m_latency;
+  CRITICAL_REGION_EXIT();
+}
+
+void app_usb_timestamp_get(app_usb_timestamp_t* p_ts)
+{
+#if APP_USB_SOF_TIMESTAMP_ENABLED
+  uint32_t frame;
+  uint32_t us;
+#endif
+
+  if (!nrf_drv_usbd_is_enabled())
+  {
+    p_ts->frame  = 0;
+    p_ts->offset = UINT16_MAX;
+    return;
+  }
+
+#if APP_USB_SOF_TIMESTAMP_ENABLED
+  /* CC[1] is shared by all callers. A SOF between the reads moves the frame counter, then the
+     pair is read again */
+  CRITICAL_REGION_ENTER();
+  do
+  {
+    frame = nrf_usbd_framecntr_get();
+    nrf_timer_task_trigger(APP_USB_TIMESTAMP_TIMER, NRF_TIMER_TASK_CAPTURE1);
+    us = nrf_timer_cc_read(APP_USB_TIMESTAMP_TIMER, NRF_TIMER_CC_CHANNEL1) -
+         nrf_timer_cc_read(APP_USB_TIMESTAMP_TIMER, NRF_TIMER_CC_CHANNEL0);
+  } while (frame != nrf_usbd_framecntr_get());
+  CRITICAL_REGION_EXIT();
+
+  p_ts->frame  = (uint16_t)frame;
+  p_ts->offset = (us > UINT16_MAX) ? UINT16_MAX : (uint16_t)us;
+#else
+  /* The frame counter keeps up without the SOF interrupt, the offset is unknown */
+  p_ts->frame  = (uint16_t)nrf_usbd_framecntr_get();
+  p_ts->offset = UINT16_MAX;
+#endif
+}
+
+int app_usb_metric_write(app_usb_metric_id_t id, uint8_t channel, uint32_t value)
+{
+#if NRF_MODULE_ENABLED(APP_USBD_HID_GENERIC)
+  app_usb_timestamp_t ts;
+  uint8_t* p_report;
+  uint8_t* p_metric;
+  int      err_code = NRF_ERROR_NO_MEM;
+
+  app_usb_timestamp_get(&ts);
+
+  /* Metrics are decoded in the SoftDevice event interrupt, the report is sent from the USB context */
+  CRITICAL_REGION_ENTER();
+  p_report = m_hid_report[m_hid_fill];
+  if (p_report[0] < HID_METRIC_CNT)
+  {
+    p_metric    = &p_report[1 + (p_report[0] * HID_METRIC_SIZE)];
+    p_metric[0] = (uint8_t)id;
+    p_metric[1] = channel;
+    UNUSED_RETURN_VALUE(uint16_encode(ts.frame, &p_metric[2]));
+    UNUSED_RETURN_VALUE(uint32_encode(value, &p_metric[4]));
+    p_report[0]++;
+    err_code = NRF_SUCCESS;
+  }
+  CRITICAL_REGION_EXIT();
+
+  return err_code;
+#else
+  UNUSED_PARAMETER(id);
+  UNUSED_PARAMETER(channel);
+  UNUSED_PARAMETER(value);
+  return NRF_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+int app_usb_class_attach(app_usbd_class_inst_t const* p_inst)
+{
+  return m_class_change_request(CLASS_CHANGE_ATTACH, p_inst);
+}
+
+int app_usb_class_detach(app_usbd_class_inst_t const* p_inst)
+{
+  return m_class_change_request(CLASS_CHANGE_DETACH, p_inst);
+}
+
+bool app_usb_class_change_pending(void)
+{
+  return m_class_change != CLASS_CHANGE_NONE;
+}
+
+void app_usb_process(void)
+{
+  ret_code_t ret;
+
+  if (m_class_change == CLASS_CHANGE_NONE)
+  {
+    return;
+  }
+
+  if (nrf_drv_usbd_is_enabled())
+  {
+    if (!m_class_change_stopped || nrf_drv_usbd_is_started())
+    {
+      /* Let the pending responses go out, USBD is disabled on the STOPPED event */
+      if (!m_class_change_stopped && nrf_drv_usbd_is_started() &&
+          (app_usb_tx_pending(APP_USB_PORT_CDC) == 0) && (app_usb_tx_pending(APP_USB_PORT_VENDOR) == 0))
+      {
+        m_class_change_stopped = true;
+        app_usbd_stop();
+      }
+      return;
+    }
+
+    /* VBUS came back after the stop and POWER_DETECTED enabled USBD again */
+    app_usbd_disable();
+  }
+
+  if (m_class_change == CLASS_CHANGE_ATTACH)
+  {
+    ret = app_usbd_class_append(m_class_change_inst);
+  }
+  else
+  {
+    ret = app_usbd_class_remove(m_class_change_inst);
+  }
+  APP_ERROR_CHECK(ret);
+  m_class_change = CLASS_CHANGE_NONE;
+
+  if (m_class_change_stopped)
+  {
+    m_class_change_stopped = false;
+
+    /* Without VBUS, POWER_DETECTED and POWER_READY restart the device */
+    switch (nrf_drv_power_usbstatus_get())
+    {
+    case NRF_DRV_POWER_USB_STATE_READY:
+      app_usbd_enable();
+      app_usbd_start();
+      break;
+
+    case NRF_DRV_POWER_USB_STATE_CONNECTED:
+      /* POWER_READY is still to come and starts the device */
+      app_usbd_enable();
+      break;
+
+    default:
+      break;
+    }
+  }
+}
+
+size_t app_usb_tx_pending(app_usb_port_t port)
+{
+  if (port == APP_USB_PORT_VENDOR)
+  {
+#if NRF_MODULE_ENABLED(APP_USBD_VENDOR)
+    return app_usbd_vendor_tx_pending(&m_app_vendor);
+#else
+    return 0;
+#endif
+  }
+
+  return m_cdc_tx_busy ? 1 : 0;
+}
+
 /* Private function definitions --------------------------------------- */
 /** @brief User event handler @ref app_usbd_m_cdc_acm_user_ev_handler_t */
 static void m_cdc_acm_user_ev_handler(app_usbd_class_inst_t const *p_inst,
@@ -139,34 +464,38 @@ static void cdc_acm_user_ev_handler(app_usbd_class_inst_t const * p_inst,
         {
             // bsp_board_led_on(LED_CDC_ACM_OPEN);
 
-            /*Setup first transfer*/
-            ret_code_t ret = app_usbd_cdc_acm_read(&m_app_cdc_acm,
-                                                   m_rx_buffer,
-                                                   READ_SIZE);
+            /*Start receiving into the ring*/
+            ret_code_t ret = app_usbd_cdc_acm_rx_stream_start(p_cdc_acm,
+                                                              m_rx_ring,
+                                                              sizeof(m_rx_ring));
             UNUSED_VARIABLE(ret);
             break;
         }
         case APP_USBD_CDC_ACM_USER_EVT_PORT_CLOSE:
             // bsp_board_led_off(LED_CDC_ACM_OPEN);
+            /* The transfer in flight is aborted without TX_DONE */
+            m_cdc_tx_busy = false;
             break;
         case APP_USBD_CDC_ACM_USER_EVT_TX_DONE:
             // bsp_board_led_invert(LED_CDC_ACM_TX);
+            m_cdc_tx_busy = false;
+            break;
+        case APP_USBD_CDC_ACM_USER_EVT_MEMOBJ_TX_DONE:
+            /* Log backend transfer, m_cdc_tx_busy tracks only app writes */
             break;
         case APP_USBD_CDC_ACM_USER_EVT_RX_DONE:
         {
-            ret_code_t ret;
-            NRF_LOG_INFO("Bytes waiting: %d", app_usbd_cdc_acm_bytes_stored(p_cdc_acm));
-            do
-            {
-                /*Get amount of data transfered*/
-                size_t size = app_usbd_cdc_acm_rx_size(p_cdc_acm);
-                NRF_LOG_INFO("RX: size: %lu char: %c", size, m_rx_buffer[0]);
+            uint8_t const * p_data;
+            size_t size;
+
+            m_latency_stop();
 
-                /* Fetch data until internal buffer is empty */
-                ret = app_usbd_cdc_acm_read(&m_app_cdc_acm,
-                                            m_rx_buffer,
-                                            READ_SIZE);
-            } while (ret == NRF_SUCCESS);
+            /* Parse in place, the span wraps at most once */
+            while ((size = app_usbd_cdc_acm_rx_stream_get(p_cdc_acm, &p_data)) != 0)
+            {
+                app_cmd_rx(APP_USB_PORT_CDC, p_data, size);
+                UNUSED_RETURN_VALUE(app_usbd_cdc_acm_rx_stream_free(p_cdc_acm, size));
+            }
 
             // bsp_board_led_invert(LED_CDC_ACM_RX);
             break;
@@ -176,10 +505,206 @@ static void cdc_acm_user_ev_handler(app_usbd_class_inst_t const * p_inst,
     }
 }
 
+#if NRF_MODULE_ENABLED(APP_USBD_VENDOR)
+static void m_vendor_user_ev_handler(app_usbd_class_inst_t const *p_inst,
+                                     app_usbd_vendor_user_event_t event)
+{
+  app_usbd_vendor_t const *p_vendor = app_usbd_vendor_class_get(p_inst);
+
+  switch (event)
+  {
+  case APP_USBD_VENDOR_USER_EVT_RESET:
+    /* Queues are flushed, queue all the RX buffers again */
+    for (uint8_t i = 0; i < APP_USBD_VENDOR_RX_QUEUE_SIZE; i++)
+    {
+      UNUSED_RETURN_VALUE(app_usbd_vendor_read(p_vendor, m_vendor_rx_buffer[i], RX_BUFFER));
+    }
+    break;
+
+  case APP_USBD_VENDOR_USER_EVT_RX_DONE:
+  {
+    uint8_t* p_done = app_usbd_vendor_rx_buffer_get(p_vendor);
+
+    m_latency_stop();
+
+    /* The next buffer is already armed, give this one back after parsing */
+    app_cmd_rx(APP_USB_PORT_VENDOR, p_done, app_usbd_vendor_rx_size(p_vendor));
+    UNUSED_RETURN_VALUE(app_usbd_vendor_read(p_vendor, p_done, RX_BUFFER));
+    break;
+  }
+
+  default:
+    break;
+  }
+}
+#endif
+
+#if NRF_MODULE_ENABLED(APP_USBD_HID_GENERIC)
+static void m_hid_user_ev_handler(app_usbd_class_inst_t const *p_inst,
+                                  app_usbd_hid_user_event_t event)
+{
+  switch (event)
+  {
+  case APP_USBD_HID_USER_EVT_IN_REPORT_DONE:
+    m_hid_busy = false;
+    break;
+
+  default:
+    break;
+  }
+}
+
+/** @brief Send the metrics collected during the last frame, called on SOF */
+static void m_hid_flush(void)
+{
+  uint8_t* p_report;
+
+  if (m_hid_busy || (app_usbd_core_state_get() != APP_USBD_STATE_Configured))
+  {
+    return;
+  }
+
+  CRITICAL_REGION_ENTER();
+  p_report = m_hid_report[m_hid_fill];
+  if (p_report[0] != 0)
+  {
+    m_hid_fill ^= 1;
+    memset(m_hid_report[m_hid_fill], 0, APP_USB_HID_REPORT_SIZE);
+  }
+  CRITICAL_REGION_EXIT();
+
+  if (p_report[0] == 0)
+  {
+    return;
+  }
+
+  m_hid_busy = true;
+  if (app_usbd_hid_generic_in_report_set(&m_app_hid, p_report, APP_USB_HID_REPORT_SIZE) != NRF_SUCCESS)
+  {
+    /* Do not leave the report queued in the class, the metrics are dropped */
+    m_hid_reset();
+  }
+}
+
+/** @brief Drop the report in flight, transfers are aborted on bus reset */
+static void m_hid_reset(void)
+{
+  UNUSED_RETURN_VALUE(hid_generic_clear_buffer(app_usbd_hid_generic_class_inst_get(&m_app_hid)));
+  m_hid_busy = false;
+}
+#endif
+
+#if APP_USBD_CONFIG_EVENT_QUEUE_ENABLE
+/** @brief Called from the USBD interrupt when an event is put into the queue */
+static void m_usbd_isr_handler(app_usbd_internal_evt_t const * const p_event, bool queued)
+{
+  m_latency_start(p_event);
+}
+#else
+/** @brief Called from the USBD interrupt, events are executed there */
+static void m_usbd_event_handler(app_usbd_internal_evt_t const * const p_event)
+{
+  m_latency_start(p_event);
+  app_usbd_event_execute(p_event);
+}
+#endif
+
+static void m_latency_start(app_usbd_internal_evt_t const * const p_event)
+{
+  nrf_drv_usbd_ep_t ep;
+
+  if (p_event->type != APP_USBD_EVT_DRV_EPTRANSFER)
+  {
+    return;
+  }
+
+  /* Only the command endpoints end in m_latency_stop, mass storage OUT transfers would leave
+     a sample pending until the next command */
+  ep = p_event->drv_evt.data.eptransfer.ep;
+  if (((ep == CDC_ACM_DATA_EPOUT) || (ep == VENDOR_EPOUT)) &&
+      (p_event->drv_evt.data.eptransfer.status == NRF_USBD_EP_OK))
+  {
+    m_rx_event_cycles  = DWT->CYCCNT;
+    m_rx_event_pending = true;
+  }
+}
+
+static void m_latency_stop(void)
+{
+  uint32_t cycles;
+
+  if (!m_rx_event_pending)
+  {
+    return;
+  }
+  cycles             = DWT->CYCCNT - m_rx_event_cycles;
+  m_rx_event_pending = false;
+
+  m_latency.samples++;
+  m_latency.last   = cycles;
+  m_latency.total += cycles;
+  if (cycles > m_latency.max)
+  {
+    m_latency.max = cycles;
+  }
+}
+
+#if APP_USB_SOF_TIMESTAMP_ENABLED
+/**
+ * @brief Capture APP_USB_TIMESTAMP_TIMER into CC[0] on every SOF through PPI
+ *
+ * @details EVENTS_SOF is set whether or not the SOF interrupt is enabled, the capture does not
+ *          need the CPU. The timer runs between APP_USBD_EVT_STARTED and APP_USBD_EVT_STOPPED.
+ */
+static void m_sof_timestamp_init(void)
+{
+  nrf_ppi_channel_t channel;
+  ret_code_t        ret;
+
+  nrf_timer_mode_set(APP_USB_TIMESTAMP_TIMER, NRF_TIMER_MODE_TIMER);
+  nrf_timer_bit_width_set(APP_USB_TIMESTAMP_TIMER, NRF_TIMER_BIT_WIDTH_32);
+  nrf_timer_frequency_set(APP_USB_TIMESTAMP_TIMER, NRF_TIMER_FREQ_1MHz);
+
+  ret = nrf_drv_ppi_init();
+  if (ret != NRF_ERROR_MODULE_ALREADY_INITIALIZED)
+  {
+    APP_ERROR_CHECK(ret);
+  }
+
+  /* The allocator skips the channels reserved by the SoftDevice */
+  ret = nrf_drv_ppi_channel_alloc(&channel);
+  APP_ERROR_CHECK(ret);
+
+  ret = nrf_drv_ppi_channel_assign(channel,
+                                   nrf_usbd_event_address_get(NRF_USBD_EVENT_SOF),
+                                   (uint32_t)nrf_timer_task_address_get(APP_USB_TIMESTAMP_TIMER,
+                                                                        NRF_TIMER_TASK_CAPTURE0));
+  APP_ERROR_CHECK(ret);
+
+  ret = nrf_drv_ppi_channel_enable(channel);
+  APP_ERROR_CHECK(ret);
+}
+#endif
+
 static void m_usbd_user_ev_handler(app_usbd_event_type_t event)
 {
   switch (event)
   {
+#if NRF_MODULE_ENABLED(APP_USBD_HID_GENERIC)
+  case APP_USBD_EVT_DRV_SOF:
+    m_hid_flush();
+    break;
+
+  case APP_USBD_EVT_DRV_RESET:
+    m_hid_reset();
+    m_cdc_tx_busy = false;
+    break;
+#else
+  case APP_USBD_EVT_DRV_RESET:
+    m_cdc_tx_busy = false;
+    break;
+#endif
+
   case APP_USBD_EVT_DRV_SUSPEND:
     NRF_LOG_INFO("APP_USBD_EVT_DRV_SUSPEND");
     break;
@@ -190,11 +715,19 @@ static void m_usbd_user_ev_handler(app_usbd_event_type_t event)
 
   case APP_USBD_EVT_STARTED:
     NRF_LOG_INFO("APP_USBD_EVT_STARTED");
+#if APP_USB_SOF_TIMESTAMP_ENABLED
+    nrf_timer_task_trigger(APP_USB_TIMESTAMP_TIMER, NRF_TIMER_TASK_START);
+#endif
     app_ant_init();
     break;
 
   case APP_USBD_EVT_STOPPED:
     NRF_LOG_INFO("APP_USBD_EVT_STOPPED");
+#if APP_USB_SOF_TIMESTAMP_ENABLED
+    /* A running timer keeps the high-frequency clock requested */
+    nrf_timer_task_trigger(APP_USB_TIMESTAMP_TIMER, NRF_TIMER_TASK_STOP);
+#endif
+    m_cdc_tx_busy = false;
     app_usbd_disable();
     break;
 
@@ -232,6 +765,18 @@ static void m_usbd_user_ev_handler(app_usbd_event_type_t event)
   }
 }
 
+static int m_class_change_request(class_change_t change, app_usbd_class_inst_t const* p_inst)
+{
+  if (m_class_change != CLASS_CHANGE_NONE)
+  {
+    return NRF_ERROR_BUSY;
+  }
+
+  m_class_change_inst = p_inst;
+  m_class_change      = change;
+  return NRF_SUCCESS;
+}
+
 static void m_usb_init(const app_usbd_config_t* usb_cfg, const app_usbd_cdc_acm_t* cdc_cfg)
 {
   ret_code_t ret;
@@ -245,6 +790,18 @@ static void m_usb_init(const app_usbd_config_t* usb_cfg, const app_usbd_cdc_acm_
   ret = app_usbd_class_append(class_cdc_acm);
   APP_ERROR_CHECK(ret);
 
+#if NRF_MODULE_ENABLED(APP_USBD_VENDOR)
+  app_usbd_class_inst_t const * class_vendor = app_usbd_vendor_class_inst_get(&m_app_vendor);
+  ret = app_usbd_class_append(class_vendor);
+  APP_ERROR_CHECK(ret);
+#endif
+
+#if NRF_MODULE_ENABLED(APP_USBD_HID_GENERIC)
+  app_usbd_class_inst_t const * class_hid = app_usbd_hid_generic_class_inst_get(&m_app_hid);
+  ret = app_usbd_class_append(class_hid);
+  APP_ERROR_CHECK(ret);
+#endif
+
   ret = app_usbd_power_events_enable();
   APP_ERROR_CHECK(ret);
 }
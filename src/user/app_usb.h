@@ -16,14 +16,186 @@
 /* Includes ----------------------------------------------------------- */
 #include "app_usbd.h"
 #include "app_usbd_cdc_acm.h"
+#include "app_usbd_vendor.h"
+#include "app_usbd_hid_generic.h"
 
 /* Public defines ----------------------------------------------------- */
+#define APP_USB_SOF_TIMESTAMP_ENABLED  (1)         /**< Capture SOF with PPI for the offset of app_usb_timestamp_get */
+#define APP_USB_TIMESTAMP_TIMER        NRF_TIMER2  /**< Free-running 1 MHz timer, CC[0] holds the time of the last SOF */
+#define APP_USB_HID_REPORT_SIZE        NRF_DRV_USBD_EPSIZE  /**< Size of the HID input report */
+
+/*! Interfaces and endpoints after CDC ACM (interfaces 0 and 1, endpoints 1 and 2) are taken in
+    this order by the classes that are enabled: vendor, HID, mass storage (app_capture.c) */
+#if NRF_MODULE_ENABLED(APP_USBD_VENDOR)
+#define APP_USB_VENDOR_CNT             (1)
+#else
+#define APP_USB_VENDOR_CNT             (0)
+#endif
+#if NRF_MODULE_ENABLED(APP_USBD_HID_GENERIC)
+#define APP_USB_HID_CNT                (1)
+#else
+#define APP_USB_HID_CNT                (0)
+#endif
+#define APP_USB_VENDOR_INTERFACE       (2)  /**< Vendor interface, bulk IN and OUT endpoints */
+#define APP_USB_VENDOR_EP              (3)
+#define APP_USB_HID_INTERFACE          (APP_USB_VENDOR_INTERFACE + APP_USB_VENDOR_CNT)  /**< HID interface, interrupt IN endpoint */
+#define APP_USB_HID_EP                 (APP_USB_VENDOR_EP + APP_USB_VENDOR_CNT)
+#define APP_USB_MSC_INTERFACE          (APP_USB_HID_INTERFACE + APP_USB_HID_CNT)  /**< Mass storage interface, bulk IN and OUT endpoints */
+#define APP_USB_MSC_EP                 (APP_USB_HID_EP + APP_USB_HID_CNT)
 /* Public macros ------------------------------------------------------ */
 /* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Interfaces carrying raw data to and from the host
+ */
+typedef enum
+{
+  APP_USB_PORT_CDC,     /**< CDC ACM, shared with the text output of app_usb_send */
+  APP_USB_PORT_VENDOR,  /**< Vendor-specific bulk interface, needs APP_USBD_VENDOR_ENABLED */
+  APP_USB_PORT_CNT
+}
+app_usb_port_t;
+
+/*! Interface for raw data not sent in reply to the host, the vendor interface when available */
+#if NRF_MODULE_ENABLED(APP_USBD_VENDOR)
+#define APP_USB_PORT_DEFAULT  APP_USB_PORT_VENDOR
+#else
+#define APP_USB_PORT_DEFAULT  APP_USB_PORT_CDC
+#endif
+
+/**
+ * @brief Latency from the USBD interrupt of an OUT transfer to its RX_DONE handler, in CPU cycles
+ *
+ * @details With APP_USBD_CONFIG_EVENT_QUEUE_ENABLE the handler runs when the main loop takes
+ *          the event from the queue, otherwise it runs in the USBD interrupt.
+ */
+typedef struct
+{
+  uint32_t samples;  /**< Number of measured transfers */
+  uint32_t last;     /**< Latency of the last transfer */
+  uint32_t max;      /**< Highest latency */
+  uint64_t total;    /**< Sum of all the latencies */
+}
+app_usb_latency_t;
+
+/**
+ * @brief Metrics sent in the HID input reports
+ */
+typedef enum
+{
+  APP_USB_METRIC_HEART_RATE = 0x01, /**< Computed heart rate [bpm] */
+  APP_USB_METRIC_POWER      = 0x02, /**< Instantaneous power [W] */
+  APP_USB_METRIC_SPEED      = 0x03, /**< Computed speed [kph] */
+  APP_USB_METRIC_CADENCE    = 0x04  /**< Computed cadence [rpm] */
+}
+app_usb_metric_id_t;
+
+/**
+ * @brief Time on the USB frame clock, shared by all the devices on the bus
+ */
+typedef struct
+{
+  uint16_t frame;   /**< Frame number of the last SOF, 0..2047 */
+  uint16_t offset;  /**< Time since that SOF in us, saturated at 0xFFFF */
+}
+app_usb_timestamp_t;
+
 /* Public variables --------------------------------------------------- */
 /* Public function prototypes ----------------------------------------- */
 int app_usb_init(void);
 int app_usb_send(const char* data);
 
+/**
+ * @brief Send raw data to the host
+ *
+ * @details CDC ACM takes one transfer at a time, also used by the text output of
+ *          app_usb_send, and returns NRF_ERROR_BUSY while it is sending.
+ *
+ * @param[in] port  Interface to send on
+ * @param[in] data  Data, must stay valid until the transfer is done
+ * @param[in] size  Number of bytes to send
+ *
+ * @return NRF_SUCCESS, the error code of app_usbd_vendor_write / app_usbd_cdc_acm_write or
+ *         NRF_ERROR_NOT_SUPPORTED if the interface is not built in
+ */
+int app_usb_write(app_usb_port_t port, const void* data, size_t size);
+
+/**
+ * @brief Get the number of raw writes queued and not sent yet
+ *
+ * The buffers of these writes are still in use. CDC ACM takes one write at a time.
+ *
+ * @param[in] port  Interface
+ *
+ * @return Number of pending writes
+ */
+size_t app_usb_tx_pending(app_usb_port_t port);
+
+/**
+ * @brief Get the USB event latency statistics
+ *
+ * @param[out] p_latency  Statistics
+ */
+void app_usb_latency_get(app_usb_latency_t* p_latency);
+
+/**
+ * @brief Get the current time on the USB frame clock
+ *
+ * @details The frame number is read from the USBD frame counter. With APP_USB_SOF_TIMESTAMP_ENABLED
+ *          the USBD SOF event captures APP_USB_TIMESTAMP_TIMER through PPI, without an interrupt,
+ *          and the offset is the time since that capture. Otherwise the offset is UINT16_MAX.
+ *          The host aligns streams from several devices on the same bus by the frame number.
+ *
+ * @param[out] p_ts  Timestamp, the offset keeps growing while no SOF is received
+ */
+void app_usb_timestamp_get(app_usb_timestamp_t* p_ts);
+
+/**
+ * @brief Add a decoded metric to the next HID input report
+ *
+ * @details The report is a count byte followed by records of metric ID, channel, USB frame
+ *          (LE16) and value (LE32). Metrics added within one USB frame are sent together in
+ *          one report on the next SOF, the interrupt endpoint is polled every 1 ms.
+ *
+ * @param[in] id       Metric ID
+ * @param[in] channel  ANT channel the metric was decoded from
+ * @param[in] value    Metric value
+ *
+ * @return NRF_SUCCESS, NRF_ERROR_NO_MEM if the report is full or NRF_ERROR_NOT_SUPPORTED if
+ *         the HID interface is disabled
+ */
+int app_usb_metric_write(app_usb_metric_id_t id, uint8_t channel, uint32_t value);
+
+/**
+ * @brief Re-enumerate with a class instance added at the end of the device
+ *
+ * @details The device is stopped once the pending writes are sent, the class list is changed
+ *          while USBD is disabled and the device is started again by @ref app_usb_process
+ *          if VBUS is still there, otherwise by the power events once it comes back.
+ *
+ * @param[in] p_inst  Class instance, its interface numbers must follow the ones in use
+ *
+ * @return NRF_SUCCESS or NRF_ERROR_BUSY if a change is already pending
+ */
+int app_usb_class_attach(app_usbd_class_inst_t const* p_inst);
+
+/**
+ * @brief Re-enumerate with a class instance removed from the device
+ *
+ * @param[in] p_inst  Class instance added by @ref app_usb_class_attach
+ *
+ * @return NRF_SUCCESS or NRF_ERROR_BUSY if a change is already pending
+ */
+int app_usb_class_detach(app_usbd_class_inst_t const* p_inst);
+
+/**
+ * @brief Check whether a class list change is still in progress
+ */
+bool app_usb_class_change_pending(void);
+
+/**
+ * @brief Apply the pending class list change, called from the main loop
+ */
+void app_usb_process(void);
+
 #endif // __APP_USB_H
 /* End of file -------------------------------------------------------- */
@@ -68,6 +68,7 @@
 #include "nrf_gpio.h"
 #include "nrf_delay.h"
 #include "nrf_drv_power.h"
+#include "nrf_pwr_mgmt.h"
 
 #include "app_error.h"
 #include "app_util.h"
@@ -83,6 +84,8 @@
 
 #include "app_usb.h"
 #include "app_ant.h"
+#include "app_cmd.h"
+#include "app_capture.h"
 
 /** @brief Application main function. */
 int main(void)
@@ -98,23 +101,36 @@ int main(void)
   ret = nrf_drv_clock_init();
   APP_ERROR_CHECK(ret);
 
+  ret = nrf_pwr_mgmt_init();
+  APP_ERROR_CHECK(ret);
+
   NRF_LOG_INFO("USBD ANT+ started.");
 
   app_usb_init();
 
+  ret = app_capture_init();
+  APP_ERROR_CHECK(ret);
+
   // Enter main loop.
+  // USB (in queue mode), ANT and log producers all run in interrupts, which wake the CPU
+  // from nrf_pwr_mgmt_run. Sleep only when every consumer below is idle.
   for (;;)
   {
+#if APP_USBD_CONFIG_EVENT_QUEUE_ENABLE
     while (app_usbd_event_queue_process())
     {
       /* Nothing to do */
     }
+#endif
 
-    //app_usb_send("thuanle");
+    app_cmd_process();
+    app_ant_process();
+    app_usb_process();
+    app_capture_process();
 
-    //nrf_delay_ms(1000);
-
-    NRF_LOG_FLUSH();
+    if (NRF_LOG_PROCESS() == false)
+    {
+      nrf_pwr_mgmt_run();
+    }
   }
 }
-